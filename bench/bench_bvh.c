@@ -0,0 +1,249 @@
+/* ------------------------------------------------------------------------
+ *
+ * bench_bvh.c
+ * description: build time and traversal cost of the bounding volume hierarchy builders over
+ * 1M primitives (or the count passed as the first argument). build with optimizations and
+ * the SIMD flags being measured, e.g.:
+ *
+ *     cc -std=c99 -O2 -mavx2 -mfma bench/bench_bvh.c -o bench_bvh -lm -lpthread
+ *
+ * ------------------------------------------------------------------------
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../quickmath.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RUNS 3
+#define THREADS 8
+#define FRAMES 64
+#define RAYS 100000
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static float rand_float(float scale)
+{
+	return ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f) * scale;
+}
+
+//----------------------------------------------------------------------//
+//TRAVERSAL:
+
+//closest hit against the primitive boxes, counting the nodes and primitives tested
+
+static float trace(const QMbvhNode* nodes, const QMbbox3* prims, const uint32_t* primIndices, QMray r,
+                   uint64_t* nodeTests, uint64_t* primTests)
+{
+	uint32_t stack[QM_BVH_MAX_DEPTH];
+	int stackSize = 0;
+
+	float closest = INFINITY;
+	uint32_t node = 0;
+
+	for(;;)
+	{
+		const QMbvhNode* n = &nodes[node];
+		float tNear, tFar;
+
+		(*nodeTests)++;
+		if(QM_FUNC_PREFIX(ray_intersect_bbox3)(r, n->bounds, closest, &tNear, &tFar))
+		{
+			if(n->count > 0)
+			{
+				for(uint32_t i = n->leftFirst; i < n->leftFirst + n->count; i++)
+				{
+					(*primTests)++;
+					if(QM_FUNC_PREFIX(ray_intersect_bbox3)(r, prims[primIndices[i]], closest, &tNear, &tFar))
+						closest = tNear;
+				}
+			}
+			else
+			{
+				stack[stackSize++] = n->leftFirst + 1;
+				node = n->leftFirst;
+				continue;
+			}
+		}
+
+		if(stackSize == 0)
+			break;
+
+		node = stack[--stackSize];
+	}
+
+	return closest;
+}
+
+static void bench_traversal(const QMbvhNode* nodes, uint32_t nodeCount, const QMbbox3* prims, const uint32_t* primIndices)
+{
+	//frustum culling from a camera turning in the middle of the scene
+	uint32_t* leaves = (uint32_t*)malloc(nodeCount * sizeof(uint32_t));
+	uint8_t* planeCache = (uint8_t*)calloc(nodeCount, 1);
+
+	size_t visible = 0;
+	double start = now();
+	for(int frame = 0; frame < FRAMES; frame++)
+	{
+		float angle = (float)frame / FRAMES * 6.2831853f;
+		QMvec3 pos = {{ 0.0f, 0.0f, 0.0f }};
+		QMvec3 target = {{ cosf(angle), 0.2f, sinf(angle) }};
+		QMmat4 view = qm_mat4_lookat(pos, target, (QMvec3){{ 0.0f, 1.0f, 0.0f }});
+		QMfrustum f = qm_frustum_from_mat4(qm_mat4_mult(qm_mat4_perspective(60.0f, 16.0f / 9.0f, 0.1f, 300.0f), view));
+
+		visible += qm_frustum_cull_bvh(f, nodes, planeCache, leaves);
+	}
+
+	double cullTime = (now() - start) / FRAMES;
+	printf("  frustum cull: %8.3f ms/frame, %zu leaves visible per frame\n", cullTime * 1e3, visible / FRAMES);
+
+	free(leaves);
+	free(planeCache);
+
+	//rays from random points in the scene in random directions, the same ones for every tree
+	QMray* rays = (QMray*)malloc(RAYS * sizeof(QMray));
+	srand(1);
+	for(int i = 0; i < RAYS; i++)
+		rays[i] = qm_ray_create((QMvec3){{ rand_float(100.0f), rand_float(100.0f), rand_float(100.0f) }},
+		                        qm_vec3_normalize((QMvec3){{ rand_float(1.0f), rand_float(1.0f), rand_float(1.0f) }}));
+
+	uint64_t nodeTests = 0, primTests = 0;
+	int hits = 0;
+
+	start = now();
+	for(int i = 0; i < RAYS; i++)
+		hits += trace(nodes, prims, primIndices, rays[i], &nodeTests, &primTests) < INFINITY;
+
+	double rayTime = (now() - start) / RAYS;
+	printf("  closest hit:  %8.3f us/ray, %.1f node and %.1f primitive tests per ray, %d%% hit\n",
+	       rayTime * 1e6, (double)nodeTests / RAYS, (double)primTests / RAYS, hits * 100 / RAYS);
+
+	free(rays);
+}
+
+//----------------------------------------------------------------------//
+//BUILDING:
+
+//a minimal QMparallelForFunc, each thread takes the next index until none are left
+
+typedef struct
+{
+	QMtaskFunc task;
+	void* data;
+	uint32_t count;
+	uint32_t next;
+	pthread_mutex_t lock;
+} Job;
+
+static void* worker(void* arg)
+{
+	Job* job = (Job*)arg;
+	for(;;)
+	{
+		pthread_mutex_lock(&job->lock);
+		uint32_t index = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if(index >= job->count)
+			break;
+
+		job->task(job->data, index);
+	}
+
+	return NULL;
+}
+
+static void parallel_for(void* user, QMtaskFunc task, void* data, uint32_t count)
+{
+	(void)user;
+
+	Job job = { task, data, count, 0 };
+	pthread_mutex_init(&job.lock, NULL);
+
+	pthread_t threads[THREADS];
+	for(int i = 0; i < THREADS; i++)
+		pthread_create(&threads[i], NULL, worker, &job);
+	for(int i = 0; i < THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&job.lock);
+}
+
+static QMbvhParallelState parallelState;
+
+int main(int argc, char** argv)
+{
+	uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000000;
+	if(count == 0)
+		return 1;
+
+	//small boxes scattered through a cube, like the triangles of a large scene
+	QMbbox3* prims = (QMbbox3*)malloc(count * sizeof(QMbbox3));
+	for(uint32_t i = 0; i < count; i++)
+	{
+		QMvec3 center = {{ rand_float(100.0f), rand_float(100.0f), rand_float(100.0f) }};
+		QMvec3 extent = {{ 0.05f + fabsf(rand_float(0.5f)), 0.05f + fabsf(rand_float(0.5f)), 0.05f + fabsf(rand_float(0.5f)) }};
+
+		prims[i].min = qm_vec3_sub(center, extent);
+		prims[i].max = qm_vec3_add(center, extent);
+	}
+
+	QMbvhNode* nodes = (QMbvhNode*)malloc((2 * (size_t)count - 1) * sizeof(QMbvhNode));
+	uint32_t* primIndices = (uint32_t*)malloc(count * sizeof(uint32_t));
+
+	printf("%u primitives, %s\n", count, qm_simd_tier_name(qm_simd_tier()));
+
+	double best = INFINITY;
+	uint32_t nodeCount = 0;
+	for(int run = 0; run < RUNS; run++)
+	{
+		double start = now();
+		nodeCount = qm_bvh_build(prims, count, nodes, primIndices);
+		best = QM_MIN(best, now() - start);
+	}
+
+	printf("binned SAH:     %8.1f ms, %u nodes, SAH cost %.2f\n", best * 1e3, nodeCount, qm_bvh_sah_cost(nodes));
+	bench_traversal(nodes, nodeCount, prims, primIndices);
+
+	//identical tree, so only the build time is reported
+	best = INFINITY;
+	for(int run = 0; run < RUNS; run++)
+	{
+		double start = now();
+		nodeCount = qm_bvh_build_parallel(prims, count, nodes, primIndices, &parallelState, parallel_for, NULL);
+		best = QM_MIN(best, now() - start);
+	}
+
+	printf("parallel SAH:   %8.1f ms on %d threads\n", best * 1e3, THREADS);
+
+	uint32_t* scratch = (uint32_t*)malloc(3 * (size_t)count * sizeof(uint32_t));
+
+	best = INFINITY;
+	for(int run = 0; run < RUNS; run++)
+	{
+		double start = now();
+		nodeCount = qm_bvh_build_lbvh(prims, count, nodes, primIndices, scratch);
+		best = QM_MIN(best, now() - start);
+	}
+
+	printf("LBVH:           %8.1f ms, %u nodes, SAH cost %.2f\n", best * 1e3, nodeCount, qm_bvh_sah_cost(nodes));
+	bench_traversal(nodes, nodeCount, prims, primIndices);
+
+	free(scratch);
+
+	free(prims);
+	free(nodes);
+	free(primIndices);
+
+	return 0;
+}
@@ -20,15 +20,46 @@
  * "#define QM_TANF(x) my_tanf(x)", and "#define QM_ACOSF(x) my_acosf(x)" before 
  * including the library
  * 
+ * to use the polynomial qm_vecw_sin, qm_vecw_cos, qm_vecw_tan, and qm_vecw_acos approximations instead of
+ * QM_SINF, QM_COSF, QM_TANF, and QM_ACOSF in the rotation, projection, and quaternion functions, you must
+ * "#define QM_FAST_TRIG" before including the library. their max error is documented above their definitions
+ * 
+ * to select the SIMD path of the batch (array) functions at runtime instead of at compile time, you
+ * must "#define QM_RUNTIME_DISPATCH" before including the library. cpuid is probed on first use (or
+ * when qm_dispatch_init() is called) and the best supported kernels are bound to a function table.
+ * only available on x86-64 with GCC, Clang, clang-cl, or MSVC. the kernels above SSE2 are compiled with
+ * target attributes on GCC and Clang, MSVC allows them without any /arch flag. since every function is
+ * static, each translation unit has its own table
+ * 
+ * the half-precision (QMhalf) functions use the F16C instructions when compiled with AVX and F16C
+ * support (-mavx -mf16c), and a software conversion that gives the same results otherwise
+ * 
  * ------------------------------------------------------------------------
  * 
  * the following functions are defined:
  * (QMvecn means a vector of dimension, 2, 3, or 4, named QMvec2, QMvec3, and QMvec4)
  * (QMmatn means a matrix of dimensions 3x3 or 4x4, named QMmat3 and QMmat4)
  * (QMbboxn means a bounding box of dimensions 2 or 3)
+ * (QMvec3xn means 4 or 8 3-dimensional vectors stored as x, y, and z lanes, named QMvec3x4 and QMvec3x8)
+ * (QMvecn_lanes means the per-lane results of a QMvec3xn, QMvec4 for QMvec3x4 and QMvec8 for QMvec3x8)
+ * (QMbbox3xn, QMrayxn, and QMtrianglexn mean 4 or 8 boxes, rays, or triangles stored as lanes, named like QMvec3xn)
+ * (QMvecw means 4 or 8 floats evaluated at once, named QMvec4 and QMvec8)
+ * 
+ * QMhalf       qm_float_to_half              (float f);
+ * float        qm_half_to_float              (QMhalf h);
+ * void         qm_float_to_half_array        (const float* in, QMhalf* out, size_t count);
+ * void         qm_half_to_float_array        (const QMhalf* in, float* out, size_t count);
+ * 
+ * QMvecw       qm_vecw_sin                   (QMvecw v);
+ * QMvecw       qm_vecw_cos                   (QMvecw v);
+ * void         qm_vecw_sincos                (QMvecw v, QMvecw* s, QMvecw* c);
+ * QMvecw       qm_vecw_tan                   (QMvecw v);
+ * QMvecw       qm_vecw_acos                  (QMvecw v);
  * 
  * QMvecn       qm_vecn_load                  (const float* in);
  * void         qm_vecn_store                 (QMvecn v, float* out);
+ * QMvecn       qm_vecn_load_half             (const QMhalf* in);
+ * void         qm_vecn_store_half            (QMvecn v, QMhalf* out);
  * QMvecn       qm_vecn_full                  (float val);
  * QMvecn       qm_vecn_add                   (QMvecn v1, QMvecn v2);
  * QMvecn       qm_vecn_sub                   (QMvecn v1, QMvecn v2);
@@ -37,6 +68,7 @@
  * QMvecn       qm_vecn_scale                 (QMvecn v , float  s );
  * QMvecn       qm_vecn_dot                   (QMvecn v1, QMvecn v2);
  * QMvec3       qm_vec3_cross                 (QMvec3 v1, QMvec3 v2);
+ * void         qm_vec4_dot_array             (const QMvec4* v1, const QMvec4* v2, float* out, size_t count);
  * float        qm_vecn_length                (QMvecn v);
  * QMvecn       qm_vecn_normalize             (QMvecn v);
  * float        qm_vecn_distance              (QMvecn v1, QMvecn v2);
@@ -44,18 +76,43 @@
  * QMvecn       qm_vecn_min                   (QMvecn v1, QMvecn v2);
  * QMvecn       qm_vecn_max                   (QMvecn v1, QMvecn v2);
  * 
+ * QMvec3xn     qm_vec3xn_load                (const QMvec3* in);
+ * void         qm_vec3xn_store               (QMvec3xn v, QMvec3* out);
+ * QMvec3xn     qm_vec3xn_full                (QMvec3 v);
+ * QMvec3xn     qm_vec3xn_add                 (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_sub                 (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_mult                (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_div                 (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_scale               (QMvec3xn v , float    s );
+ * QMvecn_lanes qm_vec3xn_dot                 (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_cross               (QMvec3xn v1, QMvec3xn v2);
+ * QMvecn_lanes qm_vec3xn_length              (QMvec3xn v);
+ * QMvec3xn     qm_vec3xn_normalize           (QMvec3xn v);
+ * QMvecn_lanes qm_vec3xn_distance            (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_min                 (QMvec3xn v1, QMvec3xn v2);
+ * QMvec3xn     qm_vec3xn_max                 (QMvec3xn v1, QMvec3xn v2);
+ * 
  * QMmatn       qm_matn_load                  (const float* in);
  * QMmatn       qm_matn_load_row_major        (const float* in);
  * void         qm_matn_store                 (QMmatn m, float* out);
  * void         qm_matn_store_row_major       (QMmatn m, float* out);
+ * QMmatn       qm_matn_load_half             (const QMhalf* in);
+ * void         qm_matn_store_half            (QMmatn m, QMhalf* out);
  * QMmatn       qm_matn_identity              ();
  * QMmatn       qm_matn_add                   (QMmatn m1, QMmatn m2);
  * QMmatn       qm_matn_sub                   (QMmatn m1, QMmatn m2);
  * QMmatn       qm_matn_mult                  (QMmatn m1, QMmatn m2);
  * QMvecn       qm_matn_mult_vecn             (QMmatn m , QMvecn v );
  * QMvec3       qm_mat4_transform_vec3        (QMmat4 m , QMvec3 v );
+ * void         qm_mat4_mult_array            (QMmat4 m , const QMmat4* in, QMmat4* out, size_t count);
+ * void         qm_mat4_mult_array_pairwise   (const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count);
+ * void         qm_mat4_mult_vec4_array       (QMmat4 m , const QMvec4* in, QMvec4* out, size_t count);
+ * void         qm_mat4_transform_vec3_array  (QMmat4 m , const QMvec3* in, QMvec3* out, size_t count);
+ * void         qm_mat4_transform_vec3_dir_array (QMmat4 m , const QMvec3* in, QMvec3* out, size_t count);
  * QMmatn       qm_matn_transpose             (QMmatn m);
  * QMmatn       qm_matn_inv                   (QMmatn m);
+ * QMmat4       qm_mat4_inv_affine            (QMmat4 m);
+ * QMmat4       qm_mat4_inv_rigid             (QMmat4 m);
  * 
  * QMmat3       qm_mat3_translate             (QMvec2 t);
  * QMmat4       qm_mat4_translate             (QMvec3 t);
@@ -73,6 +130,8 @@
  * 
  * QMquaternion qm_quaternion_load            (const float* in);
  * void         qm_quaternion_store           (QMquaternion q, float* out);
+ * QMquaternion qm_quaternion_load_half       (const QMhalf* in);
+ * void         qm_quaternion_store_half      (QMquaternion q, QMhalf* out);
  * QMquaternion qm_quaternion_identity        ();
  * QMquaternion qm_quaternion_add             (QMquaternion q1, QMquaternion q2);
  * QMquaternion qm_quaternion_sub             (QMquaternion q1, QMquaternion q2);
@@ -81,12 +140,17 @@
  * QMquaternion qm_quaternion_dot             (QMquaternion q1, QMquaternion q2);
  * float        qm_quaternion_length          (QMquaternion q);
  * QMquaternion qm_quaternion_normalize       (QMquaternion q);
+ * void         qm_quaternion_normalize_array (const QMquaternion* in, QMquaternion* out, size_t count);
  * QMquaternion qm_quaternion_conjugate       (QMquaternion q);
  * QMquaternion qm_quaternion_inv             (QMquaternion q);
+ * QMquaternion qm_quaternion_nlerp           (QMquaternion q1, QMquaternion q2, float a);
  * QMquaternion qm_quaternion_slerp           (QMquaternion q1, QMquaternion q2, float a);
+ * void         qm_quaternion_blend_array     (const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count);
  * QMquaternion qm_quaternion_from_axis_angle (QMvec3 axis, float angle);
  * QMquaternion qm_quaternion_from_euler      (QMvec3 angles);
  * QMmat4       qm_quaternion_to_mat4         (QMquaternion q);
+ * QMmat4       qm_mat4_from_trs              (QMvec3 t, QMquaternion r, QMvec3 s);
+ * void         qm_mat4_from_trs_array        (const QMvec3* t, const QMquaternion* r, const QMvec3* s, QMmat4* out, size_t count);
  * 
  * QMbboxn      qm_bboxn_load                 (const float* b);
  * void         qm_bboxn_store                (QMbboxn b, float* out);
@@ -95,12 +159,86 @@
  * void         qm_bboxn_union_inplace        (QMbboxn* b1, QMbboxn b2);
  * QMbboxn      qm_bboxn_union_vecn           (QMbboxn b, QMvecn v);
  * void         qm_bboxn_union_vecn_inplace   (QMbboxn* b, QMvecn v);
+ * QMbbox3      qm_bbox3_union_vec3_array     (QMbbox3 b, const QMvec3* v, size_t count);
+ * QMbbox3      qm_bbox3_union_array          (QMbbox3 b, const QMbbox3* boxes, size_t count);
+ * QMbbox3      qm_bbox3_union_vec3_array_parallel(QMbbox3 b, const QMvec3* v, size_t count, QMparallelForFunc parallelFor, void* user);
+ * QMbbox3      qm_bbox3_union_array_parallel (QMbbox3 b, const QMbbox3* boxes, size_t count, QMparallelForFunc parallelFor, void* user);
  * QMvecn       qm_bboxn_extent               (QMbboxn b);
  * QMvecn       qm_bboxn_centroid             (QMbboxn b);
  * QMvecn       qm_bboxn_offset               (QMbboxn b, QMvecn v);
  * 
+ * QMbbox3p     qm_bbox3p_from_bbox3          (QMbbox3 b);
+ * QMbbox3      qm_bbox3p_to_bbox3            (QMbbox3p b);
+ * QMbbox3p     qm_bbox3p_initialized         ();
+ * QMbbox3p     qm_bbox3p_union               (QMbbox3p b1, QMbbox3p b2);
+ * void         qm_bbox3p_union_inplace       (QMbbox3p* b1, QMbbox3p b2);
+ * QMbbox3p     qm_bbox3p_union_vec3          (QMbbox3p b, QMvec3 v);
+ * void         qm_bbox3p_union_vec3_inplace  (QMbbox3p* b, QMvec3 v);
+ * 
  * float        qm_bbox2_perimeter            (QMbbox2 b);
  * float        qm_bbox3_surface_area         (QMbbox3 b);
+ * QMbbox3      qm_bbox3_transform            (QMmat4 m, QMbbox3 b);
+ * void         qm_bbox3_transform_array      (const QMmat4* m, const QMbbox3* in, QMbbox3* out, size_t count);
+ * 
+ * QMbbox3xn    qm_bbox3xn_load               (const QMbbox3* in);
+ * 
+ * QMray        qm_ray_create                 (QMvec3 origin, QMvec3 dir);
+ * QMrayxn      qm_rayxn_create               (QMvec3xn origin, QMvec3xn dir);
+ * QMbool       qm_ray_intersect_bbox3        (QMray r, QMbbox3 b, float tMax, float* tNear, float* tFar);
+ * int          qm_ray_intersect_bbox3xn      (QMray r, QMbbox3xn b, float tMax, QMvecn_lanes* tNear, QMvecn_lanes* tFar);
+ * int          qm_rayxn_intersect_bbox3      (QMrayxn r, QMbbox3 b, QMvecn_lanes tMax, QMvecn_lanes* tNear, QMvecn_lanes* tFar);
+ * QMtrianglexn qm_trianglexn_load            (const QMvec3* v0, const QMvec3* v1, const QMvec3* v2);
+ * QMbool       qm_ray_intersect_trianglexn   (QMray r, QMtrianglexn tri, float tMax, QMrayHit* hit);
+ * 
+ * uint32_t     qm_bvh_build                  (const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices);
+ * uint32_t     qm_bvh_build_parallel         (const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices,
+ *                                             QMbvhParallelState* state, QMparallelForFunc parallelFor, void* user);
+ * uint32_t     qm_bvh_build_lbvh             (const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices, uint32_t* scratch);
+ * float        qm_bvh_sah_cost               (const QMbvhNode* nodes);
+ * 
+ * void         qm_bvh_refit_init             (QMbvhRefit* r);
+ * void         qm_bvh_refit_mark_dirty       (QMbvhRefit* r, uint32_t prim);
+ * void         qm_bvh_refit                  (QMbvhRefit* r, QMbool rotate);
+ * float        qm_bvh_refit_cost_drift       (const QMbvhRefit* r);
+ * 
+ * QMfrustum    qm_frustum_from_mat4          (QMmat4 m);
+ * QMcullResult qm_frustum_classify_bbox3     (QMfrustum f, QMbbox3 b);
+ * void         qm_frustum_cull_bbox3         (QMfrustum f, const QMbbox3* boxes, size_t count, uint32_t* visible);
+ * size_t       qm_frustum_cull_bbox3_indices (QMfrustum f, const QMbbox3* boxes, size_t count, uint32_t* indices);
+ * size_t       qm_frustum_cull_bvh           (QMfrustum f, const QMbvhNode* nodes, uint8_t* planeCache, uint32_t* leaves);
+ * 
+ * void         qm_hierarchy_init             (QMhierarchy* h);
+ * void         qm_hierarchy_mark_dirty       (QMhierarchy* h, int node);
+ * void         qm_hierarchy_update           (QMhierarchy* h);
+ * void         qm_hierarchy_update_all       (QMhierarchy* h);
+ * 
+ * uint32_t     qm_quaternion_pack32          (QMquaternion q);
+ * QMquaternion qm_quaternion_unpack32        (uint32_t packed);
+ * QMquaternion48 qm_quaternion_pack48        (QMquaternion q);
+ * QMquaternion qm_quaternion_unpack48        (QMquaternion48 packed);
+ * QMvec3u16    qm_vec3_pack16                (QMbbox3 b, QMvec3 v);
+ * QMvec3       qm_vec3_unpack16              (QMbbox3 b, QMvec3u16 packed);
+ * uint32_t     qm_vec3_pack_oct              (QMvec3 v);
+ * QMvec3       qm_vec3_unpack_oct            (uint32_t packed);
+ * void         qm_quaternion_pack32_array    (const QMquaternion* in, uint32_t* out, size_t count);
+ * void         qm_quaternion_unpack32_array  (const uint32_t* in, QMquaternion* out, size_t count);
+ * void         qm_quaternion_pack48_array    (const QMquaternion* in, QMquaternion48* out, size_t count);
+ * void         qm_quaternion_unpack48_array  (const QMquaternion48* in, QMquaternion* out, size_t count);
+ * void         qm_vec3_pack16_array          (QMbbox3 b, const QMvec3* in, QMvec3u16* out, size_t count);
+ * void         qm_vec3_unpack16_array        (QMbbox3 b, const QMvec3u16* in, QMvec3* out, size_t count);
+ * void         qm_vec3_pack_oct_array        (const QMvec3* in, uint32_t* out, size_t count);
+ * void         qm_vec3_unpack_oct_array      (const uint32_t* in, QMvec3* out, size_t count);
+ * 
+ * void         qm_anim_track_pack            (const QManimKey* keys, uint32_t count, QManimKeyBlock* blocks);
+ * void         qm_anim_track_sample          (QManimTrack track, uint32_t* cursor, float t, QMvec3* translation, QMquaternion* rotation, QMvec3* scale);
+ * void         qm_anim_sample                (const QManimTrack* tracks, uint32_t* cursors, size_t count, float t,
+ *                                             QMvec3* translations, QMquaternion* rotations, QMvec3* scales);
+ * void         qm_anim_sample_mat4           (const QManimTrack* tracks, uint32_t* cursors, size_t count, float t, QMmat4* out);
+ * 
+ * QMsimdTier   qm_simd_tier                  ();
+ * const char*  qm_simd_tier_name             (QMsimdTier tier);
+ * QMsimdTier   qm_cpu_simd_tier              ();                  (QM_RUNTIME_DISPATCH only)
+ * QMsimdTier   qm_dispatch_init              (QMsimdTier maxTier); (QM_RUNTIME_DISPATCH only)
  */
 
 #ifndef QM_MATH_H
@@ -111,6 +249,9 @@ extern "C"
 {
 #endif
 
+#include <stddef.h>
+#include <stdint.h>
+
 //check for SSE support
 #if defined(__SSE3__)
 	#include <xmmintrin.h>
@@ -121,6 +262,115 @@ extern "C"
 	#define QM_USE_SSE 0
 #endif
 
+//check for AVX support (only used for the 8-wide types)
+#if QM_USE_SSE && defined(__AVX__)
+	#include <immintrin.h>
+
+	#define QM_USE_AVX 1
+#else
+	#define QM_USE_AVX 0
+#endif
+
+//check for AVX2 and FMA support
+#if QM_USE_AVX && defined(__AVX2__) && defined(__FMA__)
+	#define QM_USE_AVX2 1
+#else
+	#define QM_USE_AVX2 0
+#endif
+
+//check for AVX-512 support (only used for the batch functions)
+#if QM_USE_AVX2 && defined(__AVX512F__)
+	#define QM_USE_AVX512 1
+#else
+	#define QM_USE_AVX512 0
+#endif
+
+//check for F16C support (only used for the half-precision functions)
+#if QM_USE_AVX && defined(__F16C__)
+	#define QM_USE_F16C 1
+#else
+	#define QM_USE_F16C 0
+#endif
+
+//the cosine of half the angle between 2 quaternions above which slerp falls back to nlerp (about 3.6 degrees of rotation)
+#ifndef QM_SLERP_THRESHOLD
+	#define QM_SLERP_THRESHOLD 0.9995f
+#endif
+
+//how many tracks the animation sampling functions blend at once, sets the size of their stack buffers
+#ifndef QM_ANIM_BATCH
+	#define QM_ANIM_BATCH 64
+#endif
+
+//how many elements ahead the batch functions prefetch
+#ifndef QM_PREFETCH_DISTANCE
+	#define QM_PREFETCH_DISTANCE 8
+#endif
+
+//the deepest bounding volume hierarchy the traversal functions can handle, sets their stack size
+#ifndef QM_BVH_MAX_DEPTH
+	#define QM_BVH_MAX_DEPTH 64
+#endif
+
+//how many bins the bounding volume hierarchy builder sorts centroids into when choosing a split
+#ifndef QM_BVH_BINS
+	#define QM_BVH_BINS 16
+#endif
+
+//the most primitives a leaf can hold, larger nodes are split even if the SAH says not to
+#ifndef QM_BVH_MAX_LEAF_SIZE
+	#define QM_BVH_MAX_LEAF_SIZE 8
+#endif
+
+//how many subtrees the parallel bounding volume hierarchy builder splits the work into, and how many chunks
+//(of at least QM_BVH_PARALLEL_MIN_CHUNK primitives) it splits each node above them into
+#ifndef QM_BVH_PARALLEL_TASKS
+	#define QM_BVH_PARALLEL_TASKS 256
+#endif
+#ifndef QM_BVH_PARALLEL_CHUNKS
+	#define QM_BVH_PARALLEL_CHUNKS 32
+#endif
+#ifndef QM_BVH_PARALLEL_MIN_CHUNK
+	#define QM_BVH_PARALLEL_MIN_CHUNK 4096
+#endif
+
+//the most chunks the parallel array union functions split their input into, and the fewest points or boxes in each
+#ifndef QM_UNION_PARALLEL_CHUNKS
+	#define QM_UNION_PARALLEL_CHUNKS 64
+#endif
+#ifndef QM_UNION_PARALLEL_MIN_CHUNK
+	#define QM_UNION_PARALLEL_MIN_CHUNK 65536
+#endif
+
+//check for runtime dispatch support (only used for the batch functions)
+#if defined(QM_RUNTIME_DISPATCH) && (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+
+	#define QM_USE_DISPATCH 1
+#else
+	#define QM_USE_DISPATCH 0
+#endif
+
+//lets a single function use AVX/AVX2/AVX-512 when the rest of the file is compiled without them. clang-cl needs
+//them as well, MSVC accepts any intrinsic without an /arch flag
+#if QM_USE_DISPATCH && (defined(__GNUC__) || defined(__clang__))
+	#define QM_TARGET_AVX    __attribute__((target("avx")))
+	#define QM_TARGET_F16C   __attribute__((target("avx,f16c")))
+	#define QM_TARGET_AVX2   __attribute__((target("avx,avx2,fma")))
+	#define QM_TARGET_AVX512 __attribute__((target("avx,avx2,fma,avx512f")))
+#else
+	#define QM_TARGET_AVX
+	#define QM_TARGET_F16C
+	#define QM_TARGET_AVX2
+	#define QM_TARGET_AVX512
+#endif
+
 //define customizeable function prefix
 #ifndef QM_FUNC_PREFIX
 	#define QM_FUNC_PREFIX(name) qm_##name
@@ -151,6 +401,9 @@ extern "C"
 
 typedef int QMbool;
 
+//an IEEE half-precision float, stored as its bits
+typedef uint16_t QMhalf;
+
 //a 2-dimensional vector of floats
 typedef union
 {
@@ -182,6 +435,53 @@ typedef union
 	#endif
 } QMvec4;
 
+//a 3-dimensional vector quantized to 16 bits per component within a bounding box, see qm_vec3_pack16
+typedef struct
+{
+	uint16_t v[3];
+} QMvec3u16;
+
+//-----------------------------//
+//wide vectors hold several vectors as separate x, y, and z lanes (SoA)
+
+//4 3-dimensional vectors of floats
+typedef union
+{
+	float v[3][4];
+	struct{ float x[4], y[4], z[4]; };
+
+	#if QM_USE_SSE
+
+	__m128 packed[3]; //x, y, and z lanes
+
+	#endif
+} QMvec3x4;
+
+//8 3-dimensional vectors of floats
+typedef union
+{
+	float v[3][8];
+	struct{ float x[8], y[8], z[8]; };
+
+	#if QM_USE_AVX
+
+	__m256 packed[3]; //x, y, and z lanes
+
+	#endif
+} QMvec3x8;
+
+//8 floats, holds the per-lane results of QMvec3x8 functions
+typedef union
+{
+	float v[8];
+
+	#if QM_USE_AVX
+
+	__m256 packed;
+
+	#endif
+} QMvec8;
+
 //-----------------------------//
 //matrices are column-major
 
@@ -220,6 +520,12 @@ typedef union
 	#endif
 } QMquaternion;
 
+//a quaternion compressed to 48 bits, see qm_quaternion_pack48
+typedef struct
+{
+	uint16_t v[3];
+} QMquaternion48;
+
 //-----------------------------//
 
 //a 2-dimensional bounding box
@@ -236,1848 +542,9030 @@ typedef struct
 	QMvec3 max;
 } QMbbox3;
 
-//----------------------------------------------------------------------//
-//HELPER FUNCS:
+//a 3-dimensional bounding box with its min and max held in SIMD registers, for accumulating many points or boxes
+//one at a time. w is unused and kept at 0
+typedef struct
+{
+	QMvec4 min;
+	QMvec4 max;
+} QMbbox3p;
 
-#define QM_MIN(x, y) ((x) < (y) ? (x) : (y))
-#define QM_MAX(x, y) ((x) > (y) ? (x) : (y))
-#define QM_ABS(x) ((x) > 0 ? (x) : -(x))
+//4 3-dimensional bounding boxes, stored as x, y, and z lanes of their mins and maxes
+typedef struct
+{
+	QMvec3x4 min;
+	QMvec3x4 max;
+} QMbbox3x4;
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(rad_to_deg)(float rad)
+//8 3-dimensional bounding boxes, stored as x, y, and z lanes of their mins and maxes
+typedef struct
 {
-	return rad * 57.2957795131f;
-}
+	QMvec3x8 min;
+	QMvec3x8 max;
+} QMbbox3x8;
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(deg_to_rad)(float deg)
+//-----------------------------//
+
+//a ray, invDir holds 1 / dir so the slab tests don't need to divide (infinite where dir is 0)
+typedef struct
 {
-	return deg * 0.01745329251f;
-}
+	QMvec3 origin;
+	QMvec3 dir;
+	QMvec3 invDir;
+} QMray;
 
-#if QM_USE_SSE
+//4 rays stored as x, y, and z lanes, for testing a coherent packet against one box at a time
+typedef struct
+{
+	QMvec3x4 origin;
+	QMvec3x4 dir;
+	QMvec3x4 invDir;
+} QMrayx4;
 
-QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat4_mult_column_sse)(__m128 c1, QMmat4 m2)
+//8 rays stored as x, y, and z lanes
+typedef struct
 {
-	__m128 result;
+	QMvec3x8 origin;
+	QMvec3x8 dir;
+	QMvec3x8 invDir;
+} QMrayx8;
 
-	result =                    _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(0, 0, 0, 0)), m2.packed[0]);
-	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(1, 1, 1, 1)), m2.packed[1]));
-	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(2, 2, 2, 2)), m2.packed[2]));
-	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 3, 3, 3)), m2.packed[3]));
+//4 triangles stored as x, y, and z lanes of their first vertex and the 2 edges leaving it
+typedef struct
+{
+	QMvec3x4 v0;
+	QMvec3x4 e1; //v1 - v0
+	QMvec3x4 e2; //v2 - v0
+} QMtrianglex4;
 
-	return result;
-}
+//8 triangles stored as x, y, and z lanes of their first vertex and the 2 edges leaving it
+typedef struct
+{
+	QMvec3x8 v0;
+	QMvec3x8 e1;
+	QMvec3x8 e2;
+} QMtrianglex8;
 
-#endif
+//where a ray hit a group of triangles, the point is v0 + u * e1 + v * e2 of the triangle in lane index
+typedef struct
+{
+	float t;
+	float u, v;
+	int index;
+} QMrayHit;
 
-//----------------------------------------------------------------------//
-//VECTOR FUNCTIONS:
+//-----------------------------//
 
-//loading:
+//a view frustum as 6 planes (left, right, bottom, top, near, far), each stored as (a, b, c, d) with the
+//normal pointing inwards, so a * x + b * y + c * z + d >= 0 for points inside
+typedef struct
+{
+	QMvec4 planes[6];
+} QMfrustum;
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_load)(const float* in)
+//the result of testing a volume against a frustum
+typedef enum
 {
-	return (QMvec2){ in[0], in[1] };
-}
+	QM_OUTSIDE = 0,
+	QM_INTERSECTS,
+	QM_INSIDE
+} QMcullResult;
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_load)(const float* in)
+//a node of a flat bounding volume hierarchy (32 bytes), the root is node 0. interior nodes have count == 0 and
+//their children at leftFirst and leftFirst + 1, leaves hold the primitives [leftFirst, leftFirst + count)
+typedef struct
 {
-	return (QMvec3){ in[0], in[1], in[2] };
-}
+	QMbbox3 bounds;
+	uint32_t leftFirst;
+	uint32_t count;
+} QMbvhNode;
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_load)(const float* in)
+//the centroid bins of a node being split by the bounding volume hierarchy builders, along every axis at once
+typedef struct
 {
-	return (QMvec4){ in[0], in[1], in[2], in[3] };
-}
+	int numBins;
+	QMvec3 offset;
+	float scale[3];
 
-//storing:
+	QMbbox3 bounds[3][QM_BVH_BINS];
+	uint32_t counts[3][QM_BVH_BINS];
+} QMbvhBins;
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec2_store)(QMvec2 v, float* out)
+//runs task(data, index) for every index in [0, count) and returns once they have all finished. the calls can run on
+//any thread in any order, this is how the parallel functions hand work to the caller's thread pool
+typedef void (*QMtaskFunc)(void* data, uint32_t index);
+typedef void (*QMparallelForFunc)(void* user, QMtaskFunc task, void* data, uint32_t count);
+
+//scratch memory for the parallel array union functions, one of points and boxes is NULL
+typedef struct
 {
-	out[0] = v.x;
-	out[1] = v.y;
-}
+	const QMvec3* points;
+	const QMbbox3* boxes;
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_store)(QMvec3 v, float* out)
+	size_t chunkFirst[QM_UNION_PARALLEL_CHUNKS + 1];
+	QMbbox3 chunkBounds[QM_UNION_PARALLEL_CHUNKS];
+} QMunionParallelState;
+
+//scratch memory for qm_bvh_build_parallel. the top of the tree is split one node at a time with the binning and
+//partitioning spread over chunks, then every subtree below it (at most QM_BVH_PARALLEL_TASKS) is built by one task
+typedef struct
 {
-	out[0] = v.x;
-	out[1] = v.y;
-	out[2] = v.z;
-}
+	const QMbbox3* prims;
+	QMbvhNode* nodes;
+	uint32_t* primIndices;
+
+	//the range being reduced or partitioned, chunk c covers [chunkFirst[c], chunkFirst[c + 1])
+	uint32_t numChunks;
+	uint32_t chunkFirst[QM_BVH_PARALLEL_CHUNKS + 1];
+	QMbbox3 chunkBounds[QM_BVH_PARALLEL_CHUNKS];
+	QMbbox3 chunkCentroids[QM_BVH_PARALLEL_CHUNKS];
+	QMbbox3 chunkRightCentroids[QM_BVH_PARALLEL_CHUNKS];
+	uint32_t chunkMid[QM_BVH_PARALLEL_CHUNKS];
+	QMbvhBins chunkBins[QM_BVH_PARALLEL_CHUNKS];
+
+	//the split being partitioned
+	const QMbvhBins* bins;
+	int axis;
+	int split;
+
+	//the misplaced primitives after every chunk is partitioned, the right ones in front of mid and the left
+	//ones after it, as ranges in order. there are numMisplaced of each, swap chunk c swaps the ones from
+	//numMisplaced * c / numChunks up to numMisplaced * (c + 1) / numChunks, counted through the ranges
+	uint32_t numMisplaced;
+	uint32_t misplacedRight[QM_BVH_PARALLEL_CHUNKS][2];
+	uint32_t misplacedLeft[QM_BVH_PARALLEL_CHUNKS][2];
+	uint32_t numMisplacedRight;
+	uint32_t numMisplacedLeft;
+
+	//the top of the tree, its leaves are the subtree tasks
+	QMbvhNode top[2 * QM_BVH_PARALLEL_TASKS];
+	uint32_t topDepth[2 * QM_BVH_PARALLEL_TASKS];
+	QMbbox3 topCentroids[2 * QM_BVH_PARALLEL_TASKS];
+	int topTask[2 * QM_BVH_PARALLEL_TASKS]; //-1 for interior nodes
+
+	uint32_t numTasks;
+	uint32_t taskTop[QM_BVH_PARALLEL_TASKS];
+	uint32_t taskStart[QM_BVH_PARALLEL_TASKS]; //where each task's descendants are written before being moved
+	uint32_t taskEnd[QM_BVH_PARALLEL_TASKS];
+} QMbvhParallelState;
+
+//a bounding volume hierarchy that is refit as its primitives move instead of being rebuilt. the arrays are owned by
+//the caller, nodes and primIndices come from one of the builders and prims holds the primitives' current bounds
+typedef struct
+{
+	QMbvhNode* nodes;
+	uint32_t nodeCount;
+	const QMbbox3* prims;
+	const uint32_t* primIndices;
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_store)(QMvec4 v, float* out)
+	uint32_t* parents;    //one per node, filled by qm_bvh_refit_init
+	uint8_t* heights;     //one per node, filled by qm_bvh_refit_init
+	uint32_t* primLeaves; //one per primitive, the leaf holding it, filled by qm_bvh_refit_init
+	QMbool* dirty;        //one per node
+	uint32_t* dirtyList;  //one per node
+	uint32_t dirtyCount;
+
+	float areaSum;        //the sah cost times the root's surface area, kept up to date by qm_bvh_refit
+	float initialCost;
+} QMbvhRefit;
+
+//-----------------------------//
+
+//a flat transform hierarchy, world = world of parent * local. the arrays are owned by the caller and hold one
+//element per node. nodes must be in depth-first order, so every parent comes before its children and every
+//subtree is a contiguous range of nodes
+typedef struct
 {
-	out[0] = v.x;
-	out[1] = v.y;
-	out[2] = v.z;
-	out[3] = v.w;
-}
+	int count;
 
-//full:
+	const int* parents; //-1 for root nodes
+	const QMmat4* local;
+	QMmat4* world;
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_full)(float val)
+	int* subtreeEnd; //one past the last node of each node's subtree, filled by qm_hierarchy_init
+	QMbool* dirty;
+	int* dirtyList;
+	int dirtyCount;
+} QMhierarchy;
+
+//-----------------------------//
+
+//the transform of an animation track at one point in time
+typedef struct
 {
-	return (QMvec2){ val, val };
-}
+	float time;
+	QMvec3 translation;
+	QMquaternion rotation;
+	QMvec3 scale;
+} QManimKey;
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_full)(float val)
+//4 consecutive keys of an animation track stored as lanes (192 bytes, 3 cache lines). the times come first, so
+//seeking through a track reads one cache line per 4 keys
+typedef struct
 {
-	return (QMvec3){ val, val, val };
-}
+	float time[4];
+	QMvec3x4 translation;
+	float rotation[4][4]; //x, y, z, and w lanes
+	QMvec3x4 scale;
+	float unused[4];
+} QManimKeyBlock;
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_full)(float val)
+//an animation track, blocks holds the keys (at least 1, sorted by time) packed by qm_anim_track_pack and is owned by
+//the caller. the playback position lives in a separate cursor so several instances can play the same track
+typedef struct
 {
-	return (QMvec4){ val, val, val, val };
-}
+	const QManimKeyBlock* blocks;
+	uint32_t keyCount;
+} QManimTrack;
 
-//addition:
+//-----------------------------//
+//runtime dispatch
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_add)(QMvec2 v1, QMvec2 v2)
+//SIMD instruction set tiers, ordered from slowest to fastest
+typedef enum
 {
-	QMvec2 result;
+	QM_SIMD_SCALAR = 0,
+	QM_SIMD_SSE,
+	QM_SIMD_AVX2,
+	QM_SIMD_AVX512
+} QMsimdTier;
 
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
+#if QM_USE_DISPATCH
 
-	return result;
-}
+//the batch kernels selected for the cpu, matrices are passed by pointer to avoid needing alignment
+typedef struct
+{
+	QMsimdTier tier;
+
+	void (*mat4_mult_array)              (const QMmat4* m, const QMmat4* in, QMmat4* out, size_t count);
+	void (*mat4_mult_array_pairwise)     (const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count);
+	void (*frustum_cull_bbox3)           (const QMfrustum* f, const QMbbox3* boxes, size_t count, uint32_t* visible);
+	void (*mat4_from_trs_array)          (const QMvec3* t, const QMquaternion* r, const QMvec3* s, QMmat4* out, size_t count);
+	void (*mat4_mult_vec4_array)         (const QMmat4* m, const QMvec4* in, QMvec4* out, size_t count);
+	void (*mat4_transform_vec3_array)    (const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count);
+	void (*mat4_transform_vec3_dir_array)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count);
+	void (*vec4_dot_array)               (const QMvec4* v1, const QMvec4* v2, float* out, size_t count);
+	void (*quaternion_normalize_array)   (const QMquaternion* in, QMquaternion* out, size_t count);
+	void (*quaternion_blend_array)       (const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count);
+	QMbbox3 (*bbox3_union_vec3_array)    (QMbbox3 b, const QMvec3* v, size_t count);
+	QMbbox3 (*bbox3_union_array)         (QMbbox3 b, const QMbbox3* boxes, size_t count);
+	void (*bbox3_transform_array)        (const QMmat4* m, const QMbbox3* in, QMbbox3* out, size_t count);
+	void (*quaternion_pack32_array)      (const QMquaternion* in, uint32_t* out, size_t count);
+	void (*quaternion_unpack32_array)    (const uint32_t* in, QMquaternion* out, size_t count);
+	void (*quaternion_pack48_array)      (const QMquaternion* in, QMquaternion48* out, size_t count);
+	void (*quaternion_unpack48_array)    (const QMquaternion48* in, QMquaternion* out, size_t count);
+	void (*vec3_pack16_array)            (QMbbox3 b, const QMvec3* in, QMvec3u16* out, size_t count);
+	void (*vec3_unpack16_array)          (QMbbox3 b, const QMvec3u16* in, QMvec3* out, size_t count);
+	void (*vec3_pack_oct_array)          (const QMvec3* in, uint32_t* out, size_t count);
+	void (*vec3_unpack_oct_array)        (const uint32_t* in, QMvec3* out, size_t count);
+	void (*float_to_half_array)          (const float* in, QMhalf* out, size_t count);
+	void (*half_to_float_array)          (const QMhalf* in, float* out, size_t count);
+} QMdispatchTable;
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_add)(QMvec3 v1, QMvec3 v2)
+#endif
+
+//----------------------------------------------------------------------//
+//HELPER FUNCS:
+
+#define QM_MIN(x, y) ((x) < (y) ? (x) : (y))
+#define QM_MAX(x, y) ((x) > (y) ? (x) : (y))
+#define QM_ABS(x) ((x) > 0 ? (x) : -(x))
+
+//clears the sign bit, unlike QM_ABS this never branches, which matters when the sign is unpredictable
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(absf)(float x)
 {
-	QMvec3 result;
+	union { float f; uint32_t u; } bits;
+	bits.f = x;
+	bits.u &= 0x7FFFFFFF;
 
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
-	result.z = v1.z + v2.z;
+	return bits.f;
+}
 
-	return result;
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(rad_to_deg)(float rad)
+{
+	return rad * 57.2957795131f;
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_add)(QMvec4 v1, QMvec4 v2)
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(deg_to_rad)(float deg)
 {
-	QMvec4 result;
+	return deg * 0.01745329251f;
+}
 
-	#if QM_USE_SSE
+//index of the lowest set bit, x must not be 0
 
-	result.packed = _mm_add_ps(v1.packed, v2.packed);
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(ctz32)(uint32_t x)
+{
+	#if defined(__GNUC__)
 
-	#else
+	return (uint32_t)__builtin_ctz(x);
 
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
-	result.z = v1.z + v2.z;
-	result.w = v1.w + v2.w;
+	#else
 
-	#endif
+	uint32_t result = 0;
+	while(!(x & 1))
+	{
+		x >>= 1;
+		result++;
+	}
 
 	return result;
-}
 
-//subtraction:
+	#endif
+}
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_sub)(QMvec2 v1, QMvec2 v2)
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(clz32)(uint32_t x)
 {
-	QMvec2 result;
+	#if defined(__GNUC__)
 
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
+	return (uint32_t)__builtin_clz(x);
+
+	#else
+
+	uint32_t result = 0;
+	while(!(x & 0x80000000u))
+	{
+		x <<= 1;
+		result++;
+	}
 
 	return result;
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_sub)(QMvec3 v1, QMvec3 v2)
+//in-place heapsort, so no scratch memory is needed
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(sift_down_ints)(int* a, int root, int count)
 {
-	QMvec3 result;
+	int val = a[root];
 
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
-	result.z = v1.z - v2.z;
+	for(;;)
+	{
+		int child = root * 2 + 1;
+		if(child >= count)
+			break;
+		if(child + 1 < count && a[child + 1] > a[child])
+			child++;
+		if(a[child] <= val)
+			break;
+
+		a[root] = a[child];
+		root = child;
+	}
 
-	return result;
+	a[root] = val;
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_sub)(QMvec4 v1, QMvec4 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(sort_ints)(int* a, int count)
 {
-	QMvec4 result;
-
-	#if QM_USE_SSE
-
-	result.packed = _mm_sub_ps(v1.packed, v2.packed);
-
-	#else
-
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
-	result.z = v1.z - v2.z;
-	result.w = v1.w - v2.w;
+	for(int i = count / 2 - 1; i >= 0; i--)
+		QM_FUNC_PREFIX(sift_down_ints)(a, i, count);
 
-	#endif
+	for(int i = count - 1; i > 0; i--)
+	{
+		int tmp = a[0];
+		a[0] = a[i];
+		a[i] = tmp;
 
-	return result;
+		QM_FUNC_PREFIX(sift_down_ints)(a, 0, i);
+	}
 }
 
-//multiplication:
-
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_mult)(QMvec2 v1, QMvec2 v2)
-{
-	QMvec2 result;
-
-	result.x = v1.x * v2.x;
-	result.y = v1.y * v2.y;
+#if QM_USE_DISPATCH
 
-	return result;
-}
+//defined at the end of the file
+QM_FUNC_ATTRIBS const QMdispatchTable* QM_FUNC_PREFIX(dispatch_table)(void);
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_mult)(QMvec3 v1, QMvec3 v2)
-{
-	QMvec3 result;
+#endif
 
-	result.x = v1.x * v2.x;
-	result.y = v1.y * v2.y;
-	result.z = v1.z * v2.z;
+#if QM_USE_SSE || QM_USE_DISPATCH
 
-	return result;
-}
+//a * b + c, fused when FMA is available
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_mult)(QMvec4 v1, QMvec4 v2)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(fmadd_sse)(__m128 a, __m128 b, __m128 c)
 {
-	QMvec4 result;
-
-	#if QM_USE_SSE
+	#if QM_USE_AVX2
 
-	result.packed = _mm_mul_ps(v1.packed, v2.packed);
+	return _mm_fmadd_ps(a, b, c);
 
 	#else
 
-	result.x = v1.x * v2.x;
-	result.y = v1.y * v2.y;
-	result.z = v1.z * v2.z;
-	result.w = v1.w * v2.w;
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
 
 	#endif
-
-	return result;
 }
 
-//division:
+#endif
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_div)(QMvec2 v1, QMvec2 v2)
+#if QM_USE_SSE
+
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat4_mult_column_sse)(__m128 c1, QMmat4 m2)
 {
-	QMvec2 result;
+	__m128 result;
 
-	result.x = v1.x / v2.x;
-	result.y = v1.y / v2.y;
+	result = _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(0, 0, 0, 0)), m2.packed[0]);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(1, 1, 1, 1)), m2.packed[1], result);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(2, 2, 2, 2)), m2.packed[2], result);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 3, 3, 3)), m2.packed[3], result);
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_div)(QMvec3 v1, QMvec3 v2)
+#if QM_USE_AVX2
+
+//same as mat4_mult_column_sse, but multiplies 2 columns (or 2 vec4s) at once
+
+QM_FUNC_ATTRIBS __m256 QM_FUNC_PREFIX(mat4_mult_column2_avx)(__m256 c1, QMmat4 m2)
 {
-	QMvec3 result;
+	__m256 result;
 
-	result.x = v1.x / v2.x;
-	result.y = v1.y / v2.y;
-	result.z = v1.z / v2.z;
+	result = _mm256_mul_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_broadcast_ps(&m2.packed[0]));
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_broadcast_ps(&m2.packed[1]), result);
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(2, 2, 2, 2)), _mm256_broadcast_ps(&m2.packed[2]), result);
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_broadcast_ps(&m2.packed[3]), result);
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_div)(QMvec4 v1, QMvec4 v2)
-{
-	QMvec4 result;
+#endif
 
-	#if QM_USE_SSE
+#endif
 
-	result.packed = _mm_div_ps(v1.packed, v2.packed);
+#if QM_USE_SSE || QM_USE_DISPATCH
 
-	#else
+//same as mat4_mult_column_sse, but with the matrix's columns already loaded
 
-	result.x = v1.x / v2.x;
-	result.y = v1.y / v2.y;
-	result.z = v1.z / v2.z;
-	result.w = v1.w / v2.w;
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(__m128 c1, __m128 m0, __m128 m1, __m128 m2, __m128 m3)
+{
+	__m128 result;
 
-	#endif
+	result = _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(1, 1, 1, 1)), m1, result);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(2, 2, 2, 2)), m2, result);
+	result = QM_FUNC_PREFIX(fmadd_sse)(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 3, 3, 3)), m3, result);
 
 	return result;
 }
 
-//scalar multiplication:
+//loads 4 consecutive QMvec3s and transposes them into x, y, and z lanes
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_scale)(QMvec2 v, float s)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_load4_sse)(const QMvec3* in, __m128* x, __m128* y, __m128* z)
 {
-	QMvec2 result;
+	const float* f = (const float*)in;
 
-	result.x = v.x * s;
-	result.y = v.y * s;
+	__m128 l0 = _mm_loadu_ps(f    ); //x0 y0 z0 x1
+	__m128 l1 = _mm_loadu_ps(f + 4); //y1 z1 x2 y2
+	__m128 l2 = _mm_loadu_ps(f + 8); //z2 x3 y3 z3
 
-	return result;
+	__m128 x23 = _mm_shuffle_ps(l1, l2, _MM_SHUFFLE(1, 1, 2, 2));
+	__m128 y01 = _mm_shuffle_ps(l0, l1, _MM_SHUFFLE(0, 0, 1, 1));
+	__m128 y23 = _mm_shuffle_ps(l1, l2, _MM_SHUFFLE(2, 2, 3, 3));
+	__m128 z01 = _mm_shuffle_ps(l0, l1, _MM_SHUFFLE(1, 1, 2, 2));
+
+	*x = _mm_shuffle_ps(l0 , x23, _MM_SHUFFLE(2, 0, 3, 0));
+	*y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+	*z = _mm_shuffle_ps(z01, l2 , _MM_SHUFFLE(3, 0, 2, 0));
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_scale)(QMvec3 v, float s)
+//transposes x, y, and z lanes back into 4 consecutive QMvec3s
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_store4_sse)(__m128 x, __m128 y, __m128 z, QMvec3* out)
 {
-	QMvec3 result;
+	float* f = (float*)out;
 
-	result.x = v.x * s;
-	result.y = v.y * s;
-	result.z = v.z * s;
+	__m128 xy01 = _mm_unpacklo_ps(x, y);
+	__m128 xy23 = _mm_unpackhi_ps(x, y);
+	__m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+	__m128 yz1  = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+	__m128 yz3  = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
 
-	return result;
+	_mm_storeu_ps(f    , _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(f + 4, _mm_shuffle_ps(yz1 , xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+	_mm_storeu_ps(f + 8, _mm_shuffle_ps(zx23, yz3 , _MM_SHUFFLE(2, 0, 2, 0)));
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_scale)(QMvec4 v, float s)
+//loads 4 consecutive QMbbox3s and transposes them into x, y, and z lanes of their mins and maxes
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_load4_sse)(const QMbbox3* in, __m128* minX, __m128* minY, __m128* minZ, __m128* maxX, __m128* maxY, __m128* maxZ)
 {
-	QMvec4 result;
+	//each pair of boxes is 4 QMvec3s, (min0, max0, min1, max1)
+	__m128 x01, y01, z01, x23, y23, z23;
+	QM_FUNC_PREFIX(vec3_load4_sse)(&in[0].min, &x01, &y01, &z01);
+	QM_FUNC_PREFIX(vec3_load4_sse)(&in[2].min, &x23, &y23, &z23);
 
-	#if QM_USE_SSE
+	*minX = _mm_shuffle_ps(x01, x23, _MM_SHUFFLE(2, 0, 2, 0));
+	*minY = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+	*minZ = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+	*maxX = _mm_shuffle_ps(x01, x23, _MM_SHUFFLE(3, 1, 3, 1));
+	*maxY = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(3, 1, 3, 1));
+	*maxZ = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(3, 1, 3, 1));
+}
 
-	__m128 scale = _mm_set1_ps(s);
-	result.packed = _mm_mul_ps(v.packed, scale);
+//horizontal min/max of the 4 lanes
 
-	#else
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(hmin_sse)(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
 
-	result.x = v.x * s;
-	result.y = v.y * s;
-	result.z = v.z * s;
-	result.w = v.w * s;
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(hmax_sse)(__m128 v)
+{
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
 
-	#endif
+#endif
 
-	return result;
-}
+#if QM_USE_AVX2 || QM_USE_DISPATCH
 
-//dot product:
+//multiplies 2 columns at once, each of the matrix's columns must be broadcast to both halves
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_dot)(QMvec2 v1, QMvec2 v2)
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 __m256 QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(__m256 c1, __m256 m0, __m256 m1, __m256 m2, __m256 m3)
 {
-	float result;
+	__m256 result;
 
-	result = v1.x * v2.x + v1.y * v2.y;
+	result = _mm256_mul_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(1, 1, 1, 1)), m1, result);
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(2, 2, 2, 2)), m2, result);
+	result = _mm256_fmadd_ps(_mm256_permute_ps(c1, _MM_SHUFFLE(3, 3, 3, 3)), m3, result);
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_dot)(QMvec3 v1, QMvec3 v2)
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+//multiplies 4 columns (a whole matrix) at once, each of the matrix's columns must be broadcast to all 4 quarters
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 __m512 QM_FUNC_PREFIX(mat4_mult_column4_reg_avx512)(__m512 c1, __m512 m0, __m512 m1, __m512 m2, __m512 m3)
 {
-	float result;
+	__m512 result;
 
-	result = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	result = _mm512_mul_ps(_mm512_permute_ps(c1, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+	result = _mm512_fmadd_ps(_mm512_permute_ps(c1, _MM_SHUFFLE(1, 1, 1, 1)), m1, result);
+	result = _mm512_fmadd_ps(_mm512_permute_ps(c1, _MM_SHUFFLE(2, 2, 2, 2)), m2, result);
+	result = _mm512_fmadd_ps(_mm512_permute_ps(c1, _MM_SHUFFLE(3, 3, 3, 3)), m3, result);
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_dot)(QMvec4 v1, QMvec4 v2)
-{
-	float result;
+//mask with the lowest n bits set, n is clamped to 16
 
-	#if QM_USE_SSE
+QM_FUNC_ATTRIBS __mmask16 QM_FUNC_PREFIX(mask16_avx512)(size_t n)
+{
+	return (__mmask16)(n >= 16 ? 0xFFFF : (1u << n) - 1);
+}
 
-	__m128 r = _mm_mul_ps(v1.packed, v2.packed);
-	r = _mm_hadd_ps(r, r);
-	r = _mm_hadd_ps(r, r);
-	_mm_store_ss(&result, r);
+//loads up to 16 consecutive QMvec3s and transposes them into x, y, and z lanes, missing lanes are 0
 
-	#else
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(vec3_load16_avx512)(const QMvec3* in, size_t n, __m512* x, __m512* y, __m512* z)
+{
+	const float* f = (const float*)in;
+	size_t numFloats = n * 3;
 
-	result = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	__m512 l0 = _mm512_maskz_loadu_ps(QM_FUNC_PREFIX(mask16_avx512)(numFloats                           ), f     );
+	__m512 l1 = _mm512_maskz_loadu_ps(QM_FUNC_PREFIX(mask16_avx512)(numFloats > 16 ? numFloats - 16 : 0), f + 16);
+	__m512 l2 = _mm512_maskz_loadu_ps(QM_FUNC_PREFIX(mask16_avx512)(numFloats > 32 ? numFloats - 32 : 0), f + 32);
 
-	#endif
+	//first gather the lanes found in l0 and l1, then fill in the rest from l2
+	__m512 x01 = _mm512_permutex2var_ps(l0, _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 0, 0, 0, 0, 0), l1);
+	__m512 y01 = _mm512_permutex2var_ps(l0, _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 0, 0, 0, 0, 0), l1);
+	__m512 z01 = _mm512_permutex2var_ps(l0, _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 0, 0, 0, 0, 0), l1);
 
-	return result;
+	*x = _mm512_permutex2var_ps(x01, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29), l2);
+	*y = _mm512_permutex2var_ps(y01, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30), l2);
+	*z = _mm512_permutex2var_ps(z01, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31), l2);
 }
 
-//cross product
+//transposes x, y, and z lanes back into up to 16 consecutive QMvec3s
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_cross)(QMvec3 v1, QMvec3 v2)
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(vec3_store16_avx512)(__m512 x, __m512 y, __m512 z, QMvec3* out, size_t n)
 {
-	QMvec3 result;
+	float* f = (float*)out;
+	size_t numFloats = n * 3;
 
-	result.x = (v1.y * v2.z) - (v1.z * v2.y);
-	result.y = (v1.z * v2.x) - (v1.x * v2.z);
-	result.z = (v1.x * v2.y) - (v1.y * v2.x);
+	__m512 s0 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 16, 0, 1, 17, 0, 2, 18, 0, 3, 19, 0, 4, 20, 0, 5), y);
+	__m512 s1 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(21, 0, 6, 22, 0, 7, 23, 0, 8, 24, 0, 9, 25, 0, 10, 26), y);
+	__m512 s2 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 11, 27, 0, 12, 28, 0, 13, 29, 0, 14, 30, 0, 15, 31, 0), y);
 
-	return result;
+	s0 = _mm512_permutex2var_ps(s0, _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15), z);
+	s1 = _mm512_permutex2var_ps(s1, _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15), z);
+	s2 = _mm512_permutex2var_ps(s2, _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31), z);
+
+	_mm512_mask_storeu_ps(f     , QM_FUNC_PREFIX(mask16_avx512)(numFloats                           ), s0);
+	_mm512_mask_storeu_ps(f + 16, QM_FUNC_PREFIX(mask16_avx512)(numFloats > 16 ? numFloats - 16 : 0), s1);
+	_mm512_mask_storeu_ps(f + 32, QM_FUNC_PREFIX(mask16_avx512)(numFloats > 32 ? numFloats - 32 : 0), s2);
 }
 
-//length:
+#endif
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_length)(QMvec2 v)
-{
-	float result;
+#if QM_USE_SSE
 
-	result = QM_SQRTF(QM_FUNC_PREFIX(vec2_dot)(v, v));
+//2x2 matrix helpers for mat4_inv, each __m128 holds a 2x2 matrix as (m00, m01, m10, m11)
 
-	return result;
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat2_mult_sse)(__m128 m1, __m128 m2)
+{
+	return _mm_add_ps(_mm_mul_ps(                                       m1, _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(3, 0, 3, 0))),
+	                  _mm_mul_ps(_mm_shuffle_ps(m1, m1, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(1, 2, 1, 2))));
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_length)(QMvec3 v)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat2_adj_mult_sse)(__m128 m1, __m128 m2) //adj(m1) * m2
 {
-	float result;
-
-	result = QM_SQRTF(QM_FUNC_PREFIX(vec3_dot)(v, v));
-
-	return result;
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(m1, m1, _MM_SHUFFLE(0, 0, 3, 3)),                                        m2),
+	                  _mm_mul_ps(_mm_shuffle_ps(m1, m1, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(1, 0, 3, 2))));
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_length)(QMvec4 v)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(mat2_mult_adj_sse)(__m128 m1, __m128 m2) //m1 * adj(m2)
 {
-	float result;
+	return _mm_sub_ps(_mm_mul_ps(                                       m1, _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(0, 3, 0, 3))),
+	                  _mm_mul_ps(_mm_shuffle_ps(m1, m1, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(1, 2, 1, 2))));
+}
 
-	result = QM_SQRTF(QM_FUNC_PREFIX(vec4_dot)(v, v));
+#endif
 
-	return result;
-}
+//----------------------------------------------------------------------//
+//HALF PRECISION FUNCTIONS:
 
-//normalize:
+//conversions between floats and IEEE half-precision floats, rounding to nearest even. the software versions give the
+//same bits as F16C for every input: overflow becomes infinity, values below 2^-24 round to zero, and NaNs keep their
+//sign and upper payload bits and are quieted
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_normalize)(QMvec2 v)
+QM_FUNC_ATTRIBS QMhalf QM_FUNC_PREFIX(float_to_half)(float f)
 {
-	QMvec2 result = {0};
+	#if QM_USE_F16C
 
-	float invLen = QM_FUNC_PREFIX(vec2_length)(v);
-	if(invLen != 0.0f)
-	{
-		invLen = 1.0f / invLen;
-		result.x = v.x * invLen;
-		result.y = v.y * invLen;
-	}
+	return (QMhalf)_cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
 
-	return result;
-}
+	#else
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_normalize)(QMvec3 v)
-{
-	QMvec3 result = {0};
+	union { float f; uint32_t u; } in, denormal;
+	in.f = f;
 
-	float invLen = QM_FUNC_PREFIX(vec3_length)(v);
-	if(invLen != 0.0f)
+	uint32_t sign = (in.u >> 16) & 0x8000;
+	uint32_t x = in.u & 0x7FFFFFFF;
+
+	if(x >= 0x7F800000) //infinity or NaN
+		return (QMhalf)(sign | 0x7C00 | (x > 0x7F800000 ? 0x0200 | ((x >> 13) & 0x03FF) : 0));
+	if(x >= 0x477FF000) //rounds to above 65504
+		return (QMhalf)(sign | 0x7C00);
+
+	if(x < 0x38800000) //denormal, adding 0.5 lines the mantissa up with the half's and rounds it
 	{
-		invLen = 1.0f / invLen;
-		result.x = v.x * invLen;
-		result.y = v.y * invLen;
-		result.z = v.z * invLen;
+		denormal.u = x;
+		denormal.f += 0.5f;
+		return (QMhalf)(sign | (denormal.u - 0x3F000000));
 	}
 
-	return result;
+	//rebias the exponent, then round the 13 dropped bits to nearest even
+	x += 0xC8000FFF + ((x >> 13) & 1);
+	return (QMhalf)(sign | (x >> 13));
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_normalize)(QMvec4 v)
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(half_to_float)(QMhalf h)
 {
-	QMvec4 result = {0};
+	#if QM_USE_F16C
 
-	float len = QM_FUNC_PREFIX(vec4_length)(v);
-	if(len != 0.0f)
-	{
-		#if QM_USE_SSE
+	return _cvtsh_ss(h);
 
-		__m128 scale = _mm_set1_ps(len);
-		result.packed = _mm_div_ps(v.packed, scale);
+	#else
 
-		#else
+	union { float f; uint32_t u; } result;
+	result.u = (uint32_t)(h & 0x7FFF) << 13;
 
-		float invLen = 1.0f / len;
+	uint32_t exponent = result.u & 0x0F800000;
+	result.u += 0x38000000;
 
-		result.x = v.x * invLen;
-		result.y = v.y * invLen;
-		result.z = v.z * invLen;
-		result.w = v.w * invLen;
+	if(exponent == 0x0F800000) //infinity or NaN
+	{
+		result.u += 0x38000000;
+		if(result.u & 0x007FFFFF)
+			result.u |= 0x00400000;
+	}
+	else if(exponent == 0) //zero or denormal, renormalized by the fpu
+	{
+		union { float f; uint32_t u; } magic;
+		magic.u = 0x38800000;
 
-		#endif
+		result.u += 0x00800000;
+		result.f -= magic.f;
 	}
 
-	return result;
+	result.u |= (uint32_t)(h & 0x8000) << 16;
+	return result.f;
+
+	#endif
 }
 
-//distance:
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(float_to_half_array_scalar)(const float* in, QMhalf* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(float_to_half)(in[i]);
+}
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_distance)(QMvec2 v1, QMvec2 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(half_to_float_array_scalar)(const QMhalf* in, float* out, size_t count)
 {
-	float result;
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(half_to_float)(in[i]);
+}
 
-	QMvec2 to = QM_FUNC_PREFIX(vec2_sub)(v1, v2);
-	result = QM_FUNC_PREFIX(vec2_length)(to);
+#if QM_USE_SSE || QM_USE_DISPATCH
 
-	return result;
-}
+//the software conversions 4 at a time, with every case computed and selected by masks
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_distance)(QMvec3 v1, QMvec3 v2)
+QM_FUNC_ATTRIBS __m128i QM_FUNC_PREFIX(float_to_half_sse)(__m128 f)
 {
-	float result;
+	__m128i sign = _mm_and_si128(_mm_castps_si128(f), _mm_set1_epi32((int)0x80000000));
+	__m128i x = _mm_xor_si128(_mm_castps_si128(f), sign);
 
-	QMvec3 to = QM_FUNC_PREFIX(vec3_sub)(v1, v2);
-	result = QM_FUNC_PREFIX(vec3_length)(to);
+	//values from 65520 up to 2^16 already round to infinity through the normal path
+	__m128i overflow = _mm_cmpgt_epi32(x, _mm_set1_epi32(0x477FFFFF));
+	__m128i nan = _mm_cmpgt_epi32(x, _mm_set1_epi32(0x7F800000));
+	__m128i denormal = _mm_cmplt_epi32(x, _mm_set1_epi32(0x38800000));
 
-	return result;
+	__m128i odd = _mm_and_si128(_mm_srli_epi32(x, 13), _mm_set1_epi32(1));
+	__m128i normalResult = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32((int)0xC8000FFF)), odd), 13);
+	__m128i denormalResult = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(x), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3F000000));
+	__m128i nanResult = _mm_and_si128(nan, _mm_or_si128(_mm_set1_epi32(0x0200), _mm_and_si128(_mm_srli_epi32(x, 13), _mm_set1_epi32(0x03FF))));
+	__m128i overflowResult = _mm_or_si128(_mm_set1_epi32(0x7C00), nanResult);
+
+	__m128i result = _mm_or_si128(_mm_and_si128(denormal, denormalResult), _mm_andnot_si128(denormal, normalResult));
+	result = _mm_or_si128(_mm_and_si128(overflow, overflowResult), _mm_andnot_si128(overflow, result));
+
+	return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_distance)(QMvec4 v1, QMvec4 v2)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(half_to_float_sse)(__m128i h)
 {
-	float result;
+	__m128i bits = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+	__m128i result = _mm_add_epi32(_mm_slli_epi32(bits, 13), _mm_set1_epi32(0x38000000));
 
-	QMvec4 to = QM_FUNC_PREFIX(vec4_sub)(v1, v2);
-	result = QM_FUNC_PREFIX(vec4_length)(to);
+	__m128i infNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7BFF));
+	__m128i nan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7C00));
+	__m128i denormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(0x0400));
 
-	return result;
-}
+	result = _mm_add_epi32(result, _mm_and_si128(infNan, _mm_set1_epi32(0x38000000)));
+	result = _mm_or_si128(result, _mm_and_si128(nan, _mm_set1_epi32(0x00400000)));
 
-//equality:
+	__m128 denormalResult = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(result, _mm_set1_epi32(0x00800000))), _mm_castsi128_ps(_mm_set1_epi32(0x38800000)));
+	result = _mm_or_si128(_mm_and_si128(denormal, _mm_castps_si128(denormalResult)), _mm_andnot_si128(denormal, result));
 
-QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec2_equals)(QMvec2 v1, QMvec2 v2)
+	return _mm_castsi128_ps(_mm_or_si128(result, _mm_slli_epi32(_mm_xor_si128(h, bits), 16)));
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(float_to_half_array_sse)(const float* in, QMhalf* out, size_t count)
 {
-	QMbool result;
+	size_t i = 0;
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m128i low = QM_FUNC_PREFIX(float_to_half_sse)(_mm_loadu_ps(in + i));
+		__m128i high = QM_FUNC_PREFIX(float_to_half_sse)(_mm_loadu_ps(in + i + 4));
 
-	result = (v1.x == v2.x) && (v1.y == v2.y); 
+		//sign extend so the signed saturation of the pack keeps every bit
+		low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+		high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
 
-	return result;	
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(low, high));
+	}
+
+	QM_FUNC_PREFIX(float_to_half_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec3_equals)(QMvec3 v1, QMvec3 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(half_to_float_array_sse)(const QMhalf* in, float* out, size_t count)
 {
-	QMbool result;
+	size_t i = 0;
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m128i h = _mm_loadu_si128((const __m128i*)(in + i));
 
-	result = (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z); 
+		_mm_storeu_ps(out + i    , QM_FUNC_PREFIX(half_to_float_sse)(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+		_mm_storeu_ps(out + i + 4, QM_FUNC_PREFIX(half_to_float_sse)(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+	}
 
-	return result;	
+	QM_FUNC_PREFIX(half_to_float_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec4_equals)(QMvec4 v1, QMvec4 v2)
+#endif
+
+#if QM_USE_F16C || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_F16C void QM_FUNC_PREFIX(float_to_half_array_f16c)(const float* in, QMhalf* out, size_t count)
 {
-	QMbool result;
+	size_t i = 0;
+	for(; i < (count & ~(size_t)15); i += 16)
+	{
+		_mm_storeu_si128((__m128i*)(out + i    ), _mm256_cvtps_ph(_mm256_loadu_ps(in + i    ), _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128((__m128i*)(out + i + 8), _mm256_cvtps_ph(_mm256_loadu_ps(in + i + 8), _MM_FROUND_TO_NEAREST_INT));
+	}
 
-	//TODO: there are SIMD instructions for floating point equality, find a way to get a single bool from them
-	result = (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z) && (v1.w == v2.w); 
+	for(; i < count; i++)
+		out[i] = (QMhalf)_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(in[i]), _MM_FROUND_TO_NEAREST_INT), 0);
+}
 
-	return result;	
+QM_FUNC_ATTRIBS QM_TARGET_F16C void QM_FUNC_PREFIX(half_to_float_array_f16c)(const QMhalf* in, float* out, size_t count)
+{
+	size_t i = 0;
+	for(; i < (count & ~(size_t)15); i += 16)
+	{
+		_mm256_storeu_ps(out + i    , _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i    ))));
+		_mm256_storeu_ps(out + i + 8, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i + 8))));
+	}
+
+	for(; i < count; i++)
+		out[i] = _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(in[i])));
 }
 
-//min:
+#endif
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_min)(QMvec2 v1, QMvec2 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(float_to_half_array)(const float* in, QMhalf* out, size_t count)
 {
-	QMvec2 result;
+	#if QM_USE_DISPATCH
 
-	result.x = QM_MIN(v1.x, v2.x);
-	result.y = QM_MIN(v1.y, v2.y);
+	QM_FUNC_PREFIX(dispatch_table)()->float_to_half_array(in, out, count);
 
-	return result;
+	#elif QM_USE_F16C
+
+	QM_FUNC_PREFIX(float_to_half_array_f16c)(in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(float_to_half_array_sse)(in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(float_to_half_array_scalar)(in, out, count);
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_min)(QMvec3 v1, QMvec3 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(half_to_float_array)(const QMhalf* in, float* out, size_t count)
 {
-	QMvec3 result;
+	#if QM_USE_DISPATCH
 
-	result.x = QM_MIN(v1.x, v2.x);
-	result.y = QM_MIN(v1.y, v2.y);
-	result.z = QM_MIN(v1.z, v2.z);
+	QM_FUNC_PREFIX(dispatch_table)()->half_to_float_array(in, out, count);
 
-	return result;
+	#elif QM_USE_F16C
+
+	QM_FUNC_PREFIX(half_to_float_array_f16c)(in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(half_to_float_array_sse)(in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(half_to_float_array_scalar)(in, out, count);
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_min)(QMvec4 v1, QMvec4 v2)
+//----------------------------------------------------------------------//
+//TRIGONOMETRY FUNCTIONS:
+
+//polynomial approximations of sin, cos, tan, and acos that return 4 or 8 results at once. sin and cos reduce x by
+//multiples of pi/2 in 3 parts and evaluate minimax polynomials over [-pi/4, pi/4], their max error is 1 * 10^-7
+//absolute. the reduction is only exact enough for |x| <= QM_TRIG_REDUCTION_LIMIT, so larger values (and infinities
+//and NaNs) are passed to QM_SINF and QM_COSF instead, giving NaN for non-finite x. acos clamps x to [-1, 1], its max
+//error is 3 * 10^-7 absolute. tan is sin / cos, its max error is 3 * 10^-7 relative to the result away from its poles
+
+#define QM_TRIG_REDUCTION_LIMIT 8192.0f
+
+#define QM_TRIG_2_OVER_PI  0.636619772f
+#define QM_TRIG_PI_OVER_2A 1.5703125f
+#define QM_TRIG_PI_OVER_2B 4.837512969970703125e-4f
+#define QM_TRIG_PI_OVER_2C 7.54978995489188216e-8f
+
+//builds a QMvec4 in a register, a compound literal is built on the stack and stalls the SSE load that follows it
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_set)(float x, float y, float z, float w)
 {
 	QMvec4 result;
 
 	#if QM_USE_SSE
 
-	result.packed = _mm_min_ps(v1.packed, v2.packed);
+	result.packed = _mm_setr_ps(x, y, z, w);
 
 	#else
 
-	result.x = QM_MIN(v1.x, v2.x);
-	result.y = QM_MIN(v1.y, v2.y);
-	result.z = QM_MIN(v1.z, v2.z);
-	result.w = QM_MIN(v1.w, v2.w);
+	result = (QMvec4){ x, y, z, w };
 
 	#endif
 
 	return result;
 }
 
-//max:
+//computes the lanes in mask that are outside of the polynomials' range with the C runtime
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_max)(QMvec2 v1, QMvec2 v2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(sincos_fallback)(const float* x, float* s, float* c, int mask, int count)
 {
-	QMvec2 result;
+	for(int i = 0; i < count; i++)
+		if(mask & (1 << i))
+		{
+			s[i] = QM_SINF(x[i]);
+			c[i] = QM_COSF(x[i]);
+		}
+}
 
-	result.x = QM_MAX(v1.x, v2.x);
-	result.y = QM_MAX(v1.y, v2.y);
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(sincos_poly)(float x, float* s, float* c)
+{
+	//written so that NaN also fails the test, the quadrant conversion below is only defined for reduced-range x
+	if(!(QM_FUNC_PREFIX(absf)(x) <= QM_TRIG_REDUCTION_LIMIT))
+	{
+		*s = QM_SINF(x);
+		*c = QM_COSF(x);
+		return;
+	}
 
-	return result;
+	//the quadrant is picked with bit operations since it is unpredictable for arbitrary angles
+	union { float f; uint32_t u; } half, sine, cosine, sinResult, cosResult;
+
+	//round to the nearest quadrant, the SIMD paths round ties to even which only changes r's sign at +-pi/4
+	half.f = x;
+	half.u = (half.u & 0x80000000) | 0x3F000000;
+	int32_t quadrant = (int32_t)(x * QM_TRIG_2_OVER_PI + half.f);
+	float q = (float)quadrant;
+
+	float r = ((x - q * QM_TRIG_PI_OVER_2A) - q * QM_TRIG_PI_OVER_2B) - q * QM_TRIG_PI_OVER_2C;
+	float r2 = r * r;
+
+	sine.f   = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+	cosine.f = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+	uint32_t swap = 0u - ((uint32_t)quadrant & 1u);
+	sinResult.u = ((cosine.u & swap) | (sine.u & ~swap)) ^ (((uint32_t)quadrant & 2u) << 30);
+	cosResult.u = ((sine.u & swap) | (cosine.u & ~swap)) ^ (((uint32_t)(quadrant + 1) & 2u) << 30);
+
+	*s = sinResult.f;
+	*c = cosResult.f;
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_max)(QMvec3 v1, QMvec3 v2)
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(acos_poly)(float x)
 {
-	QMvec3 result;
+	x = QM_MIN(QM_MAX(x, -1.0f), 1.0f);
+	float absX = QM_FUNC_PREFIX(absf)(x);
 
-	result.x = QM_MAX(v1.x, v2.x);
-	result.y = QM_MAX(v1.y, v2.y);
-	result.z = QM_MAX(v1.z, v2.z);
+	//acos(x) = 2 * asin(sqrt((1 - x) / 2)) near 1, pi/2 - asin(x) elsewhere
+	QMbool big = absX > 0.5f;
+	float z = big ? 0.5f * (1.0f - absX) : absX * absX;
+	float s = big ? QM_SQRTF(z) : absX;
 
-	return result;
+	float asine = s + s * z * ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z + 7.4953002686e-2f) * z + 1.6666752422e-1f);
+
+	if(big)
+		return x > 0.0f ? 2.0f * asine : 3.14159265f - 2.0f * asine;
+	else
+		return x > 0.0f ? 1.57079633f - asine : 1.57079633f + asine;
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_max)(QMvec4 v1, QMvec4 v2)
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(sincos_sse)(__m128 x, __m128* s, __m128* c)
 {
-	QMvec4 result;
+	//lanes out of range (or NaN) are reduced as 0 so their quadrant converts cleanly, then replaced at the end
+	__m128 outside = _mm_cmpnle_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), _mm_set1_ps(QM_TRIG_REDUCTION_LIMIT));
+	__m128 in = x;
+	x = _mm_andnot_ps(outside, x);
 
-	#if QM_USE_SSE
+	__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(QM_TRIG_2_OVER_PI)));
+	__m128 q = _mm_cvtepi32_ps(quadrant);
 
-	result.packed = _mm_max_ps(v1.packed, v2.packed);
+	__m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(QM_TRIG_PI_OVER_2A)));
+	r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(QM_TRIG_PI_OVER_2B)));
+	r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(QM_TRIG_PI_OVER_2C)));
+	__m128 r2 = _mm_mul_ps(r, r);
 
-	#else
+	__m128 sine = QM_FUNC_PREFIX(fmadd_sse)(r2, _mm_set1_ps(-1.9515295891e-4f), _mm_set1_ps(8.3321608736e-3f));
+	sine = QM_FUNC_PREFIX(fmadd_sse)(sine, r2, _mm_set1_ps(-1.6666654611e-1f));
+	sine = QM_FUNC_PREFIX(fmadd_sse)(_mm_mul_ps(sine, r2), r, r);
 
-	result.x = QM_MAX(v1.x, v2.x);
-	result.y = QM_MAX(v1.y, v2.y);
-	result.z = QM_MAX(v1.z, v2.z);
-	result.w = QM_MAX(v1.w, v2.w);
+	__m128 cosine = QM_FUNC_PREFIX(fmadd_sse)(r2, _mm_set1_ps(2.443315711809948e-5f), _mm_set1_ps(-1.388731625493765e-3f));
+	cosine = QM_FUNC_PREFIX(fmadd_sse)(cosine, r2, _mm_set1_ps(4.166664568298827e-2f));
+	cosine = QM_FUNC_PREFIX(fmadd_sse)(_mm_mul_ps(cosine, r2), r2, _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))));
 
-	#endif
+	__m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+	__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+	__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+	__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
 
-	return result;
-}
+	*s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cosine), _mm_andnot_ps(swap, sine)), sinSign);
+	*c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sine), _mm_andnot_ps(swap, cosine)), cosSign);
 
-//----------------------------------------------------------------------//
-//MATRIX FUNCTIONS:
+	int mask = _mm_movemask_ps(outside);
+	if(mask)
+	{
+		float inLanes[4], sinLanes[4], cosLanes[4];
+		_mm_storeu_ps(inLanes, in);
+		_mm_storeu_ps(sinLanes, *s);
+		_mm_storeu_ps(cosLanes, *c);
 
-//loading:
+		QM_FUNC_PREFIX(sincos_fallback)(inLanes, sinLanes, cosLanes, mask, 4);
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_load)(const float* in)
-{
-	return (QMmat3){
-		in[0], in[1], in[2],
-		in[3], in[4], in[5],
-		in[6], in[7], in[8]
-	};
+		*s = _mm_loadu_ps(sinLanes);
+		*c = _mm_loadu_ps(cosLanes);
+	}
 }
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_load_row_major)(const float* in)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(acos_sse)(__m128 x)
 {
-	return (QMmat3){
-		in[0], in[3], in[6],
-		in[1], in[4], in[7],
-		in[2], in[5], in[8]
-	};
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+	__m128 signBit = _mm_set1_ps(-0.0f);
+	__m128 absX = _mm_andnot_ps(signBit, x);
+
+	__m128 big = _mm_cmpgt_ps(absX, _mm_set1_ps(0.5f));
+	__m128 zBig = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(1.0f), absX));
+	__m128 z = _mm_or_ps(_mm_and_ps(big, zBig), _mm_andnot_ps(big, _mm_mul_ps(absX, absX)));
+	__m128 s = _mm_or_ps(_mm_and_ps(big, _mm_sqrt_ps(zBig)), _mm_andnot_ps(big, absX));
+
+	__m128 poly = QM_FUNC_PREFIX(fmadd_sse)(_mm_set1_ps(4.2163199048e-2f), z, _mm_set1_ps(2.4181311049e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_sse)(poly, z, _mm_set1_ps(4.5470025998e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_sse)(poly, z, _mm_set1_ps(7.4953002686e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_sse)(poly, z, _mm_set1_ps(1.6666752422e-1f));
+	__m128 asine = QM_FUNC_PREFIX(fmadd_sse)(_mm_mul_ps(s, z), poly, s);
+
+	//big: 2 * asine, or pi - 2 * asine for negative x. otherwise pi/2 - asine with asine taking x's sign
+	__m128 negative = _mm_and_ps(signBit, x);
+	__m128 resultBig = _mm_add_ps(_mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_set1_ps(3.14159265f)), _mm_xor_ps(_mm_add_ps(asine, asine), negative));
+	__m128 resultSmall = _mm_sub_ps(_mm_set1_ps(1.57079633f), _mm_xor_ps(asine, negative));
+
+	return _mm_or_ps(_mm_and_ps(big, resultBig), _mm_andnot_ps(big, resultSmall));
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_load)(const float* in)
+#endif
+
+#if QM_USE_AVX || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX __m256 QM_FUNC_PREFIX(fmadd_avx)(__m256 a, __m256 b, __m256 c)
 {
-	return (QMmat4){
-		in[0 ], in[1 ], in[2 ], in[3 ],
-		in[4 ], in[5 ], in[6 ], in[7 ],
-		in[8 ], in[9 ], in[10], in[11],
-		in[12], in[13], in[14], in[15]
-	};
+	#if QM_USE_AVX2
+
+	return _mm256_fmadd_ps(a, b, c);
+
+	#else
+
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_load_row_major)(const float* in)
+QM_FUNC_ATTRIBS QM_TARGET_AVX void QM_FUNC_PREFIX(sincos_avx)(__m256 x, __m256* s, __m256* c)
 {
-	return (QMmat4){
-		in[0], in[4], in[8 ], in[12],
-		in[1], in[5], in[9 ], in[13],
-		in[2], in[6], in[10], in[14],
-		in[3], in[7], in[11], in[15]
-	};
-}
+	__m256 outside = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), x), _mm256_set1_ps(QM_TRIG_REDUCTION_LIMIT), _CMP_NLE_UQ);
+	__m256 in = x;
+	x = _mm256_andnot_ps(outside, x);
 
-//storing:
+	//AVX has no 256-bit integer ops, so the quadrant (q mod 4) is found with floats
+	__m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(QM_TRIG_2_OVER_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256 quadrant = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(q, _mm256_set1_ps(0.25f))), _mm256_set1_ps(4.0f)));
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat3_store)(QMmat3 m, float* out)
-{
-	out[0] = m.m[0][0];
-	out[1] = m.m[0][1];
-	out[2] = m.m[0][2];
+	__m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(QM_TRIG_PI_OVER_2A)));
+	r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(QM_TRIG_PI_OVER_2B)));
+	r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(QM_TRIG_PI_OVER_2C)));
+	__m256 r2 = _mm256_mul_ps(r, r);
 
-	out[3] = m.m[1][0];
-	out[4] = m.m[1][1];
-	out[5] = m.m[1][2];
+	__m256 sine = QM_FUNC_PREFIX(fmadd_avx)(r2, _mm256_set1_ps(-1.9515295891e-4f), _mm256_set1_ps(8.3321608736e-3f));
+	sine = QM_FUNC_PREFIX(fmadd_avx)(sine, r2, _mm256_set1_ps(-1.6666654611e-1f));
+	sine = QM_FUNC_PREFIX(fmadd_avx)(_mm256_mul_ps(sine, r2), r, r);
 
-	out[6] = m.m[2][0];
-	out[7] = m.m[2][1];
-	out[8] = m.m[2][2];
+	__m256 cosine = QM_FUNC_PREFIX(fmadd_avx)(r2, _mm256_set1_ps(2.443315711809948e-5f), _mm256_set1_ps(-1.388731625493765e-3f));
+	cosine = QM_FUNC_PREFIX(fmadd_avx)(cosine, r2, _mm256_set1_ps(4.166664568298827e-2f));
+	cosine = QM_FUNC_PREFIX(fmadd_avx)(_mm256_mul_ps(cosine, r2), r2, _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))));
+
+	__m256 signBit = _mm256_set1_ps(-0.0f);
+	__m256 one = _mm256_cmp_ps(quadrant, _mm256_set1_ps(1.0f), _CMP_EQ_OQ);
+	__m256 swap = _mm256_or_ps(one, _mm256_cmp_ps(quadrant, _mm256_set1_ps(3.0f), _CMP_EQ_OQ));
+	__m256 sinSign = _mm256_and_ps(_mm256_cmp_ps(quadrant, _mm256_set1_ps(2.0f), _CMP_GE_OQ), signBit);
+	__m256 cosSign = _mm256_and_ps(_mm256_or_ps(one, _mm256_cmp_ps(quadrant, _mm256_set1_ps(2.0f), _CMP_EQ_OQ)), signBit);
+
+	*s = _mm256_xor_ps(_mm256_blendv_ps(sine, cosine, swap), sinSign);
+	*c = _mm256_xor_ps(_mm256_blendv_ps(cosine, sine, swap), cosSign);
+
+	int mask = _mm256_movemask_ps(outside);
+	if(mask)
+	{
+		float inLanes[8], sinLanes[8], cosLanes[8];
+		_mm256_storeu_ps(inLanes, in);
+		_mm256_storeu_ps(sinLanes, *s);
+		_mm256_storeu_ps(cosLanes, *c);
+
+		QM_FUNC_PREFIX(sincos_fallback)(inLanes, sinLanes, cosLanes, mask, 8);
+
+		*s = _mm256_loadu_ps(sinLanes);
+		*c = _mm256_loadu_ps(cosLanes);
+	}
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat3_store_row_major)(QMmat3 m, float* out)
+QM_FUNC_ATTRIBS QM_TARGET_AVX __m256 QM_FUNC_PREFIX(acos_avx)(__m256 x)
 {
-	out[0] = m.m[0][0];
-	out[1] = m.m[1][0];
-	out[2] = m.m[2][0];
+	x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+	__m256 signBit = _mm256_set1_ps(-0.0f);
+	__m256 absX = _mm256_andnot_ps(signBit, x);
 
-	out[3] = m.m[0][1];
-	out[4] = m.m[1][1];
-	out[5] = m.m[2][1];
+	__m256 big = _mm256_cmp_ps(absX, _mm256_set1_ps(0.5f), _CMP_GT_OQ);
+	__m256 zBig = _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_sub_ps(_mm256_set1_ps(1.0f), absX));
+	__m256 z = _mm256_blendv_ps(_mm256_mul_ps(absX, absX), zBig, big);
+	__m256 s = _mm256_blendv_ps(absX, _mm256_sqrt_ps(zBig), big);
 
-	out[6] = m.m[0][2];
-	out[7] = m.m[1][2];
-	out[8] = m.m[2][2];
+	__m256 poly = QM_FUNC_PREFIX(fmadd_avx)(_mm256_set1_ps(4.2163199048e-2f), z, _mm256_set1_ps(2.4181311049e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_avx)(poly, z, _mm256_set1_ps(4.5470025998e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_avx)(poly, z, _mm256_set1_ps(7.4953002686e-2f));
+	poly = QM_FUNC_PREFIX(fmadd_avx)(poly, z, _mm256_set1_ps(1.6666752422e-1f));
+	__m256 asine = QM_FUNC_PREFIX(fmadd_avx)(_mm256_mul_ps(s, z), poly, s);
+
+	__m256 negative = _mm256_and_ps(signBit, x);
+	__m256 resultBig = _mm256_add_ps(_mm256_and_ps(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(3.14159265f)), _mm256_xor_ps(_mm256_add_ps(asine, asine), negative));
+	__m256 resultSmall = _mm256_sub_ps(_mm256_set1_ps(1.57079633f), _mm256_xor_ps(asine, negative));
+
+	return _mm256_blendv_ps(resultSmall, resultBig, big);
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_store)(QMmat4 m, float* out)
+#endif
+
+//sine and cosine:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_sincos)(QMvec4 v, QMvec4* s, QMvec4* c)
 {
-	out[0] = m.m[0][0];
-	out[1] = m.m[0][1];
-	out[2] = m.m[0][2];
-	out[3] = m.m[0][3];
+	#if QM_USE_SSE
 
-	out[4] = m.m[1][0];
-	out[5] = m.m[1][1];
-	out[6] = m.m[1][2];
-	out[7] = m.m[1][3];
+	QM_FUNC_PREFIX(sincos_sse)(v.packed, &s->packed, &c->packed);
 
-	out[ 8] = m.m[2][0];
-	out[ 9] = m.m[2][1];
-	out[10] = m.m[2][2];
-	out[11] = m.m[2][3];
+	#else
 
-	out[12] = m.m[3][0];
-	out[13] = m.m[3][1];
-	out[14] = m.m[3][2];
-	out[15] = m.m[3][3];
+	for(int i = 0; i < 4; i++)
+		QM_FUNC_PREFIX(sincos_poly)(v.v[i], &s->v[i], &c->v[i]);
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_store_row_major)(QMmat4 m, float* out)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec8_sincos)(QMvec8 v, QMvec8* s, QMvec8* c)
 {
-	out[0] = m.m[0][0];
-	out[1] = m.m[1][0];
-	out[2] = m.m[2][0];
-	out[3] = m.m[3][0];
+	#if QM_USE_AVX
 
-	out[4] = m.m[0][1];
-	out[5] = m.m[1][1];
-	out[6] = m.m[2][1];
-	out[7] = m.m[3][1];
+	QM_FUNC_PREFIX(sincos_avx)(v.packed, &s->packed, &c->packed);
 
-	out[ 8] = m.m[0][2];
-	out[ 9] = m.m[1][2];
-	out[10] = m.m[2][2];
-	out[11] = m.m[3][2];
+	#else
 
-	out[12] = m.m[0][3];
-	out[13] = m.m[1][3];
-	out[14] = m.m[2][3];
-	out[15] = m.m[3][3];
-}
+	for(int i = 0; i < 8; i++)
+		QM_FUNC_PREFIX(sincos_poly)(v.v[i], &s->v[i], &c->v[i]);
 
-//initialization:
+	#endif
+}
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_identity)()
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_sin)(QMvec4 v)
 {
-	QMmat3 result = {
-		1.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 1.0f
-	};
+	QMvec4 s, c;
+	QM_FUNC_PREFIX(vec4_sincos)(v, &s, &c);
 
-	return result;
+	return s;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_identity)()
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec8_sin)(QMvec8 v)
 {
-	QMmat4 result = {
-		1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f
-	};
+	QMvec8 s, c;
+	QM_FUNC_PREFIX(vec8_sincos)(v, &s, &c);
 
-	return result;
+	return s;
 }
 
-//addition:
-
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_add)(QMmat3 m1, QMmat3 m2)
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_cos)(QMvec4 v)
 {
-	QMmat3 result;
+	QMvec4 s, c;
+	QM_FUNC_PREFIX(vec4_sincos)(v, &s, &c);
 
-	result.m[0][0] = m1.m[0][0] + m2.m[0][0];
-	result.m[0][1] = m1.m[0][1] + m2.m[0][1];
-	result.m[0][2] = m1.m[0][2] + m2.m[0][2];
-	result.m[1][0] = m1.m[1][0] + m2.m[1][0];
-	result.m[1][1] = m1.m[1][1] + m2.m[1][1];
-	result.m[1][2] = m1.m[1][2] + m2.m[1][2];
-	result.m[2][0] = m1.m[2][0] + m2.m[2][0];
-	result.m[2][1] = m1.m[2][1] + m2.m[2][1];
-	result.m[2][2] = m1.m[2][2] + m2.m[2][2];
+	return c;
+}
 
-	return result;
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec8_cos)(QMvec8 v)
+{
+	QMvec8 s, c;
+	QM_FUNC_PREFIX(vec8_sincos)(v, &s, &c);
+
+	return c;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_add)(QMmat4 m1, QMmat4 m2)
+//tangent:
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_tan)(QMvec4 v)
 {
-	QMmat4 result;
+	QMvec4 result;
+
+	QMvec4 s, c;
+	QM_FUNC_PREFIX(vec4_sincos)(v, &s, &c);
 
 	#if QM_USE_SSE
 
-	result.packed[0] = _mm_add_ps(m1.packed[0], m2.packed[0]);
-	result.packed[1] = _mm_add_ps(m1.packed[1], m2.packed[1]);
-	result.packed[2] = _mm_add_ps(m1.packed[2], m2.packed[2]);
-	result.packed[3] = _mm_add_ps(m1.packed[3], m2.packed[3]);
+	result.packed = _mm_div_ps(s.packed, c.packed);
 
 	#else
 
-	result.m[0][0] = m1.m[0][0] + m2.m[0][0];
-	result.m[0][1] = m1.m[0][1] + m2.m[0][1];
-	result.m[0][2] = m1.m[0][2] + m2.m[0][2];
-	result.m[0][3] = m1.m[0][3] + m2.m[0][3];
-	result.m[1][0] = m1.m[1][0] + m2.m[1][0];
-	result.m[1][1] = m1.m[1][1] + m2.m[1][1];
-	result.m[1][2] = m1.m[1][2] + m2.m[1][2];
-	result.m[1][3] = m1.m[1][3] + m2.m[1][3];
-	result.m[2][0] = m1.m[2][0] + m2.m[2][0];
-	result.m[2][1] = m1.m[2][1] + m2.m[2][1];
-	result.m[2][2] = m1.m[2][2] + m2.m[2][2];
-	result.m[2][3] = m1.m[2][3] + m2.m[2][3];
-	result.m[3][0] = m1.m[3][0] + m2.m[3][0];
-	result.m[3][1] = m1.m[3][1] + m2.m[3][1];
-	result.m[3][2] = m1.m[3][2] + m2.m[3][2];
-	result.m[3][3] = m1.m[3][3] + m2.m[3][3];
+	for(int i = 0; i < 4; i++)
+		result.v[i] = s.v[i] / c.v[i];
 
 	#endif
 
 	return result;
 }
 
-//subtraction:
-
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_sub)(QMmat3 m1, QMmat3 m2)
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec8_tan)(QMvec8 v)
 {
-	QMmat3 result;
+	QMvec8 result;
 
-	result.m[0][0] = m1.m[0][0] - m2.m[0][0];
-	result.m[0][1] = m1.m[0][1] - m2.m[0][1];
-	result.m[0][2] = m1.m[0][2] - m2.m[0][2];
-	result.m[1][0] = m1.m[1][0] - m2.m[1][0];
-	result.m[1][1] = m1.m[1][1] - m2.m[1][1];
-	result.m[1][2] = m1.m[1][2] - m2.m[1][2];
-	result.m[2][0] = m1.m[2][0] - m2.m[2][0];
-	result.m[2][1] = m1.m[2][1] - m2.m[2][1];
-	result.m[2][2] = m1.m[2][2] - m2.m[2][2];
+	QMvec8 s, c;
+	QM_FUNC_PREFIX(vec8_sincos)(v, &s, &c);
+
+	#if QM_USE_AVX
+
+	result.packed = _mm256_div_ps(s.packed, c.packed);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+		result.v[i] = s.v[i] / c.v[i];
+
+	#endif
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_sub)(QMmat4 m1, QMmat4 m2)
+//arccosine:
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_acos)(QMvec4 v)
 {
-	QMmat4 result;
+	QMvec4 result;
 
 	#if QM_USE_SSE
 
-	result.packed[0] = _mm_sub_ps(m1.packed[0], m2.packed[0]);
-	result.packed[1] = _mm_sub_ps(m1.packed[1], m2.packed[1]);
-	result.packed[2] = _mm_sub_ps(m1.packed[2], m2.packed[2]);
-	result.packed[3] = _mm_sub_ps(m1.packed[3], m2.packed[3]);
+	result.packed = QM_FUNC_PREFIX(acos_sse)(v.packed);
 
 	#else
 
-	result.m[0][0] = m1.m[0][0] - m2.m[0][0];
-	result.m[0][1] = m1.m[0][1] - m2.m[0][1];
-	result.m[0][2] = m1.m[0][2] - m2.m[0][2];
-	result.m[0][3] = m1.m[0][3] - m2.m[0][3];
-	result.m[1][0] = m1.m[1][0] - m2.m[1][0];
-	result.m[1][1] = m1.m[1][1] - m2.m[1][1];
-	result.m[1][2] = m1.m[1][2] - m2.m[1][2];
-	result.m[1][3] = m1.m[1][3] - m2.m[1][3];
-	result.m[2][0] = m1.m[2][0] - m2.m[2][0];
-	result.m[2][1] = m1.m[2][1] - m2.m[2][1];
-	result.m[2][2] = m1.m[2][2] - m2.m[2][2];
-	result.m[2][3] = m1.m[2][3] - m2.m[2][3];
-	result.m[3][0] = m1.m[3][0] - m2.m[3][0];
-	result.m[3][1] = m1.m[3][1] - m2.m[3][1];
-	result.m[3][2] = m1.m[3][2] - m2.m[3][2];
-	result.m[3][3] = m1.m[3][3] - m2.m[3][3];
+	for(int i = 0; i < 4; i++)
+		result.v[i] = QM_FUNC_PREFIX(acos_poly)(v.v[i]);
 
 	#endif
 
 	return result;
 }
 
-//multiplication:
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec8_acos)(QMvec8 v)
+{
+	QMvec8 result;
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_mult)(QMmat3 m1, QMmat3 m2)
+	#if QM_USE_AVX
+
+	result.packed = QM_FUNC_PREFIX(acos_avx)(v.packed);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+		result.v[i] = QM_FUNC_PREFIX(acos_poly)(v.v[i]);
+
+	#endif
+
+	return result;
+}
+
+//----------------------------------------------------------------------//
+//VECTOR FUNCTIONS:
+
+//loading:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_load)(const float* in)
 {
-	QMmat3 result;
+	return (QMvec2){ in[0], in[1] };
+}
 
-	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[1][0] * m2.m[0][1] + m1.m[2][0] * m2.m[0][2];
-	result.m[0][1] = m1.m[0][1] * m2.m[0][0] + m1.m[1][1] * m2.m[0][1] + m1.m[2][1] * m2.m[0][2];
-	result.m[0][2] = m1.m[0][2] * m2.m[0][0] + m1.m[1][2] * m2.m[0][1] + m1.m[2][2] * m2.m[0][2];
-	result.m[1][0] = m1.m[0][0] * m2.m[1][0] + m1.m[1][0] * m2.m[1][1] + m1.m[2][0] * m2.m[1][2];
-	result.m[1][1] = m1.m[0][1] * m2.m[1][0] + m1.m[1][1] * m2.m[1][1] + m1.m[2][1] * m2.m[1][2];
-	result.m[1][2] = m1.m[0][2] * m2.m[1][0] + m1.m[1][2] * m2.m[1][1] + m1.m[2][2] * m2.m[1][2];
-	result.m[2][0] = m1.m[0][0] * m2.m[2][0] + m1.m[1][0] * m2.m[2][1] + m1.m[2][0] * m2.m[2][2];
-	result.m[2][1] = m1.m[0][1] * m2.m[2][0] + m1.m[1][1] * m2.m[2][1] + m1.m[2][1] * m2.m[2][2];
-	result.m[2][2] = m1.m[0][2] * m2.m[2][0] + m1.m[1][2] * m2.m[2][1] + m1.m[2][2] * m2.m[2][2];
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_load)(const float* in)
+{
+	return (QMvec3){ in[0], in[1], in[2] };
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_load)(const float* in)
+{
+	return (QMvec4){ in[0], in[1], in[2], in[3] };
+}
+
+//storing:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec2_store)(QMvec2 v, float* out)
+{
+	out[0] = v.x;
+	out[1] = v.y;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_store)(QMvec3 v, float* out)
+{
+	out[0] = v.x;
+	out[1] = v.y;
+	out[2] = v.z;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_store)(QMvec4 v, float* out)
+{
+	out[0] = v.x;
+	out[1] = v.y;
+	out[2] = v.z;
+	out[3] = v.w;
+}
+
+//half precision loading and storing:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_load_half)(const QMhalf* in)
+{
+	return (QMvec2){ QM_FUNC_PREFIX(half_to_float)(in[0]), QM_FUNC_PREFIX(half_to_float)(in[1]) };
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_load_half)(const QMhalf* in)
+{
+	return (QMvec3){ QM_FUNC_PREFIX(half_to_float)(in[0]), QM_FUNC_PREFIX(half_to_float)(in[1]), QM_FUNC_PREFIX(half_to_float)(in[2]) };
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_load_half)(const QMhalf* in)
+{
+	QMvec4 result;
+
+	#if QM_USE_F16C
+
+	result.packed = _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)in));
+
+	#else
+
+	result.x = QM_FUNC_PREFIX(half_to_float)(in[0]);
+	result.y = QM_FUNC_PREFIX(half_to_float)(in[1]);
+	result.z = QM_FUNC_PREFIX(half_to_float)(in[2]);
+	result.w = QM_FUNC_PREFIX(half_to_float)(in[3]);
+
+	#endif
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_mult)(QMmat4 m1, QMmat4 m2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec2_store_half)(QMvec2 v, QMhalf* out)
 {
-	QMmat4 result;
+	out[0] = QM_FUNC_PREFIX(float_to_half)(v.x);
+	out[1] = QM_FUNC_PREFIX(float_to_half)(v.y);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_store_half)(QMvec3 v, QMhalf* out)
+{
+	out[0] = QM_FUNC_PREFIX(float_to_half)(v.x);
+	out[1] = QM_FUNC_PREFIX(float_to_half)(v.y);
+	out[2] = QM_FUNC_PREFIX(float_to_half)(v.z);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_store_half)(QMvec4 v, QMhalf* out)
+{
+	#if QM_USE_F16C
+
+	_mm_storel_epi64((__m128i*)out, _mm_cvtps_ph(v.packed, _MM_FROUND_TO_NEAREST_INT));
+
+	#else
+
+	out[0] = QM_FUNC_PREFIX(float_to_half)(v.x);
+	out[1] = QM_FUNC_PREFIX(float_to_half)(v.y);
+	out[2] = QM_FUNC_PREFIX(float_to_half)(v.z);
+	out[3] = QM_FUNC_PREFIX(float_to_half)(v.w);
+
+	#endif
+}
+
+//full:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_full)(float val)
+{
+	return (QMvec2){ val, val };
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_full)(float val)
+{
+	return (QMvec3){ val, val, val };
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_full)(float val)
+{
+	return (QMvec4){ val, val, val, val };
+}
+
+//addition:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_add)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_add)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+	result.z = v1.z + v2.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_add)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
 
 	#if QM_USE_SSE
 
-	result.packed[0] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[0], m1);
-	result.packed[1] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[1], m1);
-	result.packed[2] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[2], m1);
-	result.packed[3] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[3], m1);
+	result.packed = _mm_add_ps(v1.packed, v2.packed);
 
 	#else
 
-	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[1][0] * m2.m[0][1] + m1.m[2][0] * m2.m[0][2] + m1.m[3][0] * m2.m[0][3];
-	result.m[0][1] = m1.m[0][1] * m2.m[0][0] + m1.m[1][1] * m2.m[0][1] + m1.m[2][1] * m2.m[0][2] + m1.m[3][1] * m2.m[0][3];
-	result.m[0][2] = m1.m[0][2] * m2.m[0][0] + m1.m[1][2] * m2.m[0][1] + m1.m[2][2] * m2.m[0][2] + m1.m[3][2] * m2.m[0][3];
-	result.m[0][3] = m1.m[0][3] * m2.m[0][0] + m1.m[1][3] * m2.m[0][1] + m1.m[2][3] * m2.m[0][2] + m1.m[3][3] * m2.m[0][3];
-	result.m[1][0] = m1.m[0][0] * m2.m[1][0] + m1.m[1][0] * m2.m[1][1] + m1.m[2][0] * m2.m[1][2] + m1.m[3][0] * m2.m[1][3];
-	result.m[1][1] = m1.m[0][1] * m2.m[1][0] + m1.m[1][1] * m2.m[1][1] + m1.m[2][1] * m2.m[1][2] + m1.m[3][1] * m2.m[1][3];
-	result.m[1][2] = m1.m[0][2] * m2.m[1][0] + m1.m[1][2] * m2.m[1][1] + m1.m[2][2] * m2.m[1][2] + m1.m[3][2] * m2.m[1][3];
-	result.m[1][3] = m1.m[0][3] * m2.m[1][0] + m1.m[1][3] * m2.m[1][1] + m1.m[2][3] * m2.m[1][2] + m1.m[3][3] * m2.m[1][3];
-	result.m[2][0] = m1.m[0][0] * m2.m[2][0] + m1.m[1][0] * m2.m[2][1] + m1.m[2][0] * m2.m[2][2] + m1.m[3][0] * m2.m[2][3];
-	result.m[2][1] = m1.m[0][1] * m2.m[2][0] + m1.m[1][1] * m2.m[2][1] + m1.m[2][1] * m2.m[2][2] + m1.m[3][1] * m2.m[2][3];
-	result.m[2][2] = m1.m[0][2] * m2.m[2][0] + m1.m[1][2] * m2.m[2][1] + m1.m[2][2] * m2.m[2][2] + m1.m[3][2] * m2.m[2][3];
-	result.m[2][3] = m1.m[0][3] * m2.m[2][0] + m1.m[1][3] * m2.m[2][1] + m1.m[2][3] * m2.m[2][2] + m1.m[3][3] * m2.m[2][3];
-	result.m[3][0] = m1.m[0][0] * m2.m[3][0] + m1.m[1][0] * m2.m[3][1] + m1.m[2][0] * m2.m[3][2] + m1.m[3][0] * m2.m[3][3];
-	result.m[3][1] = m1.m[0][1] * m2.m[3][0] + m1.m[1][1] * m2.m[3][1] + m1.m[2][1] * m2.m[3][2] + m1.m[3][1] * m2.m[3][3];
-	result.m[3][2] = m1.m[0][2] * m2.m[3][0] + m1.m[1][2] * m2.m[3][1] + m1.m[2][2] * m2.m[3][2] + m1.m[3][2] * m2.m[3][3];
-	result.m[3][3] = m1.m[0][3] * m2.m[3][0] + m1.m[1][3] * m2.m[3][1] + m1.m[2][3] * m2.m[3][2] + m1.m[3][3] * m2.m[3][3];
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+	result.z = v1.z + v2.z;
+	result.w = v1.w + v2.w;
 
 	#endif
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(mat3_mult_vec3)(QMmat3 m, QMvec3 v)
+//subtraction:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_sub)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_sub)(QMvec3 v1, QMvec3 v2)
 {
 	QMvec3 result;
 
-	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z;
-	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z;
-	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z;
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+	result.z = v1.z - v2.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_sub)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_sub_ps(v1.packed, v2.packed);
+
+	#else
+
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+	result.z = v1.z - v2.z;
+	result.w = v1.w - v2.w;
+
+	#endif
+
+	return result;
+}
+
+//multiplication:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_mult)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = v1.x * v2.x;
+	result.y = v1.y * v2.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_mult)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = v1.x * v2.x;
+	result.y = v1.y * v2.y;
+	result.z = v1.z * v2.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_mult)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_mul_ps(v1.packed, v2.packed);
+
+	#else
+
+	result.x = v1.x * v2.x;
+	result.y = v1.y * v2.y;
+	result.z = v1.z * v2.z;
+	result.w = v1.w * v2.w;
+
+	#endif
+
+	return result;
+}
+
+//division:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_div)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = v1.x / v2.x;
+	result.y = v1.y / v2.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_div)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = v1.x / v2.x;
+	result.y = v1.y / v2.y;
+	result.z = v1.z / v2.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_div)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_div_ps(v1.packed, v2.packed);
+
+	#else
+
+	result.x = v1.x / v2.x;
+	result.y = v1.y / v2.y;
+	result.z = v1.z / v2.z;
+	result.w = v1.w / v2.w;
+
+	#endif
+
+	return result;
+}
+
+//scalar multiplication:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_scale)(QMvec2 v, float s)
+{
+	QMvec2 result;
+
+	result.x = v.x * s;
+	result.y = v.y * s;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_scale)(QMvec3 v, float s)
+{
+	QMvec3 result;
+
+	result.x = v.x * s;
+	result.y = v.y * s;
+	result.z = v.z * s;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_scale)(QMvec4 v, float s)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	__m128 scale = _mm_set1_ps(s);
+	result.packed = _mm_mul_ps(v.packed, scale);
+
+	#else
+
+	result.x = v.x * s;
+	result.y = v.y * s;
+	result.z = v.z * s;
+	result.w = v.w * s;
+
+	#endif
+
+	return result;
+}
+
+//dot product:
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_dot)(QMvec2 v1, QMvec2 v2)
+{
+	float result;
+
+	result = v1.x * v2.x + v1.y * v2.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_dot)(QMvec3 v1, QMvec3 v2)
+{
+	float result;
+
+	result = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_dot)(QMvec4 v1, QMvec4 v2)
+{
+	float result;
+
+	#if QM_USE_AVX2
+
+	_mm_store_ss(&result, _mm_dp_ps(v1.packed, v2.packed, 0xF1));
+
+	#elif QM_USE_SSE
+
+	__m128 r = _mm_mul_ps(v1.packed, v2.packed);
+	r = _mm_hadd_ps(r, r);
+	r = _mm_hadd_ps(r, r);
+	_mm_store_ss(&result, r);
+
+	#else
+
+	result = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+
+	#endif
+
+	return result;
+}
+
+//batch dot product (out[i] = dot(v1[i], v2[i])):
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_dot_array_scalar)(const QMvec4* v1, const QMvec4* v2, float* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = v1[i].x * v2[i].x + v1[i].y * v2[i].y + v1[i].z * v2[i].z + v1[i].w * v2[i].w;
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_dot_array_sse)(const QMvec4* v1, const QMvec4* v2, float* out, size_t count)
+{
+	size_t i = 0;
+
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 p0 = _mm_mul_ps(_mm_loadu_ps(v1[i    ].v), _mm_loadu_ps(v2[i    ].v));
+		__m128 p1 = _mm_mul_ps(_mm_loadu_ps(v1[i + 1].v), _mm_loadu_ps(v2[i + 1].v));
+		__m128 p2 = _mm_mul_ps(_mm_loadu_ps(v1[i + 2].v), _mm_loadu_ps(v2[i + 2].v));
+		__m128 p3 = _mm_mul_ps(_mm_loadu_ps(v1[i + 3].v), _mm_loadu_ps(v2[i + 3].v));
+
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		_mm_storeu_ps(&out[i], _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+	}
+
+	QM_FUNC_PREFIX(vec4_dot_array_scalar)(v1 + i, v2 + i, out + i, count - i);
+}
+
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(vec4_dot_array_avx512)(const QMvec4* v1, const QMvec4* v2, float* out, size_t count)
+{
+	//16 dot products per iteration, the 4 products in each 128-bit lane are summed with a transpose
+	__m512i order = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+	for(size_t i = 0; i < count; i += 16)
+	{
+		size_t numFloats = (count - i) * 4;
+		const float* f1 = v1[i].v;
+		const float* f2 = v2[i].v;
+
+		__m512 p[4];
+		for(int j = 0; j < 4; j++)
+		{
+			__mmask16 mask = QM_FUNC_PREFIX(mask16_avx512)(numFloats > (size_t)j * 16 ? numFloats - j * 16 : 0);
+			p[j] = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, f1 + j * 16), _mm512_maskz_loadu_ps(mask, f2 + j * 16));
+		}
+
+		__m512 s0 = _mm512_add_ps(_mm512_unpacklo_ps(p[0], p[1]), _mm512_unpackhi_ps(p[0], p[1]));
+		__m512 s1 = _mm512_add_ps(_mm512_unpacklo_ps(p[2], p[3]), _mm512_unpackhi_ps(p[2], p[3]));
+		__m512 sum = _mm512_add_ps(_mm512_shuffle_ps(s0, s1, _MM_SHUFFLE(1, 0, 1, 0)), _mm512_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 2, 3, 2)));
+
+		_mm512_mask_storeu_ps(&out[i], QM_FUNC_PREFIX(mask16_avx512)(count - i), _mm512_permutexvar_ps(order, sum));
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec4_dot_array)(const QMvec4* v1, const QMvec4* v2, float* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->vec4_dot_array(v1, v2, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(vec4_dot_array_avx512)(v1, v2, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec4_dot_array_sse)(v1, v2, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(vec4_dot_array_scalar)(v1, v2, out, count);
+
+	#endif
+}
+
+//cross product
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_cross)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = (v1.y * v2.z) - (v1.z * v2.y);
+	result.y = (v1.z * v2.x) - (v1.x * v2.z);
+	result.z = (v1.x * v2.y) - (v1.y * v2.x);
+
+	return result;
+}
+
+//length:
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_length)(QMvec2 v)
+{
+	float result;
+
+	result = QM_SQRTF(QM_FUNC_PREFIX(vec2_dot)(v, v));
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_length)(QMvec3 v)
+{
+	float result;
+
+	result = QM_SQRTF(QM_FUNC_PREFIX(vec3_dot)(v, v));
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_length)(QMvec4 v)
+{
+	float result;
+
+	result = QM_SQRTF(QM_FUNC_PREFIX(vec4_dot)(v, v));
+
+	return result;
+}
+
+//normalize:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_normalize)(QMvec2 v)
+{
+	QMvec2 result = {0};
+
+	float invLen = QM_FUNC_PREFIX(vec2_length)(v);
+	if(invLen != 0.0f)
+	{
+		invLen = 1.0f / invLen;
+		result.x = v.x * invLen;
+		result.y = v.y * invLen;
+	}
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_normalize)(QMvec3 v)
+{
+	QMvec3 result = {0};
+
+	float invLen = QM_FUNC_PREFIX(vec3_length)(v);
+	if(invLen != 0.0f)
+	{
+		invLen = 1.0f / invLen;
+		result.x = v.x * invLen;
+		result.y = v.y * invLen;
+		result.z = v.z * invLen;
+	}
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_normalize)(QMvec4 v)
+{
+	QMvec4 result = {0};
+
+	float len = QM_FUNC_PREFIX(vec4_length)(v);
+	if(len != 0.0f)
+	{
+		#if QM_USE_SSE
+
+		__m128 scale = _mm_set1_ps(len);
+		result.packed = _mm_div_ps(v.packed, scale);
+
+		#else
+
+		float invLen = 1.0f / len;
+
+		result.x = v.x * invLen;
+		result.y = v.y * invLen;
+		result.z = v.z * invLen;
+		result.w = v.w * invLen;
+
+		#endif
+	}
+
+	return result;
+}
+
+//distance:
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec2_distance)(QMvec2 v1, QMvec2 v2)
+{
+	float result;
+
+	QMvec2 to = QM_FUNC_PREFIX(vec2_sub)(v1, v2);
+	result = QM_FUNC_PREFIX(vec2_length)(to);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec3_distance)(QMvec3 v1, QMvec3 v2)
+{
+	float result;
+
+	QMvec3 to = QM_FUNC_PREFIX(vec3_sub)(v1, v2);
+	result = QM_FUNC_PREFIX(vec3_length)(to);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(vec4_distance)(QMvec4 v1, QMvec4 v2)
+{
+	float result;
+
+	QMvec4 to = QM_FUNC_PREFIX(vec4_sub)(v1, v2);
+	result = QM_FUNC_PREFIX(vec4_length)(to);
+
+	return result;
+}
+
+//equality:
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec2_equals)(QMvec2 v1, QMvec2 v2)
+{
+	QMbool result;
+
+	result = (v1.x == v2.x) && (v1.y == v2.y); 
+
+	return result;	
+}
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec3_equals)(QMvec3 v1, QMvec3 v2)
+{
+	QMbool result;
+
+	result = (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z); 
+
+	return result;	
+}
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(vec4_equals)(QMvec4 v1, QMvec4 v2)
+{
+	QMbool result;
+
+	//TODO: there are SIMD instructions for floating point equality, find a way to get a single bool from them
+	result = (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z) && (v1.w == v2.w); 
+
+	return result;	
+}
+
+//min:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_min)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = QM_MIN(v1.x, v2.x);
+	result.y = QM_MIN(v1.y, v2.y);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_min)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = QM_MIN(v1.x, v2.x);
+	result.y = QM_MIN(v1.y, v2.y);
+	result.z = QM_MIN(v1.z, v2.z);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_min)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_min_ps(v1.packed, v2.packed);
+
+	#else
+
+	result.x = QM_MIN(v1.x, v2.x);
+	result.y = QM_MIN(v1.y, v2.y);
+	result.z = QM_MIN(v1.z, v2.z);
+	result.w = QM_MIN(v1.w, v2.w);
+
+	#endif
+
+	return result;
+}
+
+//max:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(vec2_max)(QMvec2 v1, QMvec2 v2)
+{
+	QMvec2 result;
+
+	result.x = QM_MAX(v1.x, v2.x);
+	result.y = QM_MAX(v1.y, v2.y);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_max)(QMvec3 v1, QMvec3 v2)
+{
+	QMvec3 result;
+
+	result.x = QM_MAX(v1.x, v2.x);
+	result.y = QM_MAX(v1.y, v2.y);
+	result.z = QM_MAX(v1.z, v2.z);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec4_max)(QMvec4 v1, QMvec4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_max_ps(v1.packed, v2.packed);
+
+	#else
+
+	result.x = QM_MAX(v1.x, v2.x);
+	result.y = QM_MAX(v1.y, v2.y);
+	result.z = QM_MAX(v1.z, v2.z);
+	result.w = QM_MAX(v1.w, v2.w);
+
+	#endif
+
+	return result;
+}
+
+//----------------------------------------------------------------------//
+//WIDE VECTOR FUNCTIONS:
+
+//loading/storing (transposes to/from an array of 4 QMvec3s):
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_load)(const QMvec3* in)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec3_load4_sse)(in, &result.packed[0], &result.packed[1], &result.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = in[i].x;
+		result.y[i] = in[i].y;
+		result.z[i] = in[i].z;
+	}
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3x4_store)(QMvec3x4 v, QMvec3* out)
+{
+	#if QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec3_store4_sse)(v.packed[0], v.packed[1], v.packed[2], out);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		out[i].x = v.x[i];
+		out[i].y = v.y[i];
+		out[i].z = v.z[i];
+	}
+
+	#endif
+}
+
+//full:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_full)(QMvec3 v)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_set1_ps(v.x);
+	result.packed[1] = _mm_set1_ps(v.y);
+	result.packed[2] = _mm_set1_ps(v.z);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v.x;
+		result.y[i] = v.y;
+		result.z[i] = v.z;
+	}
+
+	#endif
+
+	return result;
+}
+
+//addition:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_add)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_add_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_add_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_add_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v1.x[i] + v2.x[i];
+		result.y[i] = v1.y[i] + v2.y[i];
+		result.z[i] = v1.z[i] + v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//subtraction:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_sub)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_sub_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_sub_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_sub_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v1.x[i] - v2.x[i];
+		result.y[i] = v1.y[i] - v2.y[i];
+		result.z[i] = v1.z[i] - v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//multiplication:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_mult)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_mul_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_mul_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_mul_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v1.x[i] * v2.x[i];
+		result.y[i] = v1.y[i] * v2.y[i];
+		result.z[i] = v1.z[i] * v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//division:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_div)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_div_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_div_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_div_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v1.x[i] / v2.x[i];
+		result.y[i] = v1.y[i] / v2.y[i];
+		result.z[i] = v1.z[i] / v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//scalar multiplication:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_scale)(QMvec3x4 v, float s)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	__m128 scale = _mm_set1_ps(s);
+	result.packed[0] = _mm_mul_ps(v.packed[0], scale);
+	result.packed[1] = _mm_mul_ps(v.packed[1], scale);
+	result.packed[2] = _mm_mul_ps(v.packed[2], scale);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = v.x[i] * s;
+		result.y[i] = v.y[i] * s;
+		result.z[i] = v.z[i] * s;
+	}
+
+	#endif
+
+	return result;
+}
+
+//dot product:
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec3x4_dot)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_mul_ps(v1.packed[0], v2.packed[0]);
+	result.packed = _mm_add_ps(result.packed, _mm_mul_ps(v1.packed[1], v2.packed[1]));
+	result.packed = _mm_add_ps(result.packed, _mm_mul_ps(v1.packed[2], v2.packed[2]));
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+		result.v[i] = v1.x[i] * v2.x[i] + v1.y[i] * v2.y[i] + v1.z[i] * v2.z[i];
+
+	#endif
+
+	return result;
+}
+
+//cross product:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_cross)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_sub_ps(_mm_mul_ps(v1.packed[1], v2.packed[2]), _mm_mul_ps(v1.packed[2], v2.packed[1]));
+	result.packed[1] = _mm_sub_ps(_mm_mul_ps(v1.packed[2], v2.packed[0]), _mm_mul_ps(v1.packed[0], v2.packed[2]));
+	result.packed[2] = _mm_sub_ps(_mm_mul_ps(v1.packed[0], v2.packed[1]), _mm_mul_ps(v1.packed[1], v2.packed[0]));
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = (v1.y[i] * v2.z[i]) - (v1.z[i] * v2.y[i]);
+		result.y[i] = (v1.z[i] * v2.x[i]) - (v1.x[i] * v2.z[i]);
+		result.z[i] = (v1.x[i] * v2.y[i]) - (v1.y[i] * v2.x[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//length:
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec3x4_length)(QMvec3x4 v)
+{
+	QMvec4 result = QM_FUNC_PREFIX(vec3x4_dot)(v, v);
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_sqrt_ps(result.packed);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+		result.v[i] = QM_SQRTF(result.v[i]);
+
+	#endif
+
+	return result;
+}
+
+//normalize:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_normalize)(QMvec3x4 v)
+{
+	QMvec3x4 result;
+
+	QMvec4 len = QM_FUNC_PREFIX(vec3x4_length)(v);
+
+	#if QM_USE_SSE
+
+	//lanes with a length of 0 are set to 0, same as vec3_normalize
+	__m128 zero = _mm_setzero_ps();
+	__m128 nonzero = _mm_cmpneq_ps(len.packed, zero);
+	__m128 invLen = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), len.packed), nonzero);
+
+	result.packed[0] = _mm_mul_ps(v.packed[0], invLen);
+	result.packed[1] = _mm_mul_ps(v.packed[1], invLen);
+	result.packed[2] = _mm_mul_ps(v.packed[2], invLen);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		float invLen = len.v[i] != 0.0f ? 1.0f / len.v[i] : 0.0f;
+
+		result.x[i] = v.x[i] * invLen;
+		result.y[i] = v.y[i] * invLen;
+		result.z[i] = v.z[i] * invLen;
+	}
+
+	#endif
+
+	return result;
+}
+
+//distance:
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(vec3x4_distance)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec4 result;
+
+	QMvec3x4 to = QM_FUNC_PREFIX(vec3x4_sub)(v1, v2);
+	result = QM_FUNC_PREFIX(vec3x4_length)(to);
+
+	return result;
+}
+
+//min:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_min)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_min_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_min_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_min_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = QM_MIN(v1.x[i], v2.x[i]);
+		result.y[i] = QM_MIN(v1.y[i], v2.y[i]);
+		result.z[i] = QM_MIN(v1.z[i], v2.z[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//max:
+
+QM_FUNC_ATTRIBS QMvec3x4 QM_FUNC_PREFIX(vec3x4_max)(QMvec3x4 v1, QMvec3x4 v2)
+{
+	QMvec3x4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_max_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm_max_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm_max_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+	{
+		result.x[i] = QM_MAX(v1.x[i], v2.x[i]);
+		result.y[i] = QM_MAX(v1.y[i], v2.y[i]);
+		result.z[i] = QM_MAX(v1.z[i], v2.z[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//loading/storing (transposes to/from an array of 8 QMvec3s):
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_load)(const QMvec3* in)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	__m128 x0, y0, z0, x1, y1, z1;
+	QM_FUNC_PREFIX(vec3_load4_sse)(in    , &x0, &y0, &z0);
+	QM_FUNC_PREFIX(vec3_load4_sse)(in + 4, &x1, &y1, &z1);
+
+	result.packed[0] = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+	result.packed[1] = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+	result.packed[2] = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = in[i].x;
+		result.y[i] = in[i].y;
+		result.z[i] = in[i].z;
+	}
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3x8_store)(QMvec3x8 v, QMvec3* out)
+{
+	#if QM_USE_AVX
+
+	QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_castps256_ps128(v.packed[0]), _mm256_castps256_ps128(v.packed[1]), _mm256_castps256_ps128(v.packed[2]), out);
+	QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_extractf128_ps(v.packed[0], 1), _mm256_extractf128_ps(v.packed[1], 1), _mm256_extractf128_ps(v.packed[2], 1), out + 4);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		out[i].x = v.x[i];
+		out[i].y = v.y[i];
+		out[i].z = v.z[i];
+	}
+
+	#endif
+}
+
+//full:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_full)(QMvec3 v)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_set1_ps(v.x);
+	result.packed[1] = _mm256_set1_ps(v.y);
+	result.packed[2] = _mm256_set1_ps(v.z);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v.x;
+		result.y[i] = v.y;
+		result.z[i] = v.z;
+	}
+
+	#endif
+
+	return result;
+}
+
+//addition:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_add)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_add_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_add_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_add_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v1.x[i] + v2.x[i];
+		result.y[i] = v1.y[i] + v2.y[i];
+		result.z[i] = v1.z[i] + v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//subtraction:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_sub)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_sub_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_sub_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_sub_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v1.x[i] - v2.x[i];
+		result.y[i] = v1.y[i] - v2.y[i];
+		result.z[i] = v1.z[i] - v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//multiplication:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_mult)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_mul_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_mul_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_mul_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v1.x[i] * v2.x[i];
+		result.y[i] = v1.y[i] * v2.y[i];
+		result.z[i] = v1.z[i] * v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//division:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_div)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_div_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_div_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_div_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v1.x[i] / v2.x[i];
+		result.y[i] = v1.y[i] / v2.y[i];
+		result.z[i] = v1.z[i] / v2.z[i];
+	}
+
+	#endif
+
+	return result;
+}
+
+//scalar multiplication:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_scale)(QMvec3x8 v, float s)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	__m256 scale = _mm256_set1_ps(s);
+	result.packed[0] = _mm256_mul_ps(v.packed[0], scale);
+	result.packed[1] = _mm256_mul_ps(v.packed[1], scale);
+	result.packed[2] = _mm256_mul_ps(v.packed[2], scale);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = v.x[i] * s;
+		result.y[i] = v.y[i] * s;
+		result.z[i] = v.z[i] * s;
+	}
+
+	#endif
+
+	return result;
+}
+
+//dot product:
+
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec3x8_dot)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec8 result;
+
+	#if QM_USE_AVX
+
+	result.packed = _mm256_mul_ps(v1.packed[0], v2.packed[0]);
+	result.packed = _mm256_add_ps(result.packed, _mm256_mul_ps(v1.packed[1], v2.packed[1]));
+	result.packed = _mm256_add_ps(result.packed, _mm256_mul_ps(v1.packed[2], v2.packed[2]));
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+		result.v[i] = v1.x[i] * v2.x[i] + v1.y[i] * v2.y[i] + v1.z[i] * v2.z[i];
+
+	#endif
+
+	return result;
+}
+
+//cross product:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_cross)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_sub_ps(_mm256_mul_ps(v1.packed[1], v2.packed[2]), _mm256_mul_ps(v1.packed[2], v2.packed[1]));
+	result.packed[1] = _mm256_sub_ps(_mm256_mul_ps(v1.packed[2], v2.packed[0]), _mm256_mul_ps(v1.packed[0], v2.packed[2]));
+	result.packed[2] = _mm256_sub_ps(_mm256_mul_ps(v1.packed[0], v2.packed[1]), _mm256_mul_ps(v1.packed[1], v2.packed[0]));
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = (v1.y[i] * v2.z[i]) - (v1.z[i] * v2.y[i]);
+		result.y[i] = (v1.z[i] * v2.x[i]) - (v1.x[i] * v2.z[i]);
+		result.z[i] = (v1.x[i] * v2.y[i]) - (v1.y[i] * v2.x[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//length:
+
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec3x8_length)(QMvec3x8 v)
+{
+	QMvec8 result = QM_FUNC_PREFIX(vec3x8_dot)(v, v);
+
+	#if QM_USE_AVX
+
+	result.packed = _mm256_sqrt_ps(result.packed);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+		result.v[i] = QM_SQRTF(result.v[i]);
+
+	#endif
+
+	return result;
+}
+
+//normalize:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_normalize)(QMvec3x8 v)
+{
+	QMvec3x8 result;
+
+	QMvec8 len = QM_FUNC_PREFIX(vec3x8_length)(v);
+
+	#if QM_USE_AVX
+
+	//lanes with a length of 0 are set to 0, same as vec3_normalize
+	__m256 zero = _mm256_setzero_ps();
+	__m256 nonzero = _mm256_cmp_ps(len.packed, zero, _CMP_NEQ_UQ);
+	__m256 invLen = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), len.packed), nonzero);
+
+	result.packed[0] = _mm256_mul_ps(v.packed[0], invLen);
+	result.packed[1] = _mm256_mul_ps(v.packed[1], invLen);
+	result.packed[2] = _mm256_mul_ps(v.packed[2], invLen);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		float invLen = len.v[i] != 0.0f ? 1.0f / len.v[i] : 0.0f;
+
+		result.x[i] = v.x[i] * invLen;
+		result.y[i] = v.y[i] * invLen;
+		result.z[i] = v.z[i] * invLen;
+	}
+
+	#endif
+
+	return result;
+}
+
+//distance:
+
+QM_FUNC_ATTRIBS QMvec8 QM_FUNC_PREFIX(vec3x8_distance)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec8 result;
+
+	QMvec3x8 to = QM_FUNC_PREFIX(vec3x8_sub)(v1, v2);
+	result = QM_FUNC_PREFIX(vec3x8_length)(to);
+
+	return result;
+}
+
+//min:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_min)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_min_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_min_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_min_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = QM_MIN(v1.x[i], v2.x[i]);
+		result.y[i] = QM_MIN(v1.y[i], v2.y[i]);
+		result.z[i] = QM_MIN(v1.z[i], v2.z[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//max:
+
+QM_FUNC_ATTRIBS QMvec3x8 QM_FUNC_PREFIX(vec3x8_max)(QMvec3x8 v1, QMvec3x8 v2)
+{
+	QMvec3x8 result;
+
+	#if QM_USE_AVX
+
+	result.packed[0] = _mm256_max_ps(v1.packed[0], v2.packed[0]);
+	result.packed[1] = _mm256_max_ps(v1.packed[1], v2.packed[1]);
+	result.packed[2] = _mm256_max_ps(v1.packed[2], v2.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+	{
+		result.x[i] = QM_MAX(v1.x[i], v2.x[i]);
+		result.y[i] = QM_MAX(v1.y[i], v2.y[i]);
+		result.z[i] = QM_MAX(v1.z[i], v2.z[i]);
+	}
+
+	#endif
+
+	return result;
+}
+
+//----------------------------------------------------------------------//
+//MATRIX FUNCTIONS:
+
+//loading:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_load)(const float* in)
+{
+	return (QMmat3){
+		in[0], in[1], in[2],
+		in[3], in[4], in[5],
+		in[6], in[7], in[8]
+	};
+}
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_load_row_major)(const float* in)
+{
+	return (QMmat3){
+		in[0], in[3], in[6],
+		in[1], in[4], in[7],
+		in[2], in[5], in[8]
+	};
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_load)(const float* in)
+{
+	return (QMmat4){
+		in[0 ], in[1 ], in[2 ], in[3 ],
+		in[4 ], in[5 ], in[6 ], in[7 ],
+		in[8 ], in[9 ], in[10], in[11],
+		in[12], in[13], in[14], in[15]
+	};
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_load_row_major)(const float* in)
+{
+	return (QMmat4){
+		in[0], in[4], in[8 ], in[12],
+		in[1], in[5], in[9 ], in[13],
+		in[2], in[6], in[10], in[14],
+		in[3], in[7], in[11], in[15]
+	};
+}
+
+//storing:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat3_store)(QMmat3 m, float* out)
+{
+	out[0] = m.m[0][0];
+	out[1] = m.m[0][1];
+	out[2] = m.m[0][2];
+
+	out[3] = m.m[1][0];
+	out[4] = m.m[1][1];
+	out[5] = m.m[1][2];
+
+	out[6] = m.m[2][0];
+	out[7] = m.m[2][1];
+	out[8] = m.m[2][2];
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat3_store_row_major)(QMmat3 m, float* out)
+{
+	out[0] = m.m[0][0];
+	out[1] = m.m[1][0];
+	out[2] = m.m[2][0];
+
+	out[3] = m.m[0][1];
+	out[4] = m.m[1][1];
+	out[5] = m.m[2][1];
+
+	out[6] = m.m[0][2];
+	out[7] = m.m[1][2];
+	out[8] = m.m[2][2];
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_store)(QMmat4 m, float* out)
+{
+	out[0] = m.m[0][0];
+	out[1] = m.m[0][1];
+	out[2] = m.m[0][2];
+	out[3] = m.m[0][3];
+
+	out[4] = m.m[1][0];
+	out[5] = m.m[1][1];
+	out[6] = m.m[1][2];
+	out[7] = m.m[1][3];
+
+	out[ 8] = m.m[2][0];
+	out[ 9] = m.m[2][1];
+	out[10] = m.m[2][2];
+	out[11] = m.m[2][3];
+
+	out[12] = m.m[3][0];
+	out[13] = m.m[3][1];
+	out[14] = m.m[3][2];
+	out[15] = m.m[3][3];
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_store_row_major)(QMmat4 m, float* out)
+{
+	out[0] = m.m[0][0];
+	out[1] = m.m[1][0];
+	out[2] = m.m[2][0];
+	out[3] = m.m[3][0];
+
+	out[4] = m.m[0][1];
+	out[5] = m.m[1][1];
+	out[6] = m.m[2][1];
+	out[7] = m.m[3][1];
+
+	out[ 8] = m.m[0][2];
+	out[ 9] = m.m[1][2];
+	out[10] = m.m[2][2];
+	out[11] = m.m[3][2];
+
+	out[12] = m.m[0][3];
+	out[13] = m.m[1][3];
+	out[14] = m.m[2][3];
+	out[15] = m.m[3][3];
+}
+
+//half precision loading and storing (column major, like mat_load and mat_store):
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_load_half)(const QMhalf* in)
+{
+	QMmat3 result;
+
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			result.m[i][j] = QM_FUNC_PREFIX(half_to_float)(in[i * 3 + j]);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_load_half)(const QMhalf* in)
+{
+	QMmat4 result;
+
+	#if QM_USE_F16C
+
+	_mm256_storeu_ps(result.m[0], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)in      )));
+	_mm256_storeu_ps(result.m[2], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + 8))));
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			result.m[i][j] = QM_FUNC_PREFIX(half_to_float)(in[i * 4 + j]);
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat3_store_half)(QMmat3 m, QMhalf* out)
+{
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			out[i * 3 + j] = QM_FUNC_PREFIX(float_to_half)(m.m[i][j]);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_store_half)(QMmat4 m, QMhalf* out)
+{
+	#if QM_USE_F16C
+
+	_mm_storeu_si128((__m128i*)out      , _mm256_cvtps_ph(_mm256_loadu_ps(m.m[0]), _MM_FROUND_TO_NEAREST_INT));
+	_mm_storeu_si128((__m128i*)(out + 8), _mm256_cvtps_ph(_mm256_loadu_ps(m.m[2]), _MM_FROUND_TO_NEAREST_INT));
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			out[i * 4 + j] = QM_FUNC_PREFIX(float_to_half)(m.m[i][j]);
+
+	#endif
+}
+
+//initialization:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_identity)()
+{
+	QMmat3 result = {
+		1.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 1.0f
+	};
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_identity)()
+{
+	QMmat4 result = {
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+
+	return result;
+}
+
+//addition:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_add)(QMmat3 m1, QMmat3 m2)
+{
+	QMmat3 result;
+
+	result.m[0][0] = m1.m[0][0] + m2.m[0][0];
+	result.m[0][1] = m1.m[0][1] + m2.m[0][1];
+	result.m[0][2] = m1.m[0][2] + m2.m[0][2];
+	result.m[1][0] = m1.m[1][0] + m2.m[1][0];
+	result.m[1][1] = m1.m[1][1] + m2.m[1][1];
+	result.m[1][2] = m1.m[1][2] + m2.m[1][2];
+	result.m[2][0] = m1.m[2][0] + m2.m[2][0];
+	result.m[2][1] = m1.m[2][1] + m2.m[2][1];
+	result.m[2][2] = m1.m[2][2] + m2.m[2][2];
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_add)(QMmat4 m1, QMmat4 m2)
+{
+	QMmat4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_add_ps(m1.packed[0], m2.packed[0]);
+	result.packed[1] = _mm_add_ps(m1.packed[1], m2.packed[1]);
+	result.packed[2] = _mm_add_ps(m1.packed[2], m2.packed[2]);
+	result.packed[3] = _mm_add_ps(m1.packed[3], m2.packed[3]);
+
+	#else
+
+	result.m[0][0] = m1.m[0][0] + m2.m[0][0];
+	result.m[0][1] = m1.m[0][1] + m2.m[0][1];
+	result.m[0][2] = m1.m[0][2] + m2.m[0][2];
+	result.m[0][3] = m1.m[0][3] + m2.m[0][3];
+	result.m[1][0] = m1.m[1][0] + m2.m[1][0];
+	result.m[1][1] = m1.m[1][1] + m2.m[1][1];
+	result.m[1][2] = m1.m[1][2] + m2.m[1][2];
+	result.m[1][3] = m1.m[1][3] + m2.m[1][3];
+	result.m[2][0] = m1.m[2][0] + m2.m[2][0];
+	result.m[2][1] = m1.m[2][1] + m2.m[2][1];
+	result.m[2][2] = m1.m[2][2] + m2.m[2][2];
+	result.m[2][3] = m1.m[2][3] + m2.m[2][3];
+	result.m[3][0] = m1.m[3][0] + m2.m[3][0];
+	result.m[3][1] = m1.m[3][1] + m2.m[3][1];
+	result.m[3][2] = m1.m[3][2] + m2.m[3][2];
+	result.m[3][3] = m1.m[3][3] + m2.m[3][3];
+
+	#endif
+
+	return result;
+}
+
+//subtraction:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_sub)(QMmat3 m1, QMmat3 m2)
+{
+	QMmat3 result;
+
+	result.m[0][0] = m1.m[0][0] - m2.m[0][0];
+	result.m[0][1] = m1.m[0][1] - m2.m[0][1];
+	result.m[0][2] = m1.m[0][2] - m2.m[0][2];
+	result.m[1][0] = m1.m[1][0] - m2.m[1][0];
+	result.m[1][1] = m1.m[1][1] - m2.m[1][1];
+	result.m[1][2] = m1.m[1][2] - m2.m[1][2];
+	result.m[2][0] = m1.m[2][0] - m2.m[2][0];
+	result.m[2][1] = m1.m[2][1] - m2.m[2][1];
+	result.m[2][2] = m1.m[2][2] - m2.m[2][2];
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_sub)(QMmat4 m1, QMmat4 m2)
+{
+	QMmat4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = _mm_sub_ps(m1.packed[0], m2.packed[0]);
+	result.packed[1] = _mm_sub_ps(m1.packed[1], m2.packed[1]);
+	result.packed[2] = _mm_sub_ps(m1.packed[2], m2.packed[2]);
+	result.packed[3] = _mm_sub_ps(m1.packed[3], m2.packed[3]);
+
+	#else
+
+	result.m[0][0] = m1.m[0][0] - m2.m[0][0];
+	result.m[0][1] = m1.m[0][1] - m2.m[0][1];
+	result.m[0][2] = m1.m[0][2] - m2.m[0][2];
+	result.m[0][3] = m1.m[0][3] - m2.m[0][3];
+	result.m[1][0] = m1.m[1][0] - m2.m[1][0];
+	result.m[1][1] = m1.m[1][1] - m2.m[1][1];
+	result.m[1][2] = m1.m[1][2] - m2.m[1][2];
+	result.m[1][3] = m1.m[1][3] - m2.m[1][3];
+	result.m[2][0] = m1.m[2][0] - m2.m[2][0];
+	result.m[2][1] = m1.m[2][1] - m2.m[2][1];
+	result.m[2][2] = m1.m[2][2] - m2.m[2][2];
+	result.m[2][3] = m1.m[2][3] - m2.m[2][3];
+	result.m[3][0] = m1.m[3][0] - m2.m[3][0];
+	result.m[3][1] = m1.m[3][1] - m2.m[3][1];
+	result.m[3][2] = m1.m[3][2] - m2.m[3][2];
+	result.m[3][3] = m1.m[3][3] - m2.m[3][3];
+
+	#endif
+
+	return result;
+}
+
+//multiplication:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_mult)(QMmat3 m1, QMmat3 m2)
+{
+	QMmat3 result;
+
+	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[1][0] * m2.m[0][1] + m1.m[2][0] * m2.m[0][2];
+	result.m[0][1] = m1.m[0][1] * m2.m[0][0] + m1.m[1][1] * m2.m[0][1] + m1.m[2][1] * m2.m[0][2];
+	result.m[0][2] = m1.m[0][2] * m2.m[0][0] + m1.m[1][2] * m2.m[0][1] + m1.m[2][2] * m2.m[0][2];
+	result.m[1][0] = m1.m[0][0] * m2.m[1][0] + m1.m[1][0] * m2.m[1][1] + m1.m[2][0] * m2.m[1][2];
+	result.m[1][1] = m1.m[0][1] * m2.m[1][0] + m1.m[1][1] * m2.m[1][1] + m1.m[2][1] * m2.m[1][2];
+	result.m[1][2] = m1.m[0][2] * m2.m[1][0] + m1.m[1][2] * m2.m[1][1] + m1.m[2][2] * m2.m[1][2];
+	result.m[2][0] = m1.m[0][0] * m2.m[2][0] + m1.m[1][0] * m2.m[2][1] + m1.m[2][0] * m2.m[2][2];
+	result.m[2][1] = m1.m[0][1] * m2.m[2][0] + m1.m[1][1] * m2.m[2][1] + m1.m[2][1] * m2.m[2][2];
+	result.m[2][2] = m1.m[0][2] * m2.m[2][0] + m1.m[1][2] * m2.m[2][1] + m1.m[2][2] * m2.m[2][2];
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_mult)(QMmat4 m1, QMmat4 m2)
+{
+	QMmat4 result;
+
+	#if QM_USE_AVX2
+
+	_mm256_storeu_ps(result.m[0], QM_FUNC_PREFIX(mat4_mult_column2_avx)(_mm256_loadu_ps(m2.m[0]), m1));
+	_mm256_storeu_ps(result.m[2], QM_FUNC_PREFIX(mat4_mult_column2_avx)(_mm256_loadu_ps(m2.m[2]), m1));
+
+	#elif QM_USE_SSE
+
+	result.packed[0] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[0], m1);
+	result.packed[1] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[1], m1);
+	result.packed[2] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[2], m1);
+	result.packed[3] = QM_FUNC_PREFIX(mat4_mult_column_sse)(m2.packed[3], m1);
+
+	#else
+
+	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[1][0] * m2.m[0][1] + m1.m[2][0] * m2.m[0][2] + m1.m[3][0] * m2.m[0][3];
+	result.m[0][1] = m1.m[0][1] * m2.m[0][0] + m1.m[1][1] * m2.m[0][1] + m1.m[2][1] * m2.m[0][2] + m1.m[3][1] * m2.m[0][3];
+	result.m[0][2] = m1.m[0][2] * m2.m[0][0] + m1.m[1][2] * m2.m[0][1] + m1.m[2][2] * m2.m[0][2] + m1.m[3][2] * m2.m[0][3];
+	result.m[0][3] = m1.m[0][3] * m2.m[0][0] + m1.m[1][3] * m2.m[0][1] + m1.m[2][3] * m2.m[0][2] + m1.m[3][3] * m2.m[0][3];
+	result.m[1][0] = m1.m[0][0] * m2.m[1][0] + m1.m[1][0] * m2.m[1][1] + m1.m[2][0] * m2.m[1][2] + m1.m[3][0] * m2.m[1][3];
+	result.m[1][1] = m1.m[0][1] * m2.m[1][0] + m1.m[1][1] * m2.m[1][1] + m1.m[2][1] * m2.m[1][2] + m1.m[3][1] * m2.m[1][3];
+	result.m[1][2] = m1.m[0][2] * m2.m[1][0] + m1.m[1][2] * m2.m[1][1] + m1.m[2][2] * m2.m[1][2] + m1.m[3][2] * m2.m[1][3];
+	result.m[1][3] = m1.m[0][3] * m2.m[1][0] + m1.m[1][3] * m2.m[1][1] + m1.m[2][3] * m2.m[1][2] + m1.m[3][3] * m2.m[1][3];
+	result.m[2][0] = m1.m[0][0] * m2.m[2][0] + m1.m[1][0] * m2.m[2][1] + m1.m[2][0] * m2.m[2][2] + m1.m[3][0] * m2.m[2][3];
+	result.m[2][1] = m1.m[0][1] * m2.m[2][0] + m1.m[1][1] * m2.m[2][1] + m1.m[2][1] * m2.m[2][2] + m1.m[3][1] * m2.m[2][3];
+	result.m[2][2] = m1.m[0][2] * m2.m[2][0] + m1.m[1][2] * m2.m[2][1] + m1.m[2][2] * m2.m[2][2] + m1.m[3][2] * m2.m[2][3];
+	result.m[2][3] = m1.m[0][3] * m2.m[2][0] + m1.m[1][3] * m2.m[2][1] + m1.m[2][3] * m2.m[2][2] + m1.m[3][3] * m2.m[2][3];
+	result.m[3][0] = m1.m[0][0] * m2.m[3][0] + m1.m[1][0] * m2.m[3][1] + m1.m[2][0] * m2.m[3][2] + m1.m[3][0] * m2.m[3][3];
+	result.m[3][1] = m1.m[0][1] * m2.m[3][0] + m1.m[1][1] * m2.m[3][1] + m1.m[2][1] * m2.m[3][2] + m1.m[3][1] * m2.m[3][3];
+	result.m[3][2] = m1.m[0][2] * m2.m[3][0] + m1.m[1][2] * m2.m[3][1] + m1.m[2][2] * m2.m[3][2] + m1.m[3][2] * m2.m[3][3];
+	result.m[3][3] = m1.m[0][3] * m2.m[3][0] + m1.m[1][3] * m2.m[3][1] + m1.m[2][3] * m2.m[3][2] + m1.m[3][3] * m2.m[3][3];
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(mat3_mult_vec3)(QMmat3 m, QMvec3 v)
+{
+	QMvec3 result;
+
+	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z;
+	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z;
+	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(mat4_mult_vec4)(QMmat4 m, QMvec4 v)
+{
+	QMvec4 result;
+
+	#if QM_USE_SSE
+
+	result.packed = QM_FUNC_PREFIX(mat4_mult_column_sse)(v.packed, m);
+
+	#else
+
+	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z + m.m[3][0] * v.w;
+	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z + m.m[3][1] * v.w;
+	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z + m.m[3][2] * v.w;
+	result.w = m.m[0][3] * v.x + m.m[1][3] * v.y + m.m[2][3] * v.z + m.m[3][3] * v.w;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(mat4_transform_vec3)(QMmat4 m, QMvec3 v)
+{
+	QMvec3 result;
+
+	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z + m.m[3][0];
+	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z + m.m[3][1];
+	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z + m.m[3][2];
+
+	return result;	
+}
+
+//array multiplication:
+
+//out[i] = m * in[i] and out[i] = m1[i] * m2[i]. out may be the same array as any input. the SIMD kernels keep
+//the shared matrix in registers and prefetch QM_PREFETCH_DISTANCE matrices ahead, stopping at the end of the arrays
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array_scalar)(const QMmat4* m, const QMmat4* in, QMmat4* out, size_t count)
+{
+	QMmat4 a = *m; //local copy, otherwise every store to out forces m to be reloaded
+
+	for(size_t i = 0; i < count; i++)
+	for(int j = 0; j < 4; j++)
+	{
+		const float* c = in[i].m[j];
+
+		float r0 = a.m[0][0] * c[0] + a.m[1][0] * c[1] + a.m[2][0] * c[2] + a.m[3][0] * c[3];
+		float r1 = a.m[0][1] * c[0] + a.m[1][1] * c[1] + a.m[2][1] * c[2] + a.m[3][1] * c[3];
+		float r2 = a.m[0][2] * c[0] + a.m[1][2] * c[1] + a.m[2][2] * c[2] + a.m[3][2] * c[3];
+		float r3 = a.m[0][3] * c[0] + a.m[1][3] * c[1] + a.m[2][3] * c[2] + a.m[3][3] * c[3];
+
+		out[i].m[j][0] = r0;
+		out[i].m[j][1] = r1;
+		out[i].m[j][2] = r2;
+		out[i].m[j][3] = r3;
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array_pairwise_scalar)(const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		QMmat4 m = m1[i];
+		QM_FUNC_PREFIX(mat4_mult_array_scalar)(&m, &m2[i], &out[i], 1);
+	}
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array_sse)(const QMmat4* m, const QMmat4* in, QMmat4* out, size_t count)
+{
+	__m128 c0 = _mm_loadu_ps(m->m[0]);
+	__m128 c1 = _mm_loadu_ps(m->m[1]);
+	__m128 c2 = _mm_loadu_ps(m->m[2]);
+	__m128 c3 = _mm_loadu_ps(m->m[3]);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+			_mm_prefetch((const char*)(in + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+
+		_mm_storeu_ps(out[i].m[0], QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(in[i].m[0]), c0, c1, c2, c3));
+		_mm_storeu_ps(out[i].m[1], QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(in[i].m[1]), c0, c1, c2, c3));
+		_mm_storeu_ps(out[i].m[2], QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(in[i].m[2]), c0, c1, c2, c3));
+		_mm_storeu_ps(out[i].m[3], QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(in[i].m[3]), c0, c1, c2, c3));
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array_pairwise_sse)(const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+		{
+			_mm_prefetch((const char*)(m1 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+			_mm_prefetch((const char*)(m2 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+		}
+
+		__m128 c0 = _mm_loadu_ps(m1[i].m[0]);
+		__m128 c1 = _mm_loadu_ps(m1[i].m[1]);
+		__m128 c2 = _mm_loadu_ps(m1[i].m[2]);
+		__m128 c3 = _mm_loadu_ps(m1[i].m[3]);
+
+		__m128 r0 = QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(m2[i].m[0]), c0, c1, c2, c3);
+		__m128 r1 = QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(m2[i].m[1]), c0, c1, c2, c3);
+		__m128 r2 = QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(m2[i].m[2]), c0, c1, c2, c3);
+		__m128 r3 = QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(m2[i].m[3]), c0, c1, c2, c3);
+
+		_mm_storeu_ps(out[i].m[0], r0);
+		_mm_storeu_ps(out[i].m[1], r1);
+		_mm_storeu_ps(out[i].m[2], r2);
+		_mm_storeu_ps(out[i].m[3], r3);
+	}
+}
+
+#endif
+
+#if QM_USE_AVX2 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(mat4_mult_array_avx2)(const QMmat4* m, const QMmat4* in, QMmat4* out, size_t count)
+{
+	__m256 c0 = _mm256_broadcast_ps((const __m128*)m->m[0]);
+	__m256 c1 = _mm256_broadcast_ps((const __m128*)m->m[1]);
+	__m256 c2 = _mm256_broadcast_ps((const __m128*)m->m[2]);
+	__m256 c3 = _mm256_broadcast_ps((const __m128*)m->m[3]);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+			_mm_prefetch((const char*)(in + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+
+		__m256 r01 = QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(_mm256_loadu_ps(in[i].m[0]), c0, c1, c2, c3);
+		__m256 r23 = QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(_mm256_loadu_ps(in[i].m[2]), c0, c1, c2, c3);
+
+		_mm256_storeu_ps(out[i].m[0], r01);
+		_mm256_storeu_ps(out[i].m[2], r23);
+	}
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx2)(const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+		{
+			_mm_prefetch((const char*)(m1 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+			_mm_prefetch((const char*)(m2 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+		}
+
+		__m256 c0 = _mm256_broadcast_ps((const __m128*)m1[i].m[0]);
+		__m256 c1 = _mm256_broadcast_ps((const __m128*)m1[i].m[1]);
+		__m256 c2 = _mm256_broadcast_ps((const __m128*)m1[i].m[2]);
+		__m256 c3 = _mm256_broadcast_ps((const __m128*)m1[i].m[3]);
+
+		__m256 r01 = QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(_mm256_loadu_ps(m2[i].m[0]), c0, c1, c2, c3);
+		__m256 r23 = QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(_mm256_loadu_ps(m2[i].m[2]), c0, c1, c2, c3);
+
+		_mm256_storeu_ps(out[i].m[0], r01);
+		_mm256_storeu_ps(out[i].m[2], r23);
+	}
+}
+
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(mat4_mult_array_avx512)(const QMmat4* m, const QMmat4* in, QMmat4* out, size_t count)
+{
+	//a whole matrix fits in one register, so no tail handling is needed
+	__m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[0]));
+	__m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[1]));
+	__m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[2]));
+	__m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[3]));
+
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+			_mm_prefetch((const char*)(in + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+
+		_mm512_storeu_ps(out[i].m[0], QM_FUNC_PREFIX(mat4_mult_column4_reg_avx512)(_mm512_loadu_ps(in[i].m[0]), c0, c1, c2, c3));
+	}
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx512)(const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+		{
+			_mm_prefetch((const char*)(m1 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+			_mm_prefetch((const char*)(m2 + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+		}
+
+		__m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m1[i].m[0]));
+		__m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m1[i].m[1]));
+		__m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m1[i].m[2]));
+		__m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m1[i].m[3]));
+
+		_mm512_storeu_ps(out[i].m[0], QM_FUNC_PREFIX(mat4_mult_column4_reg_avx512)(_mm512_loadu_ps(m2[i].m[0]), c0, c1, c2, c3));
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array)(QMmat4 m, const QMmat4* in, QMmat4* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_mult_array(&m, in, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(mat4_mult_array_avx512)(&m, in, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(mat4_mult_array_avx2)(&m, in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_mult_array_sse)(&m, in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_mult_array_scalar)(&m, in, out, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_array_pairwise)(const QMmat4* m1, const QMmat4* m2, QMmat4* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_mult_array_pairwise(m1, m2, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx512)(m1, m2, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx2)(m1, m2, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_mult_array_pairwise_sse)(m1, m2, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_mult_array_pairwise_scalar)(m1, m2, out, count);
+
+	#endif
+}
+
+//array transformation:
+
+//batch kernels, one per instruction set tier. the public functions below call the best one
+//available at compile time, or the one selected at runtime when QM_RUNTIME_DISPATCH is defined
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_vec4_array_scalar)(const QMmat4* m, const QMvec4* in, QMvec4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		QMvec4 v = in[i];
+
+		out[i].x = m->m[0][0] * v.x + m->m[1][0] * v.y + m->m[2][0] * v.z + m->m[3][0] * v.w;
+		out[i].y = m->m[0][1] * v.x + m->m[1][1] * v.y + m->m[2][1] * v.z + m->m[3][1] * v.w;
+		out[i].z = m->m[0][2] * v.x + m->m[1][2] * v.y + m->m[2][2] * v.z + m->m[3][2] * v.w;
+		out[i].w = m->m[0][3] * v.x + m->m[1][3] * v.y + m->m[2][3] * v.z + m->m[3][3] * v.w;
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_array_scalar)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		QMvec3 v = in[i];
+
+		out[i].x = m->m[0][0] * v.x + m->m[1][0] * v.y + m->m[2][0] * v.z + m->m[3][0];
+		out[i].y = m->m[0][1] * v.x + m->m[1][1] * v.y + m->m[2][1] * v.z + m->m[3][1];
+		out[i].z = m->m[0][2] * v.x + m->m[1][2] * v.y + m->m[2][2] * v.z + m->m[3][2];
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_scalar)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		QMvec3 v = in[i];
+
+		out[i].x = m->m[0][0] * v.x + m->m[1][0] * v.y + m->m[2][0] * v.z;
+		out[i].y = m->m[0][1] * v.x + m->m[1][1] * v.y + m->m[2][1] * v.z;
+		out[i].z = m->m[0][2] * v.x + m->m[1][2] * v.y + m->m[2][2] * v.z;
+	}
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_vec4_array_sse)(const QMmat4* m, const QMvec4* in, QMvec4* out, size_t count)
+{
+	__m128 c0 = _mm_loadu_ps(m->m[0]);
+	__m128 c1 = _mm_loadu_ps(m->m[1]);
+	__m128 c2 = _mm_loadu_ps(m->m[2]);
+	__m128 c3 = _mm_loadu_ps(m->m[3]);
+
+	for(size_t i = 0; i < count; i++)
+		_mm_storeu_ps(out[i].v, QM_FUNC_PREFIX(mat4_mult_column_reg_sse)(_mm_loadu_ps(in[i].v), c0, c1, c2, c3));
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_array_sse)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	size_t i = 0;
+
+	__m128 m00 = _mm_set1_ps(m->m[0][0]), m01 = _mm_set1_ps(m->m[0][1]), m02 = _mm_set1_ps(m->m[0][2]);
+	__m128 m10 = _mm_set1_ps(m->m[1][0]), m11 = _mm_set1_ps(m->m[1][1]), m12 = _mm_set1_ps(m->m[1][2]);
+	__m128 m20 = _mm_set1_ps(m->m[2][0]), m21 = _mm_set1_ps(m->m[2][1]), m22 = _mm_set1_ps(m->m[2][2]);
+	__m128 m30 = _mm_set1_ps(m->m[3][0]), m31 = _mm_set1_ps(m->m[3][1]), m32 = _mm_set1_ps(m->m[3][2]);
+
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x, y, z;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i], &x, &y, &z);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_add_ps(_mm_mul_ps(m20, z), m30));
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_add_ps(_mm_mul_ps(m21, z), m31));
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_add_ps(_mm_mul_ps(m22, z), m32));
+
+		QM_FUNC_PREFIX(vec3_store4_sse)(rx, ry, rz, &out[i]);
+	}
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_scalar)(m, in + i, out + i, count - i);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_sse)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	size_t i = 0;
+
+	__m128 m00 = _mm_set1_ps(m->m[0][0]), m01 = _mm_set1_ps(m->m[0][1]), m02 = _mm_set1_ps(m->m[0][2]);
+	__m128 m10 = _mm_set1_ps(m->m[1][0]), m11 = _mm_set1_ps(m->m[1][1]), m12 = _mm_set1_ps(m->m[1][2]);
+	__m128 m20 = _mm_set1_ps(m->m[2][0]), m21 = _mm_set1_ps(m->m[2][1]), m22 = _mm_set1_ps(m->m[2][2]);
+
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x, y, z;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i], &x, &y, &z);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_mul_ps(m20, z));
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m21, z));
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_mul_ps(m22, z));
+
+		QM_FUNC_PREFIX(vec3_store4_sse)(rx, ry, rz, &out[i]);
+	}
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_scalar)(m, in + i, out + i, count - i);
+}
+
+#endif
+
+#if QM_USE_AVX2 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(mat4_mult_vec4_array_avx2)(const QMmat4* m, const QMvec4* in, QMvec4* out, size_t count)
+{
+	//2 vec4s per iteration, each column is broadcast to both halves
+	size_t i = 0;
+
+	__m256 c0 = _mm256_broadcast_ps((const __m128*)m->m[0]);
+	__m256 c1 = _mm256_broadcast_ps((const __m128*)m->m[1]);
+	__m256 c2 = _mm256_broadcast_ps((const __m128*)m->m[2]);
+	__m256 c3 = _mm256_broadcast_ps((const __m128*)m->m[3]);
+
+	for(; i < (count & ~(size_t)1); i += 2)
+		_mm256_storeu_ps(out[i].v, QM_FUNC_PREFIX(mat4_mult_column2_reg_avx)(_mm256_loadu_ps(in[i].v), c0, c1, c2, c3));
+
+	QM_FUNC_PREFIX(mat4_mult_vec4_array_sse)(m, in + i, out + i, count - i);
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(mat4_transform_vec3_array_avx2)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	size_t i = 0;
+
+	__m256 m00 = _mm256_set1_ps(m->m[0][0]), m01 = _mm256_set1_ps(m->m[0][1]), m02 = _mm256_set1_ps(m->m[0][2]);
+	__m256 m10 = _mm256_set1_ps(m->m[1][0]), m11 = _mm256_set1_ps(m->m[1][1]), m12 = _mm256_set1_ps(m->m[1][2]);
+	__m256 m20 = _mm256_set1_ps(m->m[2][0]), m21 = _mm256_set1_ps(m->m[2][1]), m22 = _mm256_set1_ps(m->m[2][2]);
+	__m256 m30 = _mm256_set1_ps(m->m[3][0]), m31 = _mm256_set1_ps(m->m[3][1]), m32 = _mm256_set1_ps(m->m[3][2]);
+
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m128 x0, y0, z0, x1, y1, z1;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i    ], &x0, &y0, &z0);
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i + 4], &x1, &y1, &z1);
+
+		__m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+		__m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+		__m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+
+		__m256 rx = _mm256_fmadd_ps(m00, x, _mm256_fmadd_ps(m10, y, _mm256_fmadd_ps(m20, z, m30)));
+		__m256 ry = _mm256_fmadd_ps(m01, x, _mm256_fmadd_ps(m11, y, _mm256_fmadd_ps(m21, z, m31)));
+		__m256 rz = _mm256_fmadd_ps(m02, x, _mm256_fmadd_ps(m12, y, _mm256_fmadd_ps(m22, z, m32)));
+
+		QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_castps256_ps128(rx), _mm256_castps256_ps128(ry), _mm256_castps256_ps128(rz), &out[i]);
+		QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_extractf128_ps(rx, 1), _mm256_extractf128_ps(ry, 1), _mm256_extractf128_ps(rz, 1), &out[i + 4]);
+	}
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_sse)(m, in + i, out + i, count - i);
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx2)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	size_t i = 0;
+
+	__m256 m00 = _mm256_set1_ps(m->m[0][0]), m01 = _mm256_set1_ps(m->m[0][1]), m02 = _mm256_set1_ps(m->m[0][2]);
+	__m256 m10 = _mm256_set1_ps(m->m[1][0]), m11 = _mm256_set1_ps(m->m[1][1]), m12 = _mm256_set1_ps(m->m[1][2]);
+	__m256 m20 = _mm256_set1_ps(m->m[2][0]), m21 = _mm256_set1_ps(m->m[2][1]), m22 = _mm256_set1_ps(m->m[2][2]);
+
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m128 x0, y0, z0, x1, y1, z1;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i    ], &x0, &y0, &z0);
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i + 4], &x1, &y1, &z1);
+
+		__m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+		__m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+		__m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+
+		__m256 rx = _mm256_fmadd_ps(m00, x, _mm256_fmadd_ps(m10, y, _mm256_mul_ps(m20, z)));
+		__m256 ry = _mm256_fmadd_ps(m01, x, _mm256_fmadd_ps(m11, y, _mm256_mul_ps(m21, z)));
+		__m256 rz = _mm256_fmadd_ps(m02, x, _mm256_fmadd_ps(m12, y, _mm256_mul_ps(m22, z)));
+
+		QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_castps256_ps128(rx), _mm256_castps256_ps128(ry), _mm256_castps256_ps128(rz), &out[i]);
+		QM_FUNC_PREFIX(vec3_store4_sse)(_mm256_extractf128_ps(rx, 1), _mm256_extractf128_ps(ry, 1), _mm256_extractf128_ps(rz, 1), &out[i + 4]);
+	}
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_sse)(m, in + i, out + i, count - i);
+}
+
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+//the AVX-512 kernels handle the tail with masked loads and stores instead of a scalar loop
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(mat4_mult_vec4_array_avx512)(const QMmat4* m, const QMvec4* in, QMvec4* out, size_t count)
+{
+	//4 vec4s per iteration, each column is broadcast to all 4 quarters
+	__m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[0]));
+	__m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[1]));
+	__m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[2]));
+	__m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m->m[3]));
+
+	for(size_t i = 0; i < count; i += 4)
+	{
+		__mmask16 mask = QM_FUNC_PREFIX(mask16_avx512)((count - i) * 4);
+		__m512 v = _mm512_maskz_loadu_ps(mask, in[i].v);
+
+		_mm512_mask_storeu_ps(out[i].v, mask, QM_FUNC_PREFIX(mat4_mult_column4_reg_avx512)(v, c0, c1, c2, c3));
+	}
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(mat4_transform_vec3_array_avx512)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	__m512 m00 = _mm512_set1_ps(m->m[0][0]), m01 = _mm512_set1_ps(m->m[0][1]), m02 = _mm512_set1_ps(m->m[0][2]);
+	__m512 m10 = _mm512_set1_ps(m->m[1][0]), m11 = _mm512_set1_ps(m->m[1][1]), m12 = _mm512_set1_ps(m->m[1][2]);
+	__m512 m20 = _mm512_set1_ps(m->m[2][0]), m21 = _mm512_set1_ps(m->m[2][1]), m22 = _mm512_set1_ps(m->m[2][2]);
+	__m512 m30 = _mm512_set1_ps(m->m[3][0]), m31 = _mm512_set1_ps(m->m[3][1]), m32 = _mm512_set1_ps(m->m[3][2]);
+
+	for(size_t i = 0; i < count; i += 16)
+	{
+		size_t n = QM_MIN(count - i, (size_t)16);
+
+		__m512 x, y, z;
+		QM_FUNC_PREFIX(vec3_load16_avx512)(&in[i], n, &x, &y, &z);
+
+		__m512 rx = _mm512_fmadd_ps(m00, x, _mm512_fmadd_ps(m10, y, _mm512_fmadd_ps(m20, z, m30)));
+		__m512 ry = _mm512_fmadd_ps(m01, x, _mm512_fmadd_ps(m11, y, _mm512_fmadd_ps(m21, z, m31)));
+		__m512 rz = _mm512_fmadd_ps(m02, x, _mm512_fmadd_ps(m12, y, _mm512_fmadd_ps(m22, z, m32)));
+
+		QM_FUNC_PREFIX(vec3_store16_avx512)(rx, ry, rz, &out[i], n);
+	}
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx512)(const QMmat4* m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	__m512 m00 = _mm512_set1_ps(m->m[0][0]), m01 = _mm512_set1_ps(m->m[0][1]), m02 = _mm512_set1_ps(m->m[0][2]);
+	__m512 m10 = _mm512_set1_ps(m->m[1][0]), m11 = _mm512_set1_ps(m->m[1][1]), m12 = _mm512_set1_ps(m->m[1][2]);
+	__m512 m20 = _mm512_set1_ps(m->m[2][0]), m21 = _mm512_set1_ps(m->m[2][1]), m22 = _mm512_set1_ps(m->m[2][2]);
+
+	for(size_t i = 0; i < count; i += 16)
+	{
+		size_t n = QM_MIN(count - i, (size_t)16);
+
+		__m512 x, y, z;
+		QM_FUNC_PREFIX(vec3_load16_avx512)(&in[i], n, &x, &y, &z);
+
+		__m512 rx = _mm512_fmadd_ps(m00, x, _mm512_fmadd_ps(m10, y, _mm512_mul_ps(m20, z)));
+		__m512 ry = _mm512_fmadd_ps(m01, x, _mm512_fmadd_ps(m11, y, _mm512_mul_ps(m21, z)));
+		__m512 rz = _mm512_fmadd_ps(m02, x, _mm512_fmadd_ps(m12, y, _mm512_mul_ps(m22, z)));
+
+		QM_FUNC_PREFIX(vec3_store16_avx512)(rx, ry, rz, &out[i], n);
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_mult_vec4_array)(QMmat4 m, const QMvec4* in, QMvec4* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_mult_vec4_array(&m, in, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(mat4_mult_vec4_array_avx512)(&m, in, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(mat4_mult_vec4_array_avx2)(&m, in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_mult_vec4_array_sse)(&m, in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_mult_vec4_array_scalar)(&m, in, out, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_array)(QMmat4 m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_transform_vec3_array(&m, in, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_avx512)(&m, in, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_avx2)(&m, in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_sse)(&m, in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_array_scalar)(&m, in, out, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_transform_vec3_dir_array)(QMmat4 m, const QMvec3* in, QMvec3* out, size_t count)
+{
+	//like mat4_transform_vec3_array, but ignores the translation (w = 0)
+
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_transform_vec3_dir_array(&m, in, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx512)(&m, in, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx2)(&m, in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_sse)(&m, in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_scalar)(&m, in, out, count);
+
+	#endif
+}
+
+//transpose:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_transpose)(QMmat3 m)
+{
+	QMmat3 result;
+
+	result.m[0][0] = m.m[0][0];
+	result.m[0][1] = m.m[1][0];
+	result.m[0][2] = m.m[2][0];
+	result.m[1][0] = m.m[0][1];
+	result.m[1][1] = m.m[1][1];
+	result.m[1][2] = m.m[2][1];
+	result.m[2][0] = m.m[0][2];
+	result.m[2][1] = m.m[1][2];
+	result.m[2][2] = m.m[2][2];
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_transpose)(QMmat4 m)
+{
+	QMmat4 result = m;
+
+	#if QM_USE_SSE
+
+	_MM_TRANSPOSE4_PS(result.packed[0], result.packed[1], result.packed[2], result.packed[3]);
+
+	#else
+
+	result.m[0][0] = m.m[0][0];
+	result.m[0][1] = m.m[1][0];
+	result.m[0][2] = m.m[2][0];
+	result.m[0][3] = m.m[3][0];
+	result.m[1][0] = m.m[0][1];
+	result.m[1][1] = m.m[1][1];
+	result.m[1][2] = m.m[2][1];
+	result.m[1][3] = m.m[3][1];
+	result.m[2][0] = m.m[0][2];
+	result.m[2][1] = m.m[1][2];
+	result.m[2][2] = m.m[2][2];
+	result.m[2][3] = m.m[3][2];
+	result.m[3][0] = m.m[0][3];
+	result.m[3][1] = m.m[1][3];
+	result.m[3][2] = m.m[2][3];
+	result.m[3][3] = m.m[3][3];
+
+	#endif
+
+	return result;
+}
+
+//inverse:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_inv)(QMmat3 m)
+{
+	QMmat3 result;
+
+	float det;
+  	float a = m.m[0][0], b = m.m[0][1], c = m.m[0][2],
+	      d = m.m[1][0], e = m.m[1][1], f = m.m[1][2],
+	      g = m.m[2][0], h = m.m[2][1], i = m.m[2][2];
+
+	result.m[0][0] =   e * i - f * h;
+	result.m[0][1] = -(b * i - h * c);
+	result.m[0][2] =   b * f - e * c;
+	result.m[1][0] = -(d * i - g * f);
+	result.m[1][1] =   a * i - c * g;
+	result.m[1][2] = -(a * f - d * c);
+	result.m[2][0] =   d * h - g * e;
+	result.m[2][1] = -(a * h - g * b);
+	result.m[2][2] =   a * e - b * d;
+
+	det = 1.0f / (a * result.m[0][0] + b * result.m[1][0] + c * result.m[2][0]);
+
+	result.m[0][0] *= det;
+	result.m[0][1] *= det;
+	result.m[0][2] *= det;
+	result.m[1][0] *= det;
+	result.m[1][1] *= det;
+	result.m[1][2] *= det;
+	result.m[2][0] *= det;
+	result.m[2][1] *= det;
+	result.m[2][2] *= det;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_inv)(QMmat4 mat)
+{
+	QMmat4 result;
+
+	#if QM_USE_SSE
+
+	//block-wise inverse, splitting the matrix into 2x2 submatrices A, B, C, D and
+	//computing the adjugate of each block. the blocks are built from columns rather than
+	//rows, which is fine since inv(transpose(M)) = transpose(inv(M)).
+	//for well-conditioned matrices (e.g. any combination of translation, rotation, and scaling)
+	//every element is within 8 ULP of the scalar path, measured in ULPs of the largest element
+	//of the result. ill-conditioned matrices like projections lose precision in both paths
+
+	__m128 A = _mm_movelh_ps(mat.packed[0], mat.packed[1]);
+	__m128 B = _mm_movehl_ps(mat.packed[1], mat.packed[0]);
+	__m128 C = _mm_movelh_ps(mat.packed[2], mat.packed[3]);
+	__m128 D = _mm_movehl_ps(mat.packed[3], mat.packed[2]);
+
+	//determinants of each block as (|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(mat.packed[0], mat.packed[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(mat.packed[1], mat.packed[3], _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(mat.packed[0], mat.packed[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(mat.packed[1], mat.packed[3], _MM_SHUFFLE(2, 0, 2, 0)))
+	);
+	__m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m128 DC = QM_FUNC_PREFIX(mat2_adj_mult_sse)(D, C);
+	__m128 AB = QM_FUNC_PREFIX(mat2_adj_mult_sse)(A, B);
+
+	//adjugates of the blocks of the inverse
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), QM_FUNC_PREFIX(mat2_mult_sse)(B, DC));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), QM_FUNC_PREFIX(mat2_mult_sse)(C, AB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), QM_FUNC_PREFIX(mat2_mult_adj_sse)(D, AB));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), QM_FUNC_PREFIX(mat2_mult_adj_sse)(A, DC));
+
+	//|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 tr = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3, 1, 2, 0)));
+	tr = _mm_hadd_ps(tr, tr);
+	tr = _mm_hadd_ps(tr, tr);
+
+	__m128 det = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	det = _mm_sub_ps(det, tr);
+	det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+	X = _mm_mul_ps(X, det);
+	Y = _mm_mul_ps(Y, det);
+	Z = _mm_mul_ps(Z, det);
+	W = _mm_mul_ps(W, det);
+
+	//take the adjugate of each block and reassemble
+	result.packed[0] = _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3));
+	result.packed[1] = _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2));
+	result.packed[2] = _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3));
+	result.packed[3] = _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2));
+
+	#else
+
+	float tmp[6];
+	float det;
+	float a = mat.m[0][0], b = mat.m[0][1], c = mat.m[0][2], d = mat.m[0][3],
+	      e = mat.m[1][0], f = mat.m[1][1], g = mat.m[1][2], h = mat.m[1][3],
+	      i = mat.m[2][0], j = mat.m[2][1], k = mat.m[2][2], l = mat.m[2][3],
+	      m = mat.m[3][0], n = mat.m[3][1], o = mat.m[3][2], p = mat.m[3][3];
+
+	tmp[0] = k * p - o * l; 
+	tmp[1] = j * p - n * l; 
+	tmp[2] = j * o - n * k;
+	tmp[3] = i * p - m * l; 
+	tmp[4] = i * o - m * k; 
+	tmp[5] = i * n - m * j;
+
+	result.m[0][0] =   f * tmp[0] - g * tmp[1] + h * tmp[2];
+	result.m[1][0] = -(e * tmp[0] - g * tmp[3] + h * tmp[4]);
+	result.m[2][0] =   e * tmp[1] - f * tmp[3] + h * tmp[5];
+	result.m[3][0] = -(e * tmp[2] - f * tmp[4] + g * tmp[5]);
+
+	result.m[0][1] = -(b * tmp[0] - c * tmp[1] + d * tmp[2]);
+	result.m[1][1] =   a * tmp[0] - c * tmp[3] + d * tmp[4];
+	result.m[2][1] = -(a * tmp[1] - b * tmp[3] + d * tmp[5]);
+	result.m[3][1] =   a * tmp[2] - b * tmp[4] + c * tmp[5];
+
+	tmp[0] = g * p - o * h;
+	tmp[1] = f * p - n * h;
+	tmp[2] = f * o - n * g;
+	tmp[3] = e * p - m * h;
+	tmp[4] = e * o - m * g;
+	tmp[5] = e * n - m * f;
+
+	result.m[0][2] =   b * tmp[0] - c * tmp[1] + d * tmp[2];
+	result.m[1][2] = -(a * tmp[0] - c * tmp[3] + d * tmp[4]);
+	result.m[2][2] =   a * tmp[1] - b * tmp[3] + d * tmp[5];
+	result.m[3][2] = -(a * tmp[2] - b * tmp[4] + c * tmp[5]);
+
+	tmp[0] = g * l - k * h;
+	tmp[1] = f * l - j * h;
+	tmp[2] = f * k - j * g;
+	tmp[3] = e * l - i * h;
+	tmp[4] = e * k - i * g;
+	tmp[5] = e * j - i * f;
+
+	result.m[0][3] = -(b * tmp[0] - c * tmp[1] + d * tmp[2]);
+	result.m[1][3] =   a * tmp[0] - c * tmp[3] + d * tmp[4];
+	result.m[2][3] = -(a * tmp[1] - b * tmp[3] + d * tmp[5]);
+  	result.m[3][3] =   a * tmp[2] - b * tmp[4] + c * tmp[5];
+
+  	det = 1.0f / (a * result.m[0][0] + b * result.m[1][0]
+                + c * result.m[2][0] + d * result.m[3][0]);
+
+	result.m[0][0] = result.m[0][0] * det;
+	result.m[0][1] = result.m[0][1] * det;
+	result.m[0][2] = result.m[0][2] * det;
+	result.m[0][3] = result.m[0][3] * det;
+	result.m[1][0] = result.m[1][0] * det;
+	result.m[1][1] = result.m[1][1] * det;
+	result.m[1][2] = result.m[1][2] * det;
+	result.m[1][3] = result.m[1][3] * det;
+	result.m[2][0] = result.m[2][0] * det;
+	result.m[2][1] = result.m[2][1] * det;
+	result.m[2][2] = result.m[2][2] * det;
+	result.m[2][3] = result.m[2][3] * det;
+	result.m[3][0] = result.m[3][0] * det;
+	result.m[3][1] = result.m[3][1] * det;
+	result.m[3][2] = result.m[3][2] * det;
+	result.m[3][3] = result.m[3][3] * det;
+
+	#endif
+
+  	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_inv_affine)(QMmat4 mat)
+{
+	//assumes the bottom row of mat is (0, 0, 0, 1)
+
+	QMmat4 result;
+
+	#if QM_USE_SSE
+
+	__m128 c0 = mat.packed[0];
+	__m128 c1 = mat.packed[1];
+	__m128 c2 = mat.packed[2];
+
+	//rows of the inverse of the top left 3x3 are the cross products of its columns
+	__m128 r0 = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 1, 0, 2))),
+		_mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 0, 2, 1)))
+	);
+	__m128 r1 = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(c0, c0, _MM_SHUFFLE(3, 1, 0, 2))),
+		_mm_mul_ps(_mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(c0, c0, _MM_SHUFFLE(3, 0, 2, 1)))
+	);
+	__m128 r2 = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(c0, c0, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 1, 0, 2))),
+		_mm_mul_ps(_mm_shuffle_ps(c0, c0, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 0, 2, 1)))
+	);
+	__m128 r3 = _mm_setzero_ps();
+
+	__m128 det = _mm_mul_ps(c0, r0);
+	det = _mm_hadd_ps(det, det);
+	det = _mm_hadd_ps(det, det);
+	det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+	r0 = _mm_mul_ps(r0, det);
+	r1 = _mm_mul_ps(r1, det);
+	r2 = _mm_mul_ps(r2, det);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 t = mat.packed[3];
+	__m128 translation =                         _mm_mul_ps(r0, _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)));
+	translation = _mm_add_ps(translation, _mm_mul_ps(r1, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+	translation = _mm_add_ps(translation, _mm_mul_ps(r2, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2))));
+
+	result.packed[0] = r0;
+	result.packed[1] = r1;
+	result.packed[2] = r2;
+	result.packed[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+
+	#else
+
+	float det;
+	float a = mat.m[0][0], b = mat.m[0][1], c = mat.m[0][2],
+	      d = mat.m[1][0], e = mat.m[1][1], f = mat.m[1][2],
+	      g = mat.m[2][0], h = mat.m[2][1], i = mat.m[2][2];
+	float x = mat.m[3][0], y = mat.m[3][1], z = mat.m[3][2];
+
+	result.m[0][0] =   e * i - f * h;
+	result.m[0][1] = -(b * i - h * c);
+	result.m[0][2] =   b * f - e * c;
+	result.m[1][0] = -(d * i - g * f);
+	result.m[1][1] =   a * i - c * g;
+	result.m[1][2] = -(a * f - d * c);
+	result.m[2][0] =   d * h - g * e;
+	result.m[2][1] = -(a * h - g * b);
+	result.m[2][2] =   a * e - b * d;
+
+	det = 1.0f / (a * result.m[0][0] + b * result.m[1][0] + c * result.m[2][0]);
+
+	result.m[0][0] *= det;
+	result.m[0][1] *= det;
+	result.m[0][2] *= det;
+	result.m[0][3] = 0.0f;
+	result.m[1][0] *= det;
+	result.m[1][1] *= det;
+	result.m[1][2] *= det;
+	result.m[1][3] = 0.0f;
+	result.m[2][0] *= det;
+	result.m[2][1] *= det;
+	result.m[2][2] *= det;
+	result.m[2][3] = 0.0f;
+
+	result.m[3][0] = -(result.m[0][0] * x + result.m[1][0] * y + result.m[2][0] * z);
+	result.m[3][1] = -(result.m[0][1] * x + result.m[1][1] * y + result.m[2][1] * z);
+	result.m[3][2] = -(result.m[0][2] * x + result.m[1][2] * y + result.m[2][2] * z);
+	result.m[3][3] = 1.0f;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_inv_rigid)(QMmat4 mat)
+{
+	//assumes the top left 3x3 of mat is orthonormal and the bottom row is (0, 0, 0, 1)
+
+	QMmat4 result;
+
+	#if QM_USE_SSE
+
+	result.packed[0] = mat.packed[0];
+	result.packed[1] = mat.packed[1];
+	result.packed[2] = mat.packed[2];
+	result.packed[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	_MM_TRANSPOSE4_PS(result.packed[0], result.packed[1], result.packed[2], result.packed[3]);
+
+	__m128 t = mat.packed[3];
+	__m128 translation =                         _mm_mul_ps(result.packed[0], _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)));
+	translation = _mm_add_ps(translation, _mm_mul_ps(result.packed[1], _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+	translation = _mm_add_ps(translation, _mm_mul_ps(result.packed[2], _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2))));
+
+	result.packed[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+
+	#else
+
+	float x = mat.m[3][0], y = mat.m[3][1], z = mat.m[3][2];
+
+	result.m[0][0] = mat.m[0][0];
+	result.m[0][1] = mat.m[1][0];
+	result.m[0][2] = mat.m[2][0];
+	result.m[0][3] = 0.0f;
+	result.m[1][0] = mat.m[0][1];
+	result.m[1][1] = mat.m[1][1];
+	result.m[1][2] = mat.m[2][1];
+	result.m[1][3] = 0.0f;
+	result.m[2][0] = mat.m[0][2];
+	result.m[2][1] = mat.m[1][2];
+	result.m[2][2] = mat.m[2][2];
+	result.m[2][3] = 0.0f;
+
+	result.m[3][0] = -(result.m[0][0] * x + result.m[1][0] * y + result.m[2][0] * z);
+	result.m[3][1] = -(result.m[0][1] * x + result.m[1][1] * y + result.m[2][1] * z);
+	result.m[3][2] = -(result.m[0][2] * x + result.m[1][2] * y + result.m[2][2] * z);
+	result.m[3][3] = 1.0f;
+
+	#endif
+
+	return result;
+}
+
+//translation:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_translate)(QMvec2 t)
+{
+	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+
+	result.m[2][0] = t.x;
+	result.m[2][1] = t.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_translate)(QMvec3 t)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	result.m[3][0] = t.x;
+	result.m[3][1] = t.y;
+	result.m[3][2] = t.z;
+
+	return result;
+}
+
+//scaling:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_scale)(QMvec2 s)
+{
+	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+
+	result.m[0][0] = s.x;
+	result.m[1][1] = s.y;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_scale)(QMvec3 s)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	result.m[0][0] = s.x;
+	result.m[1][1] = s.y;
+	result.m[2][2] = s.z;
+
+	return result;
+}
+
+//rotation:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_rotate)(float angle)
+{
+	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+
+	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle);
+
+	#ifdef QM_FAST_TRIG
+
+	float sine, cosine;
+	QM_FUNC_PREFIX(sincos_poly)(radians, &sine, &cosine);
+
+	#else
+
+	float sine   = QM_SINF(radians);
+	float cosine = QM_COSF(radians);
+
+	#endif
+
+	result.m[0][0] = cosine;
+	result.m[1][0] =   sine;
+	result.m[0][1] =  -sine;
+	result.m[1][1] = cosine;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_rotate)(QMvec3 axis, float angle)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	axis = QM_FUNC_PREFIX(vec3_normalize)(axis);
+
+	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle);
+
+	#ifdef QM_FAST_TRIG
+
+	float sine, cosine;
+	QM_FUNC_PREFIX(sincos_poly)(radians, &sine, &cosine);
+
+	#else
+
+	float sine    = QM_SINF(radians);
+	float cosine  = QM_COSF(radians);
+
+	#endif
+
+	float cosine2 = 1.0f - cosine;
+
+	result.m[0][0] = axis.x * axis.x * cosine2 + cosine;
+	result.m[0][1] = axis.x * axis.y * cosine2 + axis.z * sine;
+	result.m[0][2] = axis.x * axis.z * cosine2 - axis.y * sine;
+	result.m[1][0] = axis.y * axis.x * cosine2 - axis.z * sine;
+	result.m[1][1] = axis.y * axis.y * cosine2 + cosine;
+	result.m[1][2] = axis.y * axis.z * cosine2 + axis.x * sine;
+	result.m[2][0] = axis.z * axis.x * cosine2 + axis.y * sine;
+	result.m[2][1] = axis.z * axis.y * cosine2 - axis.x * sine;
+	result.m[2][2] = axis.z * axis.z * cosine2 + cosine;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_rotate_euler)(QMvec3 angles)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	QMvec3 radians;
+	radians.x = QM_FUNC_PREFIX(deg_to_rad)(angles.x);
+	radians.y = QM_FUNC_PREFIX(deg_to_rad)(angles.y);
+	radians.z = QM_FUNC_PREFIX(deg_to_rad)(angles.z);
+
+	#ifdef QM_FAST_TRIG
+
+	QMvec4 sines, cosines;
+	QM_FUNC_PREFIX(vec4_sincos)(QM_FUNC_PREFIX(vec4_set)(radians.x, radians.y, radians.z, 0.0f), &sines, &cosines);
+
+	float sinX = sines.x;
+	float cosX = cosines.x;
+	float sinY = sines.y;
+	float cosY = cosines.y;
+	float sinZ = sines.z;
+	float cosZ = cosines.z;
+
+	#else
+
+	float sinX = QM_SINF(radians.x);
+	float cosX = QM_COSF(radians.x);
+	float sinY = QM_SINF(radians.y);
+	float cosY = QM_COSF(radians.y);
+	float sinZ = QM_SINF(radians.z);
+	float cosZ = QM_COSF(radians.z);
+
+	#endif
+
+	result.m[0][0] = cosY * cosZ;
+	result.m[0][1] = cosY * sinZ;
+	result.m[0][2] = -sinY;
+	result.m[1][0] = sinX * sinY * cosZ - cosX * sinZ;
+	result.m[1][1] = sinX * sinY * sinZ + cosX * cosZ;
+	result.m[1][2] = sinX * cosY;
+	result.m[2][0] = cosX * sinY * cosZ + sinX * sinZ;
+	result.m[2][1] = cosX * sinY * sinZ - sinX * cosZ;
+	result.m[2][2] = cosX * cosY;
+
+	return result;
+}
+
+//to mat3:
+
+QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat4_top_left)(QMmat4 m)
+{
+	QMmat3 result;
+
+	result.m[0][0] = m.m[0][0];
+	result.m[0][1] = m.m[0][1];
+	result.m[0][2] = m.m[0][2];
+	result.m[1][0] = m.m[1][0];
+	result.m[1][1] = m.m[1][1];
+	result.m[1][2] = m.m[1][2];
+	result.m[2][0] = m.m[2][0];
+	result.m[2][1] = m.m[2][1];
+	result.m[2][2] = m.m[2][2];
+
+	return result;
+}
+
+//projection:
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_perspective)(float fov, float aspect, float near, float far)
+{
+	QMmat4 result = {0};
+
+	#ifdef QM_FAST_TRIG
+
+	float sine, cosine;
+	QM_FUNC_PREFIX(sincos_poly)(QM_FUNC_PREFIX(deg_to_rad)(fov * 0.5f), &sine, &cosine);
+	float scale = sine / cosine * near;
+
+	#else
+
+	float scale = QM_TANF(QM_FUNC_PREFIX(deg_to_rad)(fov * 0.5f)) * near;
+
+	#endif
+
+	float right = aspect * scale;
+	float top   = scale;
+
+	result.m[0][0] = near / right;
+	result.m[1][1] = near / top;
+	result.m[2][2] = -(far + near) / (far - near);
+	result.m[3][2] = -2.0f * far * near / (far - near);
+	result.m[2][3] = -1.0f;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_orthographic)(float left, float right, float bot, float top, float near, float far)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	result.m[0][0] = 2.0f / (right - left);
+	result.m[1][1] = 2.0f / (top - bot);
+	result.m[2][2] = 2.0f / (near - far);
+
+	result.m[3][0] = (left + right) / (left - right);
+	result.m[3][1] = (bot  + top  ) / (bot  - top  );
+	result.m[3][2] = (near + far  ) / (near - far  );
+
+	return result;
+}
+
+//view matrix:
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_look)(QMvec3 pos, QMvec3 dir, QMvec3 up)
+{
+	QMmat4 result;
+
+	QMvec3 r = QM_FUNC_PREFIX(vec3_normalize)(QM_FUNC_PREFIX(vec3_cross)(up, dir));
+	QMvec3 u = QM_FUNC_PREFIX(vec3_cross)(dir, r);
+
+	QMmat4 RUD = QM_FUNC_PREFIX(mat4_identity)();
+	RUD.m[0][0] = r.x;
+	RUD.m[1][0] = r.y;
+	RUD.m[2][0] = r.z;
+	RUD.m[0][1] = u.x;
+	RUD.m[1][1] = u.y;
+	RUD.m[2][1] = u.z;
+	RUD.m[0][2] = -dir.x;
+	RUD.m[1][2] = -dir.y;
+	RUD.m[2][2] = -dir.z;
+
+	QMvec3 oppPos = {-pos.x, -pos.y, -pos.z};	
+	result = QM_FUNC_PREFIX(mat4_mult)(RUD, QM_FUNC_PREFIX(mat4_translate)(oppPos));
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_lookat)(QMvec3 pos, QMvec3 target, QMvec3 up)
+{
+	QMmat4 result;
+
+	QMvec3 dir = QM_FUNC_PREFIX(vec3_normalize)(QM_FUNC_PREFIX(vec3_sub)(pos, target));
+	result = QM_FUNC_PREFIX(mat4_look)(pos, dir, up);
+
+	return result;
+}
+
+//----------------------------------------------------------------------//
+//QUATERNION FUNCTIONS:
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_load)(const float* in)
+{
+	return (QMquaternion){ in[0], in[1], in[2], in[3] };
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_store)(QMquaternion q, float* out)
+{
+	out[0] = q.x;
+	out[1] = q.y;
+	out[2] = q.z;
+	out[3] = q.w;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_load_half)(const QMhalf* in)
+{
+	QMquaternion result;
+
+	#if QM_USE_F16C
+
+	result.packed = _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)in));
+
+	#else
+
+	result.x = QM_FUNC_PREFIX(half_to_float)(in[0]);
+	result.y = QM_FUNC_PREFIX(half_to_float)(in[1]);
+	result.z = QM_FUNC_PREFIX(half_to_float)(in[2]);
+	result.w = QM_FUNC_PREFIX(half_to_float)(in[3]);
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_store_half)(QMquaternion q, QMhalf* out)
+{
+	#if QM_USE_F16C
+
+	_mm_storel_epi64((__m128i*)out, _mm_cvtps_ph(q.packed, _MM_FROUND_TO_NEAREST_INT));
+
+	#else
+
+	out[0] = QM_FUNC_PREFIX(float_to_half)(q.x);
+	out[1] = QM_FUNC_PREFIX(float_to_half)(q.y);
+	out[2] = QM_FUNC_PREFIX(float_to_half)(q.z);
+	out[3] = QM_FUNC_PREFIX(float_to_half)(q.w);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_identity)()
+{
+	QMquaternion result;
+
+	result.x = 0.0f;
+	result.y = 0.0f;
+	result.z = 0.0f;
+	result.w = 1.0f;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_add)(QMquaternion q1, QMquaternion q2)
+{
+	QMquaternion result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_add_ps(q1.packed, q2.packed);
+
+	#else
+
+	result.x = q1.x + q2.x;
+	result.y = q1.y + q2.y;
+	result.z = q1.z + q2.z;
+	result.w = q1.w + q2.w;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_sub)(QMquaternion q1, QMquaternion q2)
+{
+	QMquaternion result;
+
+	#if QM_USE_SSE
+
+	result.packed = _mm_sub_ps(q1.packed, q2.packed);
+
+	#else
+
+	result.x = q1.x - q2.x;
+	result.y = q1.y - q2.y;
+	result.z = q1.z - q2.z;
+	result.w = q1.w - q2.w;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_mult)(QMquaternion q1, QMquaternion q2)
+{
+	QMquaternion result;
+
+	#if QM_USE_SSE
+
+	__m128 temp1;
+	__m128 temp2;
+
+	temp1 = _mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(3, 3, 3, 3));
+	temp2 = q2.packed;
+	result.packed = _mm_mul_ps(temp1, temp2);
+
+	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(0, 0, 0, 0)), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f));
+	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(0, 1, 2, 3));
+	result.packed = QM_FUNC_PREFIX(fmadd_sse)(temp1, temp2, result.packed);
+
+	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(1, 1, 1, 1)), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f));
+	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(1, 0, 3, 2));
+	result.packed = QM_FUNC_PREFIX(fmadd_sse)(temp1, temp2, result.packed);
+
+	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(2, 2, 2, 2)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
+	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(2, 3, 0, 1));
+	result.packed = QM_FUNC_PREFIX(fmadd_sse)(temp1, temp2, result.packed);
+
+	#else
+
+	result.x = q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y;
+    result.y = q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x;
+    result.z = q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w;
+    result.w = q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_scale)(QMquaternion q, float s)
+{
+	QMquaternion result;
+
+	#if QM_USE_SSE
+
+	__m128 scale = _mm_set1_ps(s);
+	result.packed = _mm_mul_ps(q.packed, scale);
+
+	#else
+
+	result.x = q.x * s;
+	result.y = q.y * s;
+	result.z = q.z * s;
+	result.w = q.w * s;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(quaternion_dot)(QMquaternion q1, QMquaternion q2)
+{
+	float result;
+
+	#if QM_USE_AVX2
+
+	_mm_store_ss(&result, _mm_dp_ps(q1.packed, q2.packed, 0xF1));
+
+	#elif QM_USE_SSE
+
+	__m128 r = _mm_mul_ps(q1.packed, q2.packed);
+	r = _mm_hadd_ps(r, r);
+	r = _mm_hadd_ps(r, r);
+	_mm_store_ss(&result, r);
+
+	#else
+
+	result = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(quaternion_length)(QMquaternion q)
+{
+	float result;
+
+	result = QM_SQRTF(QM_FUNC_PREFIX(quaternion_dot)(q, q));
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_normalize)(QMquaternion q)
+{
+	QMquaternion result = {0};
+
+	float len = QM_FUNC_PREFIX(quaternion_length)(q);
+	if(len != 0.0f)
+	{
+		#if QM_USE_SSE
+
+		__m128 scale = _mm_set1_ps(len);
+		result.packed = _mm_div_ps(q.packed, scale);
+
+		#else
+
+		float invLen = 1.0f / len;
+
+		result.x = q.x * invLen;
+		result.y = q.y * invLen;
+		result.z = q.z * invLen;
+		result.w = q.w * invLen;
+
+		#endif
+	}
+
+	return result;
+}
+
+//batch normalize, zero-length quaternions become 0 like quaternion_normalize
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_normalize_array_scalar)(const QMquaternion* in, QMquaternion* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		QMquaternion q = in[i];
+
+		float len = QM_SQRTF(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+		float invLen = len != 0.0f ? 1.0f / len : 0.0f;
+
+		out[i].x = q.x * invLen;
+		out[i].y = q.y * invLen;
+		out[i].z = q.z * invLen;
+		out[i].w = q.w * invLen;
+	}
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_normalize_array_sse)(const QMquaternion* in, QMquaternion* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		__m128 q = _mm_loadu_ps(in[i].q);
+
+		__m128 lenSqr = _mm_mul_ps(q, q);
+		lenSqr = _mm_add_ps(lenSqr, _mm_shuffle_ps(lenSqr, lenSqr, _MM_SHUFFLE(2, 3, 0, 1)));
+		lenSqr = _mm_add_ps(lenSqr, _mm_shuffle_ps(lenSqr, lenSqr, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		__m128 len = _mm_sqrt_ps(lenSqr);
+		__m128 result = _mm_and_ps(_mm_div_ps(q, len), _mm_cmpneq_ps(len, _mm_setzero_ps()));
+
+		_mm_storeu_ps(out[i].q, result);
+	}
+}
+
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(quaternion_normalize_array_avx512)(const QMquaternion* in, QMquaternion* out, size_t count)
+{
+	//4 quaternions per iteration, the length is summed within each 128-bit lane
+	for(size_t i = 0; i < count; i += 4)
+	{
+		__mmask16 mask = QM_FUNC_PREFIX(mask16_avx512)((count - i) * 4);
+		__m512 q = _mm512_maskz_loadu_ps(mask, in[i].q);
+
+		__m512 lenSqr = _mm512_mul_ps(q, q);
+		lenSqr = _mm512_add_ps(lenSqr, _mm512_permute_ps(lenSqr, _MM_SHUFFLE(2, 3, 0, 1)));
+		lenSqr = _mm512_add_ps(lenSqr, _mm512_permute_ps(lenSqr, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		__m512 len = _mm512_sqrt_ps(lenSqr);
+		__mmask16 nonZero = _mm512_cmp_ps_mask(len, _mm512_setzero_ps(), _CMP_NEQ_UQ);
+
+		_mm512_mask_storeu_ps(out[i].q, mask, _mm512_maskz_div_ps(nonZero, q, len));
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_normalize_array)(const QMquaternion* in, QMquaternion* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_normalize_array(in, out, count);
+
+	#elif QM_USE_AVX512
+
+	QM_FUNC_PREFIX(quaternion_normalize_array_avx512)(in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(quaternion_normalize_array_sse)(in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(quaternion_normalize_array_scalar)(in, out, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_conjugate)(QMquaternion q)
+{
+	QMquaternion result;
+
+	result.x = -q.x;
+	result.y = -q.y;
+	result.z = -q.z;
+	result.w = q.w;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_inv)(QMquaternion q)
+{
+	QMquaternion result;
+
+	result.x = -q.x;
+	result.y = -q.y;
+	result.z = -q.z;
+	result.w = q.w;
+
+	#if QM_USE_SSE
+
+	__m128 scale = _mm_set1_ps(QM_FUNC_PREFIX(quaternion_dot)(q, q));
+	_mm_div_ps(result.packed, scale);
+
+	#else
+
+	float invLen2 = 1.0f / QM_FUNC_PREFIX(quaternion_dot)(q, q);
+
+	result.x *= invLen2;
+	result.y *= invLen2;
+	result.z *= invLen2;
+	result.w *= invLen2;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_nlerp)(QMquaternion q1, QMquaternion q2, float a)
+{
+	QMquaternion result;
+
+	//take the shortest arc
+	if(QM_FUNC_PREFIX(quaternion_dot)(q1, q2) < 0.0f)
+		q2 = QM_FUNC_PREFIX(quaternion_scale)(q2, -1.0f);
+
+	q1 = QM_FUNC_PREFIX(quaternion_scale)(q1, 1.0f - a);
+	q2 = QM_FUNC_PREFIX(quaternion_scale)(q2, a);
+
+	result = QM_FUNC_PREFIX(quaternion_add)(q1, q2);
+	result = QM_FUNC_PREFIX(quaternion_normalize)(result);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_slerp)(QMquaternion q1, QMquaternion q2, float a)
+{
+	QMquaternion result;
+
+	float cosine = QM_FUNC_PREFIX(quaternion_dot)(q1, q2);
+
+	//take the shortest arc
+	if(cosine < 0.0f)
+	{
+		q2 = QM_FUNC_PREFIX(quaternion_scale)(q2, -1.0f);
+		cosine = -cosine;
+	}
+
+	//the sine of the angle goes to 0 as the quaternions get closer, nlerp is indistinguishable there
+	if(cosine > QM_SLERP_THRESHOLD)
+		return QM_FUNC_PREFIX(quaternion_nlerp)(q1, q2, a);
+
+	#ifdef QM_FAST_TRIG
+
+	float angle = QM_FUNC_PREFIX(acos_poly)(cosine);
+
+	QMvec4 sines = QM_FUNC_PREFIX(vec4_sin)(QM_FUNC_PREFIX(vec4_set)((1.0f - a) * angle, a * angle, angle, 0.0f));
+	float sine1 = sines.x;
+	float sine2 = sines.y;
+	float invSine = 1.0f / sines.z;
+
+	#else
+
+	float angle = QM_ACOSF(cosine);
+
+	float sine1 = QM_SINF((1.0f - a) * angle);
+	float sine2 = QM_SINF(a * angle);
+	float invSine = 1.0f / QM_SINF(angle);
+
+	#endif
+
+	q1 = QM_FUNC_PREFIX(quaternion_scale)(q1, sine1);
+	q2 = QM_FUNC_PREFIX(quaternion_scale)(q2, sine2);
+
+	result = QM_FUNC_PREFIX(quaternion_add)(q1, q2);
+	result = QM_FUNC_PREFIX(quaternion_scale)(result, invSine);
+
+	return result;
+}
+
+//batch blending, interpolates each pair (q1[i], q2[i]) by a[i] along the shortest arc. pairs closer than
+//QM_SLERP_THRESHOLD are nlerped and the rest slerped with one sincos, the results are normalized so neither needs
+//1 / sin(angle). the SIMD paths use the polynomial sin, cos, and acos, see TRIGONOMETRY FUNCTIONS for their error
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_blend_array_scalar)(const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		float alpha = a[i];
+		QMquaternion from = q1[i];
+		QMquaternion to = q2[i];
+
+		float cosine = QM_FUNC_PREFIX(quaternion_dot)(from, to);
+		float sign = cosine < 0.0f ? -1.0f : 1.0f;
+		cosine *= sign;
+
+		float weight1 = 1.0f - alpha;
+		float weight2 = alpha;
+		if(cosine <= QM_SLERP_THRESHOLD)
+		{
+			//sin((1 - a) * angle) = sin(angle) * cos(a * angle) - cos(angle) * sin(a * angle)
+			float sine = QM_SQRTF((1.0f - cosine) * (1.0f + cosine));
+			float sineA, cosineA;
+
+			#ifdef QM_FAST_TRIG
+
+			float angle = QM_FUNC_PREFIX(acos_poly)(cosine);
+			QM_FUNC_PREFIX(sincos_poly)(alpha * angle, &sineA, &cosineA);
+
+			#else
+
+			float angle = QM_ACOSF(cosine);
+			sineA = QM_SINF(alpha * angle);
+			cosineA = QM_COSF(alpha * angle);
+
+			#endif
+
+			weight1 = sine * cosineA - cosine * sineA;
+			weight2 = sineA;
+		}
+
+		QMquaternion result;
+		result.x = from.x * weight1 + to.x * weight2 * sign;
+		result.y = from.y * weight1 + to.y * weight2 * sign;
+		result.z = from.z * weight1 + to.z * weight2 * sign;
+		result.w = from.w * weight1 + to.w * weight2 * sign;
+
+		out[i] = QM_FUNC_PREFIX(quaternion_normalize)(result);
+	}
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_load4_sse)(const QMquaternion* in, __m128* x, __m128* y, __m128* z, __m128* w)
+{
+	*x = _mm_loadu_ps(in[0].q);
+	*y = _mm_loadu_ps(in[1].q);
+	*z = _mm_loadu_ps(in[2].q);
+	*w = _mm_loadu_ps(in[3].q);
+
+	_MM_TRANSPOSE4_PS(*x, *y, *z, *w);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_store4_sse)(__m128 x, __m128 y, __m128 z, __m128 w, QMquaternion* out)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	_mm_storeu_ps(out[0].q, x);
+	_mm_storeu_ps(out[1].q, y);
+	_mm_storeu_ps(out[2].q, z);
+	_mm_storeu_ps(out[3].q, w);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_blend_array_sse)(const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count)
+{
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x1, y1, z1, w1, x2, y2, z2, w2;
+		QM_FUNC_PREFIX(quaternion_load4_sse)(&q1[i], &x1, &y1, &z1, &w1);
+		QM_FUNC_PREFIX(quaternion_load4_sse)(&q2[i], &x2, &y2, &z2, &w2);
+		__m128 alpha = _mm_loadu_ps(&a[i]);
+		__m128 invAlpha = _mm_sub_ps(_mm_set1_ps(1.0f), alpha);
+
+		__m128 cosine = _mm_mul_ps(x1, x2);
+		cosine = QM_FUNC_PREFIX(fmadd_sse)(y1, y2, cosine);
+		cosine = QM_FUNC_PREFIX(fmadd_sse)(z1, z2, cosine);
+		cosine = QM_FUNC_PREFIX(fmadd_sse)(w1, w2, cosine);
+
+		__m128 sign = _mm_and_ps(cosine, _mm_set1_ps(-0.0f));
+		cosine = _mm_xor_ps(cosine, sign);
+
+		__m128 angle = QM_FUNC_PREFIX(acos_sse)(cosine);
+		__m128 sine = _mm_sqrt_ps(_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), cosine), _mm_add_ps(_mm_set1_ps(1.0f), cosine)));
+
+		__m128 sine2, cosine2;
+		QM_FUNC_PREFIX(sincos_sse)(_mm_mul_ps(alpha, angle), &sine2, &cosine2);
+		__m128 sine1 = _mm_sub_ps(_mm_mul_ps(sine, cosine2), _mm_mul_ps(cosine, sine2));
+
+		__m128 lerp = _mm_cmpgt_ps(cosine, _mm_set1_ps(QM_SLERP_THRESHOLD));
+		__m128 weight1 = _mm_or_ps(_mm_and_ps(lerp, invAlpha), _mm_andnot_ps(lerp, sine1));
+		__m128 weight2 = _mm_xor_ps(_mm_or_ps(_mm_and_ps(lerp, alpha), _mm_andnot_ps(lerp, sine2)), sign);
+
+		__m128 x = QM_FUNC_PREFIX(fmadd_sse)(x1, weight1, _mm_mul_ps(x2, weight2));
+		__m128 y = QM_FUNC_PREFIX(fmadd_sse)(y1, weight1, _mm_mul_ps(y2, weight2));
+		__m128 z = QM_FUNC_PREFIX(fmadd_sse)(z1, weight1, _mm_mul_ps(z2, weight2));
+		__m128 w = QM_FUNC_PREFIX(fmadd_sse)(w1, weight1, _mm_mul_ps(w2, weight2));
+
+		__m128 lenSqr = _mm_mul_ps(x, x);
+		lenSqr = QM_FUNC_PREFIX(fmadd_sse)(y, y, lenSqr);
+		lenSqr = QM_FUNC_PREFIX(fmadd_sse)(z, z, lenSqr);
+		lenSqr = QM_FUNC_PREFIX(fmadd_sse)(w, w, lenSqr);
+
+		__m128 len = _mm_sqrt_ps(lenSqr);
+		__m128 invLen = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), len), _mm_cmpneq_ps(len, _mm_setzero_ps()));
+
+		QM_FUNC_PREFIX(quaternion_store4_sse)(_mm_mul_ps(x, invLen), _mm_mul_ps(y, invLen), _mm_mul_ps(z, invLen), _mm_mul_ps(w, invLen), &out[i]);
+	}
+
+	QM_FUNC_PREFIX(quaternion_blend_array_scalar)(&q1[i], &q2[i], &a[i], &out[i], count - i);
+}
+
+#endif
+
+#if QM_USE_AVX2 || QM_USE_DISPATCH
+
+//the lanes of each 128-bit half hold 4 quaternions, the low half quaternions 0-3 and the high half 4-7
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(quaternion_load8_avx)(const QMquaternion* in, __m256* x, __m256* y, __m256* z, __m256* w)
+{
+	__m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in[0].q)), _mm_loadu_ps(in[4].q), 1);
+	__m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in[1].q)), _mm_loadu_ps(in[5].q), 1);
+	__m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in[2].q)), _mm_loadu_ps(in[6].q), 1);
+	__m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in[3].q)), _mm_loadu_ps(in[7].q), 1);
+
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+	__m256 t1 = _mm256_unpacklo_ps(r2, r3);
+	__m256 t2 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+	*x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+	*y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+	*z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	*w = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(quaternion_store8_avx)(__m256 x, __m256 y, __m256 z, __m256 w, QMquaternion* out)
+{
+	__m256 t0 = _mm256_unpacklo_ps(x, y);
+	__m256 t1 = _mm256_unpackhi_ps(x, y);
+	__m256 t2 = _mm256_unpacklo_ps(z, w);
+	__m256 t3 = _mm256_unpackhi_ps(z, w);
+
+	__m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+	_mm_storeu_ps(out[0].q, _mm256_castps256_ps128(r0));
+	_mm_storeu_ps(out[1].q, _mm256_castps256_ps128(r1));
+	_mm_storeu_ps(out[2].q, _mm256_castps256_ps128(r2));
+	_mm_storeu_ps(out[3].q, _mm256_castps256_ps128(r3));
+	_mm_storeu_ps(out[4].q, _mm256_extractf128_ps(r0, 1));
+	_mm_storeu_ps(out[5].q, _mm256_extractf128_ps(r1, 1));
+	_mm_storeu_ps(out[6].q, _mm256_extractf128_ps(r2, 1));
+	_mm_storeu_ps(out[7].q, _mm256_extractf128_ps(r3, 1));
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(quaternion_blend_array_avx2)(const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count)
+{
+	size_t i = 0;
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m256 x1, y1, z1, w1, x2, y2, z2, w2;
+		QM_FUNC_PREFIX(quaternion_load8_avx)(&q1[i], &x1, &y1, &z1, &w1);
+		QM_FUNC_PREFIX(quaternion_load8_avx)(&q2[i], &x2, &y2, &z2, &w2);
+		__m256 alpha = _mm256_loadu_ps(&a[i]);
+		__m256 invAlpha = _mm256_sub_ps(_mm256_set1_ps(1.0f), alpha);
+
+		__m256 cosine = _mm256_mul_ps(x1, x2);
+		cosine = _mm256_fmadd_ps(y1, y2, cosine);
+		cosine = _mm256_fmadd_ps(z1, z2, cosine);
+		cosine = _mm256_fmadd_ps(w1, w2, cosine);
+
+		__m256 sign = _mm256_and_ps(cosine, _mm256_set1_ps(-0.0f));
+		cosine = _mm256_xor_ps(cosine, sign);
+
+		__m256 angle = QM_FUNC_PREFIX(acos_avx)(cosine);
+		__m256 sine = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), cosine), _mm256_add_ps(_mm256_set1_ps(1.0f), cosine)));
+
+		__m256 sine2, cosine2;
+		QM_FUNC_PREFIX(sincos_avx)(_mm256_mul_ps(alpha, angle), &sine2, &cosine2);
+		__m256 sine1 = _mm256_fmsub_ps(sine, cosine2, _mm256_mul_ps(cosine, sine2));
+
+		__m256 lerp = _mm256_cmp_ps(cosine, _mm256_set1_ps(QM_SLERP_THRESHOLD), _CMP_GT_OQ);
+		__m256 weight1 = _mm256_blendv_ps(sine1, invAlpha, lerp);
+		__m256 weight2 = _mm256_xor_ps(_mm256_blendv_ps(sine2, alpha, lerp), sign);
+
+		__m256 x = _mm256_fmadd_ps(x1, weight1, _mm256_mul_ps(x2, weight2));
+		__m256 y = _mm256_fmadd_ps(y1, weight1, _mm256_mul_ps(y2, weight2));
+		__m256 z = _mm256_fmadd_ps(z1, weight1, _mm256_mul_ps(z2, weight2));
+		__m256 w = _mm256_fmadd_ps(w1, weight1, _mm256_mul_ps(w2, weight2));
+
+		__m256 lenSqr = _mm256_mul_ps(x, x);
+		lenSqr = _mm256_fmadd_ps(y, y, lenSqr);
+		lenSqr = _mm256_fmadd_ps(z, z, lenSqr);
+		lenSqr = _mm256_fmadd_ps(w, w, lenSqr);
+
+		__m256 len = _mm256_sqrt_ps(lenSqr);
+		__m256 invLen = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), len), _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+
+		QM_FUNC_PREFIX(quaternion_store8_avx)(_mm256_mul_ps(x, invLen), _mm256_mul_ps(y, invLen), _mm256_mul_ps(z, invLen), _mm256_mul_ps(w, invLen), &out[i]);
+	}
+
+	QM_FUNC_PREFIX(quaternion_blend_array_scalar)(&q1[i], &q2[i], &a[i], &out[i], count - i);
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_blend_array)(const QMquaternion* q1, const QMquaternion* q2, const float* a, QMquaternion* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_blend_array(q1, q2, a, out, count);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(quaternion_blend_array_avx2)(q1, q2, a, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(quaternion_blend_array_sse)(q1, q2, a, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(quaternion_blend_array_scalar)(q1, q2, a, out, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_from_axis_angle)(QMvec3 axis, float angle)
+{
+	QMquaternion result;
+
+	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle * 0.5f);
+	axis = QM_FUNC_PREFIX(vec3_normalize)(axis);
+
+	#ifdef QM_FAST_TRIG
+
+	float sine, cosine;
+	QM_FUNC_PREFIX(sincos_poly)(radians, &sine, &cosine);
+
+	#else
+
+	float sine = QM_SINF(radians);
+	float cosine = QM_COSF(radians);
+
+	#endif
+
+	result.x = axis.x * sine;
+	result.y = axis.y * sine;
+	result.z = axis.z * sine;
+	result.w = cosine;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_from_euler)(QMvec3 angles)
+{
+	QMquaternion result;
+
+	QMvec3 radians;
+	radians.x = QM_FUNC_PREFIX(deg_to_rad)(angles.x * 0.5f);
+	radians.y = QM_FUNC_PREFIX(deg_to_rad)(angles.y * 0.5f);
+	radians.z = QM_FUNC_PREFIX(deg_to_rad)(angles.z * 0.5f);
+
+	#ifdef QM_FAST_TRIG
+
+	QMvec4 sines, cosines;
+	QM_FUNC_PREFIX(vec4_sincos)(QM_FUNC_PREFIX(vec4_set)(radians.x, radians.y, radians.z, 0.0f), &sines, &cosines);
+
+	float sinx = sines.x;
+	float cosx = cosines.x;
+	float siny = sines.y;
+	float cosy = cosines.y;
+	float sinz = sines.z;
+	float cosz = cosines.z;
+
+	#else
+
+	float sinx = QM_SINF(radians.x);
+	float cosx = QM_COSF(radians.x);
+	float siny = QM_SINF(radians.y);
+	float cosy = QM_COSF(radians.y);
+	float sinz = QM_SINF(radians.z);
+	float cosz = QM_COSF(radians.z);
+
+	#endif
+
+	#if QM_USE_SSE
+
+	__m128 packedx = _mm_setr_ps(sinx, cosx, cosx, cosx);
+	__m128 packedy = _mm_setr_ps(cosy, siny, cosy, cosy);
+	__m128 packedz = _mm_setr_ps(cosz, cosz, sinz, cosz);
+
+	__m128 packedxy = _mm_mul_ps(packedx, packedy);
+	__m128 packedz1 = packedz;
+
+	packedx = _mm_shuffle_ps(packedx, packedx, _MM_SHUFFLE(0, 0, 0, 1));
+	packedy = _mm_shuffle_ps(packedy, packedy, _MM_SHUFFLE(1, 1, 0, 1));
+	packedz = _mm_shuffle_ps(packedz, packedz, _MM_SHUFFLE(2, 0, 2, 2));
+
+	#if QM_USE_AVX2
+
+	result.packed = _mm_fmaddsub_ps(packedxy, packedz1, _mm_mul_ps(_mm_mul_ps(packedx, packedy), packedz));
+
+	#else
+
+	result.packed = _mm_addsub_ps(_mm_mul_ps(packedxy, packedz1), _mm_mul_ps(_mm_mul_ps(packedx, packedy), packedz));
+
+	#endif
+
+	#else
+
+	result.x = sinx * cosy * cosz - cosx * siny * sinz;
+	result.y = cosx * siny * cosz + sinx * cosy * sinz;
+	result.z = cosx * cosy * sinz - sinx * siny * cosz;
+	result.w = cosx * cosy * cosz + sinx * siny * sinz;
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(quaternion_to_mat4)(QMquaternion q)
+{
+	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+
+	float x2  = q.x + q.x;
+    float y2  = q.y + q.y;
+    float z2  = q.z + q.z;
+    float xx2 = q.x * x2;
+    float xy2 = q.x * y2;
+    float xz2 = q.x * z2;
+    float yy2 = q.y * y2;
+    float yz2 = q.y * z2;
+    float zz2 = q.z * z2;
+    float sx2 = q.w * x2;
+    float sy2 = q.w * y2;
+    float sz2 = q.w * z2;
+
+	result.m[0][0] = 1.0f - (yy2 + zz2);
+	result.m[0][1] = xy2 - sz2;
+	result.m[0][2] = xz2 + sy2;
+	result.m[1][0] = xy2 + sz2;
+	result.m[1][1] = 1.0f - (xx2 + zz2);
+	result.m[1][2] = yz2 - sx2;
+	result.m[2][0] = xz2 - sy2;
+	result.m[2][1] = yz2 + sx2;
+	result.m[2][2] = 1.0f - (xx2 + yy2);
+
+	return result;
+}
+
+//TRS composition:
+
+//same as translate(t) * quaternion_to_mat4(r) * scale(s), but without the full matrix multiplications
+
+QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_from_trs)(QMvec3 t, QMquaternion r, QMvec3 s)
+{
+	QMmat4 result;
+
+	float x2  = r.x + r.x;
+	float y2  = r.y + r.y;
+	float z2  = r.z + r.z;
+	float xx2 = r.x * x2;
+	float xy2 = r.x * y2;
+	float xz2 = r.x * z2;
+	float yy2 = r.y * y2;
+	float yz2 = r.y * z2;
+	float zz2 = r.z * z2;
+	float wx2 = r.w * x2;
+	float wy2 = r.w * y2;
+	float wz2 = r.w * z2;
+
+	result.m[0][0] = (1.0f - (yy2 + zz2)) * s.x;
+	result.m[0][1] = (xy2 - wz2) * s.x;
+	result.m[0][2] = (xz2 + wy2) * s.x;
+	result.m[0][3] = 0.0f;
+	result.m[1][0] = (xy2 + wz2) * s.y;
+	result.m[1][1] = (1.0f - (xx2 + zz2)) * s.y;
+	result.m[1][2] = (yz2 - wx2) * s.y;
+	result.m[1][3] = 0.0f;
+	result.m[2][0] = (xz2 - wy2) * s.z;
+	result.m[2][1] = (yz2 + wx2) * s.z;
+	result.m[2][2] = (1.0f - (xx2 + yy2)) * s.z;
+	result.m[2][3] = 0.0f;
+	result.m[3][0] = t.x;
+	result.m[3][1] = t.y;
+	result.m[3][2] = t.z;
+	result.m[3][3] = 1.0f;
+
+	return result;
+}
+
+//batch form, out[i] = mat4_from_trs(t[i], r[i], s[i]). the SSE kernel builds 4 matrices at a time in
+//x/y/z/w lanes and transposes them back into columns
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_from_trs_array_scalar)(const QMvec3* t, const QMquaternion* r, const QMvec3* s, QMmat4* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(mat4_from_trs)(t[i], r[i], s[i]);
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_from_trs_array_sse)(const QMvec3* t, const QMquaternion* r, const QMvec3* s, QMmat4* out, size_t count)
+{
+	size_t i = 0;
+
+	__m128 one = _mm_set1_ps(1.0f);
+
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 qx = _mm_loadu_ps(r[i    ].q);
+		__m128 qy = _mm_loadu_ps(r[i + 1].q);
+		__m128 qz = _mm_loadu_ps(r[i + 2].q);
+		__m128 qw = _mm_loadu_ps(r[i + 3].q);
+		_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+		__m128 tx, ty, tz, sx, sy, sz;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&t[i], &tx, &ty, &tz);
+		QM_FUNC_PREFIX(vec3_load4_sse)(&s[i], &sx, &sy, &sz);
+
+		__m128 x2  = _mm_add_ps(qx, qx);
+		__m128 y2  = _mm_add_ps(qy, qy);
+		__m128 z2  = _mm_add_ps(qz, qz);
+		__m128 xx2 = _mm_mul_ps(qx, x2);
+		__m128 xy2 = _mm_mul_ps(qx, y2);
+		__m128 xz2 = _mm_mul_ps(qx, z2);
+		__m128 yy2 = _mm_mul_ps(qy, y2);
+		__m128 yz2 = _mm_mul_ps(qy, z2);
+		__m128 zz2 = _mm_mul_ps(qz, z2);
+		__m128 wx2 = _mm_mul_ps(qw, x2);
+		__m128 wy2 = _mm_mul_ps(qw, y2);
+		__m128 wz2 = _mm_mul_ps(qw, z2);
+
+		__m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy2, zz2)), sx);
+		__m128 m01 = _mm_mul_ps(_mm_sub_ps(xy2, wz2), sx);
+		__m128 m02 = _mm_mul_ps(_mm_add_ps(xz2, wy2), sx);
+		__m128 m03 = _mm_setzero_ps();
+		__m128 m10 = _mm_mul_ps(_mm_add_ps(xy2, wz2), sy);
+		__m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx2, zz2)), sy);
+		__m128 m12 = _mm_mul_ps(_mm_sub_ps(yz2, wx2), sy);
+		__m128 m13 = _mm_setzero_ps();
+		__m128 m20 = _mm_mul_ps(_mm_sub_ps(xz2, wy2), sz);
+		__m128 m21 = _mm_mul_ps(_mm_add_ps(yz2, wx2), sz);
+		__m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx2, yy2)), sz);
+		__m128 m23 = _mm_setzero_ps();
+		__m128 m33 = one;
+
+		_MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+		_MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+		_MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+		_MM_TRANSPOSE4_PS(tx , ty , tz , m33);
+
+		_mm_storeu_ps(out[i    ].m[0], m00); _mm_storeu_ps(out[i    ].m[1], m10); _mm_storeu_ps(out[i    ].m[2], m20); _mm_storeu_ps(out[i    ].m[3], tx );
+		_mm_storeu_ps(out[i + 1].m[0], m01); _mm_storeu_ps(out[i + 1].m[1], m11); _mm_storeu_ps(out[i + 1].m[2], m21); _mm_storeu_ps(out[i + 1].m[3], ty );
+		_mm_storeu_ps(out[i + 2].m[0], m02); _mm_storeu_ps(out[i + 2].m[1], m12); _mm_storeu_ps(out[i + 2].m[2], m22); _mm_storeu_ps(out[i + 2].m[3], tz );
+		_mm_storeu_ps(out[i + 3].m[0], m03); _mm_storeu_ps(out[i + 3].m[1], m13); _mm_storeu_ps(out[i + 3].m[2], m23); _mm_storeu_ps(out[i + 3].m[3], m33);
+	}
+
+	QM_FUNC_PREFIX(mat4_from_trs_array_scalar)(t + i, r + i, s + i, out + i, count - i);
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(mat4_from_trs_array)(const QMvec3* t, const QMquaternion* r, const QMvec3* s, QMmat4* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->mat4_from_trs_array(t, r, s, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(mat4_from_trs_array_sse)(t, r, s, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(mat4_from_trs_array_scalar)(t, r, s, out, count);
+
+	#endif
+}
+
+//----------------------------------------------------------------------//
+//BOUNING BOX FUNCTIONS:
+
+//loading:
+
+QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_load)(const float* in)
+{
+	return (QMbbox2){ { in[0], in[1] }, { in[2], in[3] } };
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_load)(const float* in)
+{
+	return (QMbbox3){ { in[0], in[1], in[2] }, { in[3], in[4], in[5] } };
+}
+
+//storing:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_store)(QMbbox2 b, float* out)
+{
+	out[0] = b.min.x;
+	out[1] = b.min.y;
+	out[2] = b.max.x;
+	out[3] = b.max.y;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_store)(QMbbox3 b, float* out)
+{
+	out[0] = b.min.x;
+	out[1] = b.min.y;
+	out[2] = b.min.z;
+	out[3] = b.max.x;
+	out[4] = b.max.y;
+	out[5] = b.max.z;
+}
+
+//initialized:
+
+QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_initialized)()
+{
+	return (QMbbox2){ { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_initialized)()
+{
+	return (QMbbox3){ { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+}
+
+//union:
+
+QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_union)(QMbbox2 b1, QMbbox2 b2)
+{
+	QMbbox2 result;
+
+	result.min = QM_FUNC_PREFIX(vec2_min)(b1.min, b2.min);
+	result.max = QM_FUNC_PREFIX(vec2_max)(b1.max, b2.max);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union)(QMbbox3 b1, QMbbox3 b2)
+{
+	QMbbox3 result;
+
+	result.min = QM_FUNC_PREFIX(vec3_min)(b1.min, b2.min);
+	result.max = QM_FUNC_PREFIX(vec3_max)(b1.max, b2.max);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_union_inplace)(QMbbox2* b1, QMbbox2 b2)
+{
+	b1->min = QM_FUNC_PREFIX(vec2_min)(b1->min, b2.min);
+	b1->max = QM_FUNC_PREFIX(vec2_max)(b1->max, b2.max);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_union_inplace)(QMbbox3* b1, QMbbox3 b2)
+{
+	b1->min = QM_FUNC_PREFIX(vec3_min)(b1->min, b2.min);
+	b1->max = QM_FUNC_PREFIX(vec3_max)(b1->max, b2.max);
+}
+
+//vector union:
+
+QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_union_vec2)(QMbbox2 b, QMvec2 v)
+{
+	QMbbox2 result;
+
+	result.min = QM_FUNC_PREFIX(vec2_min)(b.min, v);
+	result.max = QM_FUNC_PREFIX(vec2_max)(b.max, v);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3)(QMbbox3 b, QMvec3 v)
+{
+	QMbbox3 result;
+
+	result.min = QM_FUNC_PREFIX(vec3_min)(b.min, v);
+	result.max = QM_FUNC_PREFIX(vec3_max)(b.max, v);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_union_vec2_inplace)(QMbbox2* b, QMvec2 v)
+{
+	b->min = QM_FUNC_PREFIX(vec2_min)(b->min, v);
+	b->max = QM_FUNC_PREFIX(vec2_max)(b->max, v);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_union_vec3_inplace)(QMbbox3* b, QMvec3 v)
+{
+	b->min = QM_FUNC_PREFIX(vec3_min)(b->min, v);
+	b->max = QM_FUNC_PREFIX(vec3_max)(b->max, v);
+}
+
+//packed:
+
+QM_FUNC_ATTRIBS QMbbox3p QM_FUNC_PREFIX(bbox3p_from_bbox3)(QMbbox3 b)
+{
+	QMbbox3p result;
+
+	#if QM_USE_SSE
+
+	result.min.packed = _mm_setr_ps(b.min.x, b.min.y, b.min.z, 0.0f);
+	result.max.packed = _mm_setr_ps(b.max.x, b.max.y, b.max.z, 0.0f);
+
+	#else
+
+	result.min = (QMvec4){ b.min.x, b.min.y, b.min.z, 0.0f };
+	result.max = (QMvec4){ b.max.x, b.max.y, b.max.z, 0.0f };
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3p_to_bbox3)(QMbbox3p b)
+{
+	return (QMbbox3){ { b.min.x, b.min.y, b.min.z }, { b.max.x, b.max.y, b.max.z } };
+}
+
+QM_FUNC_ATTRIBS QMbbox3p QM_FUNC_PREFIX(bbox3p_initialized)()
+{
+	return QM_FUNC_PREFIX(bbox3p_from_bbox3)(QM_FUNC_PREFIX(bbox3_initialized)());
+}
+
+QM_FUNC_ATTRIBS QMbbox3p QM_FUNC_PREFIX(bbox3p_union)(QMbbox3p b1, QMbbox3p b2)
+{
+	QMbbox3p result;
+
+	result.min = QM_FUNC_PREFIX(vec4_min)(b1.min, b2.min);
+	result.max = QM_FUNC_PREFIX(vec4_max)(b1.max, b2.max);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3p_union_inplace)(QMbbox3p* b1, QMbbox3p b2)
+{
+	b1->min = QM_FUNC_PREFIX(vec4_min)(b1->min, b2.min);
+	b1->max = QM_FUNC_PREFIX(vec4_max)(b1->max, b2.max);
+}
+
+QM_FUNC_ATTRIBS QMbbox3p QM_FUNC_PREFIX(bbox3p_union_vec3)(QMbbox3p b, QMvec3 v)
+{
+	QMvec4 p;
+
+	#if QM_USE_SSE
+
+	p.packed = _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+
+	#else
+
+	p = (QMvec4){ v.x, v.y, v.z, 0.0f };
+
+	#endif
+
+	QMbbox3p result;
+
+	result.min = QM_FUNC_PREFIX(vec4_min)(b.min, p);
+	result.max = QM_FUNC_PREFIX(vec4_max)(b.max, p);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3p_union_vec3_inplace)(QMbbox3p* b, QMvec3 v)
+{
+	*b = QM_FUNC_PREFIX(bbox3p_union_vec3)(*b, v);
+}
+
+//array union:
+
+//the SIMD kernels load points and boxes as plain floats, 4 points (or 2 boxes) at a time per 3 SSE loads. the same
+//lane of each load always holds the same component (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3), so the loads are
+//reduced as they are without any shuffles and only sorted into components at the end. 2 sets of accumulators hide
+//the latency of min/max
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_lanes)(QMbbox3 b, const float* mins, const float* maxs, int count, QMbool boxes)
+{
+	//lane k holds float k of a block of points (component k % 3) or of boxes (a min when k % 6 < 3, otherwise a max)
+	for(int k = 0; k < count; k++)
+	{
+		int c = k % 3;
+
+		if(!boxes || k % 6 < 3)
+			b.min.v[c] = QM_MIN(b.min.v[c], mins[k]);
+		if(!boxes || k % 6 >= 3)
+			b.max.v[c] = QM_MAX(b.max.v[c], maxs[k]);
+	}
+
+	return b;
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar)(QMbbox3 b, const QMvec3* v, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		b = QM_FUNC_PREFIX(bbox3_union_vec3)(b, v[i]);
+
+	return b;
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_array_scalar)(QMbbox3 b, const QMbbox3* boxes, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		b = QM_FUNC_PREFIX(bbox3_union)(b, boxes[i]);
+
+	return b;
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(union_floats_sse)(const float* f, size_t numFloats, float* mins, float* maxs)
+{
+	//reduces numFloats (a multiple of 24, at least 24) floats into 12 lanes
+	__m128 min0 = _mm_loadu_ps(f     ), min1 = _mm_loadu_ps(f +  4), min2 = _mm_loadu_ps(f +  8);
+	__m128 min3 = _mm_loadu_ps(f + 12), min4 = _mm_loadu_ps(f + 16), min5 = _mm_loadu_ps(f + 20);
+	__m128 max0 = min0, max1 = min1, max2 = min2, max3 = min3, max4 = min4, max5 = min5;
+
+	for(size_t i = 24; i < numFloats; i += 24)
+	{
+		__m128 l0 = _mm_loadu_ps(f + i     ), l1 = _mm_loadu_ps(f + i +  4), l2 = _mm_loadu_ps(f + i +  8);
+		__m128 l3 = _mm_loadu_ps(f + i + 12), l4 = _mm_loadu_ps(f + i + 16), l5 = _mm_loadu_ps(f + i + 20);
+
+		min0 = _mm_min_ps(min0, l0); min1 = _mm_min_ps(min1, l1); min2 = _mm_min_ps(min2, l2);
+		min3 = _mm_min_ps(min3, l3); min4 = _mm_min_ps(min4, l4); min5 = _mm_min_ps(min5, l5);
+		max0 = _mm_max_ps(max0, l0); max1 = _mm_max_ps(max1, l1); max2 = _mm_max_ps(max2, l2);
+		max3 = _mm_max_ps(max3, l3); max4 = _mm_max_ps(max4, l4); max5 = _mm_max_ps(max5, l5);
+	}
+
+	_mm_storeu_ps(mins    , _mm_min_ps(min0, min3));
+	_mm_storeu_ps(mins + 4, _mm_min_ps(min1, min4));
+	_mm_storeu_ps(mins + 8, _mm_min_ps(min2, min5));
+	_mm_storeu_ps(maxs    , _mm_max_ps(max0, max3));
+	_mm_storeu_ps(maxs + 4, _mm_max_ps(max1, max4));
+	_mm_storeu_ps(maxs + 8, _mm_max_ps(max2, max5));
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array_sse)(QMbbox3 b, const QMvec3* v, size_t count)
+{
+	size_t n = count & ~(size_t)7;
+	if(n > 0)
+	{
+		float mins[12], maxs[12];
+		QM_FUNC_PREFIX(union_floats_sse)((const float*)v, n * 3, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 12, 0);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar)(b, v + n, count - n);
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_array_sse)(QMbbox3 b, const QMbbox3* boxes, size_t count)
+{
+	size_t n = count & ~(size_t)3;
+	if(n > 0)
+	{
+		float mins[12], maxs[12];
+		QM_FUNC_PREFIX(union_floats_sse)((const float*)boxes, n * 6, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 12, 1);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_array_scalar)(b, boxes + n, count - n);
+}
+
+#endif
+
+#if QM_USE_AVX2 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(union_floats_avx2)(const float* f, size_t numFloats, float* mins, float* maxs)
+{
+	//reduces numFloats (a multiple of 48, at least 48) floats into 24 lanes
+	__m256 min0 = _mm256_loadu_ps(f     ), min1 = _mm256_loadu_ps(f +  8), min2 = _mm256_loadu_ps(f + 16);
+	__m256 min3 = _mm256_loadu_ps(f + 24), min4 = _mm256_loadu_ps(f + 32), min5 = _mm256_loadu_ps(f + 40);
+	__m256 max0 = min0, max1 = min1, max2 = min2, max3 = min3, max4 = min4, max5 = min5;
+
+	for(size_t i = 48; i < numFloats; i += 48)
+	{
+		__m256 l0 = _mm256_loadu_ps(f + i     ), l1 = _mm256_loadu_ps(f + i +  8), l2 = _mm256_loadu_ps(f + i + 16);
+		__m256 l3 = _mm256_loadu_ps(f + i + 24), l4 = _mm256_loadu_ps(f + i + 32), l5 = _mm256_loadu_ps(f + i + 40);
+
+		min0 = _mm256_min_ps(min0, l0); min1 = _mm256_min_ps(min1, l1); min2 = _mm256_min_ps(min2, l2);
+		min3 = _mm256_min_ps(min3, l3); min4 = _mm256_min_ps(min4, l4); min5 = _mm256_min_ps(min5, l5);
+		max0 = _mm256_max_ps(max0, l0); max1 = _mm256_max_ps(max1, l1); max2 = _mm256_max_ps(max2, l2);
+		max3 = _mm256_max_ps(max3, l3); max4 = _mm256_max_ps(max4, l4); max5 = _mm256_max_ps(max5, l5);
+	}
+
+	_mm256_storeu_ps(mins     , _mm256_min_ps(min0, min3));
+	_mm256_storeu_ps(mins +  8, _mm256_min_ps(min1, min4));
+	_mm256_storeu_ps(mins + 16, _mm256_min_ps(min2, min5));
+	_mm256_storeu_ps(maxs     , _mm256_max_ps(max0, max3));
+	_mm256_storeu_ps(maxs +  8, _mm256_max_ps(max1, max4));
+	_mm256_storeu_ps(maxs + 16, _mm256_max_ps(max2, max5));
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array_avx2)(QMbbox3 b, const QMvec3* v, size_t count)
+{
+	size_t n = count & ~(size_t)15;
+	if(n > 0)
+	{
+		float mins[24], maxs[24];
+		QM_FUNC_PREFIX(union_floats_avx2)((const float*)v, n * 3, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 24, 0);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar)(b, v + n, count - n);
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 QMbbox3 QM_FUNC_PREFIX(bbox3_union_array_avx2)(QMbbox3 b, const QMbbox3* boxes, size_t count)
+{
+	size_t n = count & ~(size_t)7;
+	if(n > 0)
+	{
+		float mins[24], maxs[24];
+		QM_FUNC_PREFIX(union_floats_avx2)((const float*)boxes, n * 6, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 24, 1);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_array_scalar)(b, boxes + n, count - n);
+}
+
+#endif
+
+#if QM_USE_AVX512 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 void QM_FUNC_PREFIX(union_floats_avx512)(const float* f, size_t numFloats, float* mins, float* maxs)
+{
+	//reduces numFloats (a multiple of 96, at least 96) floats into 48 lanes
+	__m512 min0 = _mm512_loadu_ps(f     ), min1 = _mm512_loadu_ps(f + 16), min2 = _mm512_loadu_ps(f + 32);
+	__m512 min3 = _mm512_loadu_ps(f + 48), min4 = _mm512_loadu_ps(f + 64), min5 = _mm512_loadu_ps(f + 80);
+	__m512 max0 = min0, max1 = min1, max2 = min2, max3 = min3, max4 = min4, max5 = min5;
+
+	for(size_t i = 96; i < numFloats; i += 96)
+	{
+		__m512 l0 = _mm512_loadu_ps(f + i     ), l1 = _mm512_loadu_ps(f + i + 16), l2 = _mm512_loadu_ps(f + i + 32);
+		__m512 l3 = _mm512_loadu_ps(f + i + 48), l4 = _mm512_loadu_ps(f + i + 64), l5 = _mm512_loadu_ps(f + i + 80);
+
+		min0 = _mm512_min_ps(min0, l0); min1 = _mm512_min_ps(min1, l1); min2 = _mm512_min_ps(min2, l2);
+		min3 = _mm512_min_ps(min3, l3); min4 = _mm512_min_ps(min4, l4); min5 = _mm512_min_ps(min5, l5);
+		max0 = _mm512_max_ps(max0, l0); max1 = _mm512_max_ps(max1, l1); max2 = _mm512_max_ps(max2, l2);
+		max3 = _mm512_max_ps(max3, l3); max4 = _mm512_max_ps(max4, l4); max5 = _mm512_max_ps(max5, l5);
+	}
+
+	_mm512_storeu_ps(mins     , _mm512_min_ps(min0, min3));
+	_mm512_storeu_ps(mins + 16, _mm512_min_ps(min1, min4));
+	_mm512_storeu_ps(mins + 32, _mm512_min_ps(min2, min5));
+	_mm512_storeu_ps(maxs     , _mm512_max_ps(max0, max3));
+	_mm512_storeu_ps(maxs + 16, _mm512_max_ps(max1, max4));
+	_mm512_storeu_ps(maxs + 32, _mm512_max_ps(max2, max5));
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array_avx512)(QMbbox3 b, const QMvec3* v, size_t count)
+{
+	size_t n = count & ~(size_t)31;
+	if(n > 0)
+	{
+		float mins[48], maxs[48];
+		QM_FUNC_PREFIX(union_floats_avx512)((const float*)v, n * 3, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 48, 0);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar)(b, v + n, count - n);
+}
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX512 QMbbox3 QM_FUNC_PREFIX(bbox3_union_array_avx512)(QMbbox3 b, const QMbbox3* boxes, size_t count)
+{
+	size_t n = count & ~(size_t)15;
+	if(n > 0)
+	{
+		float mins[48], maxs[48];
+		QM_FUNC_PREFIX(union_floats_avx512)((const float*)boxes, n * 6, mins, maxs);
+		b = QM_FUNC_PREFIX(bbox3_union_lanes)(b, mins, maxs, 48, 1);
+	}
+
+	return QM_FUNC_PREFIX(bbox3_union_array_scalar)(b, boxes + n, count - n);
+}
+
+#endif
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array)(QMbbox3 b, const QMvec3* v, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	return QM_FUNC_PREFIX(dispatch_table)()->bbox3_union_vec3_array(b, v, count);
+
+	#elif QM_USE_AVX512
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_avx512)(b, v, count);
+
+	#elif QM_USE_AVX2
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_avx2)(b, v, count);
+
+	#elif QM_USE_SSE
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_sse)(b, v, count);
+
+	#else
+
+	return QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar)(b, v, count);
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_array)(QMbbox3 b, const QMbbox3* boxes, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	return QM_FUNC_PREFIX(dispatch_table)()->bbox3_union_array(b, boxes, count);
+
+	#elif QM_USE_AVX512
+
+	return QM_FUNC_PREFIX(bbox3_union_array_avx512)(b, boxes, count);
+
+	#elif QM_USE_AVX2
+
+	return QM_FUNC_PREFIX(bbox3_union_array_avx2)(b, boxes, count);
+
+	#elif QM_USE_SSE
+
+	return QM_FUNC_PREFIX(bbox3_union_array_sse)(b, boxes, count);
+
+	#else
+
+	return QM_FUNC_PREFIX(bbox3_union_array_scalar)(b, boxes, count);
+
+	#endif
+}
+
+//parallel array union:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_union_chunk_task)(void* data, uint32_t index)
+{
+	QMunionParallelState* s = (QMunionParallelState*)data;
+	size_t first = s->chunkFirst[index];
+	size_t n = s->chunkFirst[index + 1] - first;
+
+	if(s->points)
+		s->chunkBounds[index] = QM_FUNC_PREFIX(bbox3_union_vec3_array)(QM_FUNC_PREFIX(bbox3_initialized)(), s->points + first, n);
+	else
+		s->chunkBounds[index] = QM_FUNC_PREFIX(bbox3_union_array)(QM_FUNC_PREFIX(bbox3_initialized)(), s->boxes + first, n);
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_parallel)(QMbbox3 b, QMunionParallelState* s, size_t count, QMparallelForFunc parallelFor, void* user)
+{
+	size_t numChunks = (count + QM_UNION_PARALLEL_MIN_CHUNK - 1) / QM_UNION_PARALLEL_MIN_CHUNK;
+	numChunks = QM_MIN(numChunks, (size_t)QM_UNION_PARALLEL_CHUNKS);
+	if(numChunks <= 1)
+	{
+		if(s->points)
+			return QM_FUNC_PREFIX(bbox3_union_vec3_array)(b, s->points, count);
+		else
+			return QM_FUNC_PREFIX(bbox3_union_array)(b, s->boxes, count);
+	}
+
+	for(size_t c = 0; c <= numChunks; c++)
+		s->chunkFirst[c] = count / numChunks * c + QM_MIN(c, count % numChunks);
+
+	parallelFor(user, QM_FUNC_PREFIX(bbox3_union_chunk_task), s, (uint32_t)numChunks);
+
+	for(size_t c = 0; c < numChunks; c++)
+		b = QM_FUNC_PREFIX(bbox3_union)(b, s->chunkBounds[c]);
+
+	return b;
+}
+
+//splits the array into chunks of at least QM_UNION_PARALLEL_MIN_CHUNK elements, reduces each chunk as one task, then
+//merges the chunks' boxes. the result is the same as the serial functions no matter how the tasks are scheduled
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3_array_parallel)(QMbbox3 b, const QMvec3* v, size_t count, QMparallelForFunc parallelFor, void* user)
+{
+	QMunionParallelState state;
+	state.points = v;
+	state.boxes = NULL;
+
+	return QM_FUNC_PREFIX(bbox3_union_parallel)(b, &state, count, parallelFor, user);
+}
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_array_parallel)(QMbbox3 b, const QMbbox3* boxes, size_t count, QMparallelForFunc parallelFor, void* user)
+{
+	QMunionParallelState state;
+	state.points = NULL;
+	state.boxes = boxes;
+
+	return QM_FUNC_PREFIX(bbox3_union_parallel)(b, &state, count, parallelFor, user);
+}
+
+//extent:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_extent)(QMbbox2 b)
+{
+	return QM_FUNC_PREFIX(vec2_sub)(b.max, b.min);
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_extent)(QMbbox3 b)
+{
+	return QM_FUNC_PREFIX(vec3_sub)(b.max, b.min);
+}
+
+//centroid:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_centroid)(QMbbox2 b)
+{
+	return QM_FUNC_PREFIX(vec2_scale)(QM_FUNC_PREFIX(vec2_add)(b.max, b.min), 0.5f);
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_centroid)(QMbbox3 b)
+{
+	return QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(vec3_add)(b.max, b.min), 0.5f);
+}
+
+//offset:
+
+QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_offset)(QMbbox2 b, QMvec2 v)
+{
+	return QM_FUNC_PREFIX(vec2_div)(QM_FUNC_PREFIX(vec2_sub)(v, b.min), QM_FUNC_PREFIX(bbox2_extent)(b));
+}
+
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_offset)(QMbbox3 b, QMvec3 v)
+{
+	return QM_FUNC_PREFIX(vec3_div)(QM_FUNC_PREFIX(vec3_sub)(v, b.min), QM_FUNC_PREFIX(bbox3_extent)(b));
+}
+
+//perimeter/sa:
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bbox2_perimeter)(QMbbox2 b)
+{
+	float result = 0.0f;
+
+	QMvec2 extent = QM_FUNC_PREFIX(bbox2_extent)(b);
+	
+	result += extent.x;
+	result += extent.y;
+	result *= 2.0f;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bbox3_surface_area)(QMbbox3 b)
+{
+	float result = 0.0f;
+
+	QMvec3 extent = QM_FUNC_PREFIX(bbox3_extent)(b);
+
+	result += extent.x * extent.y;
+	result += extent.x * extent.z;
+	result += extent.y * extent.z;
+	result *= 2.0f;
+
+	return result;
+}
+
+//transformation:
+
+//Arvo's method, the center is transformed as a point and the extent by the absolute value of the upper 3x3, which
+//gives the same box as transforming all 8 corners and taking their union. m must be affine
+
+QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_transform)(QMmat4 m, QMbbox3 b)
+{
+	QMvec3 center = QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(vec3_add)(b.min, b.max), 0.5f);
+	QMvec3 extent = QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(vec3_sub)(b.max, b.min), 0.5f);
+
+	center = QM_FUNC_PREFIX(mat4_transform_vec3)(m, center);
+
+	QMvec3 newExtent;
+	newExtent.x = QM_FUNC_PREFIX(absf)(m.m[0][0]) * extent.x + QM_FUNC_PREFIX(absf)(m.m[1][0]) * extent.y + QM_FUNC_PREFIX(absf)(m.m[2][0]) * extent.z;
+	newExtent.y = QM_FUNC_PREFIX(absf)(m.m[0][1]) * extent.x + QM_FUNC_PREFIX(absf)(m.m[1][1]) * extent.y + QM_FUNC_PREFIX(absf)(m.m[2][1]) * extent.z;
+	newExtent.z = QM_FUNC_PREFIX(absf)(m.m[0][2]) * extent.x + QM_FUNC_PREFIX(absf)(m.m[1][2]) * extent.y + QM_FUNC_PREFIX(absf)(m.m[2][2]) * extent.z;
+
+	QMbbox3 result;
+	result.min = QM_FUNC_PREFIX(vec3_sub)(center, newExtent);
+	result.max = QM_FUNC_PREFIX(vec3_add)(center, newExtent);
+
+	return result;
+}
+
+//array transformation:
+
+//out[i] = bbox3_transform(m[i], in[i]), for finding the world space bounds of many instances at once.
+//out may be the same array as in
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_transform_array_scalar)(const QMmat4* m, const QMbbox3* in, QMbbox3* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(bbox3_transform)(m[i], in[i]);
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_transform_array_sse)(const QMmat4* m, const QMbbox3* in, QMbbox3* out, size_t count)
+{
+	__m128 signMask = _mm_set1_ps(-0.0f);
+	__m128 half = _mm_set1_ps(0.5f);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		if(i + QM_PREFETCH_DISTANCE < count)
+			_mm_prefetch((const char*)(m + i + QM_PREFETCH_DISTANCE), _MM_HINT_T0);
+
+		//each box is 6 floats, loaded as (min.x, min.y, min.z, max.x) and (max.y, max.z)
+		const float* f = (const float*)&in[i];
+		__m128 lo = _mm_loadu_ps(f);
+		__m128 hi = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(f + 4));
+
+		__m128 boxMax = _mm_shuffle_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(0, 0, 3, 3)), hi, _MM_SHUFFLE(1, 1, 2, 0));
+		__m128 center = _mm_mul_ps(_mm_add_ps(lo, boxMax), half);
+		__m128 extent = _mm_mul_ps(_mm_sub_ps(boxMax, lo), half);
+
+		__m128 c0 = _mm_loadu_ps(m[i].m[0]);
+		__m128 c1 = _mm_loadu_ps(m[i].m[1]);
+		__m128 c2 = _mm_loadu_ps(m[i].m[2]);
+		__m128 c3 = _mm_loadu_ps(m[i].m[3]);
+
+		__m128 newCenter = _mm_mul_ps(c0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0)));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))));
+		newCenter = _mm_add_ps(newCenter, c3);
+
+		__m128 newExtent = _mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0)));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1))));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2))));
+
+		__m128 newMin = _mm_sub_ps(newCenter, newExtent);
+		__m128 newMax = _mm_add_ps(newCenter, newExtent);
+
+		//packed back into (min.x, min.y, min.z, max.x) and (max.y, max.z), so nothing past the box is written
+		float* o = (float*)&out[i];
+		_mm_storeu_ps(o, _mm_shuffle_ps(newMin, _mm_shuffle_ps(newMin, newMax, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storel_pi((__m64*)(o + 4), _mm_shuffle_ps(newMax, newMax, _MM_SHUFFLE(2, 2, 2, 1)));
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_transform_array)(const QMmat4* m, const QMbbox3* in, QMbbox3* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->bbox3_transform_array(m, in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(bbox3_transform_array_sse)(m, in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(bbox3_transform_array_scalar)(m, in, out, count);
+
+	#endif
+}
+
+//wide loading (transposes an array of QMbbox3s into lanes):
+
+QM_FUNC_ATTRIBS QMbbox3x4 QM_FUNC_PREFIX(bbox3x4_load)(const QMbbox3* in)
+{
+	QMbbox3x4 result;
+
+	#if QM_USE_SSE
+
+	QM_FUNC_PREFIX(bbox3_load4_sse)(in, &result.min.packed[0], &result.min.packed[1], &result.min.packed[2],
+	                                    &result.max.packed[0], &result.max.packed[1], &result.max.packed[2]);
+
+	#else
+
+	for(int i = 0; i < 4; i++)
+		for(int a = 0; a < 3; a++)
+		{
+			result.min.v[a][i] = in[i].min.v[a];
+			result.max.v[a][i] = in[i].max.v[a];
+		}
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMbbox3x8 QM_FUNC_PREFIX(bbox3x8_load)(const QMbbox3* in)
+{
+	QMbbox3x8 result;
+
+	#if QM_USE_AVX
+
+	__m128 lo[6], hi[6];
+	QM_FUNC_PREFIX(bbox3_load4_sse)(in    , &lo[0], &lo[1], &lo[2], &lo[3], &lo[4], &lo[5]);
+	QM_FUNC_PREFIX(bbox3_load4_sse)(in + 4, &hi[0], &hi[1], &hi[2], &hi[3], &hi[4], &hi[5]);
+
+	for(int a = 0; a < 3; a++)
+	{
+		result.min.packed[a] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[a    ]), hi[a    ], 1);
+		result.max.packed[a] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[a + 3]), hi[a + 3], 1);
+	}
+
+	#else
+
+	for(int i = 0; i < 8; i++)
+		for(int a = 0; a < 3; a++)
+		{
+			result.min.v[a][i] = in[i].min.v[a];
+			result.max.v[a][i] = in[i].max.v[a];
+		}
+
+	#endif
+
+	return result;
+}
+
+//----------------------------------------------------------------------//
+//RAY FUNCTIONS:
+
+//creation:
+
+QM_FUNC_ATTRIBS QMray QM_FUNC_PREFIX(ray_create)(QMvec3 origin, QMvec3 dir)
+{
+	QMray result;
+
+	result.origin = origin;
+	result.dir = dir;
+	result.invDir.x = 1.0f / dir.x;
+	result.invDir.y = 1.0f / dir.y;
+	result.invDir.z = 1.0f / dir.z;
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMrayx4 QM_FUNC_PREFIX(rayx4_create)(QMvec3x4 origin, QMvec3x4 dir)
+{
+	QMrayx4 result;
+
+	result.origin = origin;
+	result.dir = dir;
+
+	#if QM_USE_SSE
+
+	for(int a = 0; a < 3; a++)
+		result.invDir.packed[a] = _mm_div_ps(_mm_set1_ps(1.0f), dir.packed[a]);
+
+	#else
+
+	for(int a = 0; a < 3; a++)
+		for(int i = 0; i < 4; i++)
+			result.invDir.v[a][i] = 1.0f / dir.v[a][i];
+
+	#endif
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMrayx8 QM_FUNC_PREFIX(rayx8_create)(QMvec3x8 origin, QMvec3x8 dir)
+{
+	QMrayx8 result;
+
+	result.origin = origin;
+	result.dir = dir;
+
+	#if QM_USE_AVX
+
+	for(int a = 0; a < 3; a++)
+		result.invDir.packed[a] = _mm256_div_ps(_mm256_set1_ps(1.0f), dir.packed[a]);
+
+	#else
+
+	for(int a = 0; a < 3; a++)
+		for(int i = 0; i < 8; i++)
+			result.invDir.v[a][i] = 1.0f / dir.v[a][i];
+
+	#endif
+
+	return result;
+}
+
+//slab tests:
+//each one clips [0, tMax] against the 3 slabs of the box and hits when the interval is not empty, tNear and tFar
+//get the clipped interval whether or not it hit. a ray lying in the plane of a slab gives 0 * inf = NaN, which
+//the min/max below drop in the same way as _mm_min_ps/_mm_max_ps so every path agrees
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(ray_slab)(float origin, float invDir, float min, float max, float* tNear, float* tFar)
+{
+	float t0 = (min - origin) * invDir;
+	float t1 = (max - origin) * invDir;
+
+	float tEnter = t0 < t1 ? t0 : t1;
+	float tExit  = t0 > t1 ? t0 : t1;
+
+	*tNear = tEnter > *tNear ? tEnter : *tNear;
+	*tFar  = tExit  < *tFar  ? tExit  : *tFar;
+}
+
+#if QM_USE_SSE
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(ray_slab_sse)(__m128 origin, __m128 invDir, __m128 min, __m128 max, __m128* tNear, __m128* tFar)
+{
+	__m128 t0 = _mm_mul_ps(_mm_sub_ps(min, origin), invDir);
+	__m128 t1 = _mm_mul_ps(_mm_sub_ps(max, origin), invDir);
+
+	*tNear = _mm_max_ps(_mm_min_ps(t0, t1), *tNear);
+	*tFar  = _mm_min_ps(_mm_max_ps(t0, t1), *tFar);
+}
+
+#endif
+
+#if QM_USE_AVX
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(ray_slab_avx)(__m256 origin, __m256 invDir, __m256 min, __m256 max, __m256* tNear, __m256* tFar)
+{
+	__m256 t0 = _mm256_mul_ps(_mm256_sub_ps(min, origin), invDir);
+	__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(max, origin), invDir);
+
+	*tNear = _mm256_max_ps(_mm256_min_ps(t0, t1), *tNear);
+	*tFar  = _mm256_min_ps(_mm256_max_ps(t0, t1), *tFar);
+}
+
+#endif
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(ray_intersect_bbox3)(QMray r, QMbbox3 b, float tMax, float* tNear, float* tFar)
+{
+	float tEnter = 0.0f;
+	float tExit  = tMax;
+
+	QM_FUNC_PREFIX(ray_slab)(r.origin.x, r.invDir.x, b.min.x, b.max.x, &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab)(r.origin.y, r.invDir.y, b.min.y, b.max.y, &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab)(r.origin.z, r.invDir.z, b.min.z, b.max.z, &tEnter, &tExit);
+
+	*tNear = tEnter;
+	*tFar = tExit;
+	return tEnter <= tExit;
+}
+
+//one ray against 4 or 8 boxes, for the children of wide bounding volume hierarchy nodes. returns a mask with bit i
+//set when box i was hit
+
+QM_FUNC_ATTRIBS int QM_FUNC_PREFIX(ray_intersect_bbox3x4)(QMray r, QMbbox3x4 b, float tMax, QMvec4* tNear, QMvec4* tFar)
+{
+	#if QM_USE_SSE
+
+	__m128 tEnter = _mm_setzero_ps();
+	__m128 tExit  = _mm_set1_ps(tMax);
+
+	QM_FUNC_PREFIX(ray_slab_sse)(_mm_set1_ps(r.origin.x), _mm_set1_ps(r.invDir.x), b.min.packed[0], b.max.packed[0], &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_sse)(_mm_set1_ps(r.origin.y), _mm_set1_ps(r.invDir.y), b.min.packed[1], b.max.packed[1], &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_sse)(_mm_set1_ps(r.origin.z), _mm_set1_ps(r.invDir.z), b.min.packed[2], b.max.packed[2], &tEnter, &tExit);
+
+	tNear->packed = tEnter;
+	tFar->packed = tExit;
+	return _mm_movemask_ps(_mm_cmple_ps(tEnter, tExit));
+
+	#else
+
+	int result = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		tNear->v[i] = 0.0f;
+		tFar->v[i] = tMax;
+
+		for(int a = 0; a < 3; a++)
+			QM_FUNC_PREFIX(ray_slab)(r.origin.v[a], r.invDir.v[a], b.min.v[a][i], b.max.v[a][i], &tNear->v[i], &tFar->v[i]);
+
+		result |= (tNear->v[i] <= tFar->v[i]) << i;
+	}
+
+	return result;
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS int QM_FUNC_PREFIX(ray_intersect_bbox3x8)(QMray r, QMbbox3x8 b, float tMax, QMvec8* tNear, QMvec8* tFar)
+{
+	#if QM_USE_AVX
+
+	__m256 tEnter = _mm256_setzero_ps();
+	__m256 tExit  = _mm256_set1_ps(tMax);
+
+	QM_FUNC_PREFIX(ray_slab_avx)(_mm256_set1_ps(r.origin.x), _mm256_set1_ps(r.invDir.x), b.min.packed[0], b.max.packed[0], &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_avx)(_mm256_set1_ps(r.origin.y), _mm256_set1_ps(r.invDir.y), b.min.packed[1], b.max.packed[1], &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_avx)(_mm256_set1_ps(r.origin.z), _mm256_set1_ps(r.invDir.z), b.min.packed[2], b.max.packed[2], &tEnter, &tExit);
+
+	tNear->packed = tEnter;
+	tFar->packed = tExit;
+	return _mm256_movemask_ps(_mm256_cmp_ps(tEnter, tExit, _CMP_LE_OQ));
+
+	#else
+
+	int result = 0;
+
+	for(int i = 0; i < 8; i++)
+	{
+		tNear->v[i] = 0.0f;
+		tFar->v[i] = tMax;
+
+		for(int a = 0; a < 3; a++)
+			QM_FUNC_PREFIX(ray_slab)(r.origin.v[a], r.invDir.v[a], b.min.v[a][i], b.max.v[a][i], &tNear->v[i], &tFar->v[i]);
+
+		result |= (tNear->v[i] <= tFar->v[i]) << i;
+	}
+
+	return result;
+
+	#endif
+}
+
+//a packet of 4 or 8 rays against one box, each ray clipped to its own tMax. returns a mask with bit i set when
+//ray i hit the box
+
+QM_FUNC_ATTRIBS int QM_FUNC_PREFIX(rayx4_intersect_bbox3)(QMrayx4 r, QMbbox3 b, QMvec4 tMax, QMvec4* tNear, QMvec4* tFar)
+{
+	#if QM_USE_SSE
+
+	__m128 tEnter = _mm_setzero_ps();
+	__m128 tExit  = tMax.packed;
+
+	QM_FUNC_PREFIX(ray_slab_sse)(r.origin.packed[0], r.invDir.packed[0], _mm_set1_ps(b.min.x), _mm_set1_ps(b.max.x), &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_sse)(r.origin.packed[1], r.invDir.packed[1], _mm_set1_ps(b.min.y), _mm_set1_ps(b.max.y), &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_sse)(r.origin.packed[2], r.invDir.packed[2], _mm_set1_ps(b.min.z), _mm_set1_ps(b.max.z), &tEnter, &tExit);
+
+	tNear->packed = tEnter;
+	tFar->packed = tExit;
+	return _mm_movemask_ps(_mm_cmple_ps(tEnter, tExit));
+
+	#else
+
+	int result = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		tNear->v[i] = 0.0f;
+		tFar->v[i] = tMax.v[i];
+
+		for(int a = 0; a < 3; a++)
+			QM_FUNC_PREFIX(ray_slab)(r.origin.v[a][i], r.invDir.v[a][i], b.min.v[a], b.max.v[a], &tNear->v[i], &tFar->v[i]);
+
+		result |= (tNear->v[i] <= tFar->v[i]) << i;
+	}
+
+	return result;
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS int QM_FUNC_PREFIX(rayx8_intersect_bbox3)(QMrayx8 r, QMbbox3 b, QMvec8 tMax, QMvec8* tNear, QMvec8* tFar)
+{
+	#if QM_USE_AVX
+
+	__m256 tEnter = _mm256_setzero_ps();
+	__m256 tExit  = tMax.packed;
+
+	QM_FUNC_PREFIX(ray_slab_avx)(r.origin.packed[0], r.invDir.packed[0], _mm256_set1_ps(b.min.x), _mm256_set1_ps(b.max.x), &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_avx)(r.origin.packed[1], r.invDir.packed[1], _mm256_set1_ps(b.min.y), _mm256_set1_ps(b.max.y), &tEnter, &tExit);
+	QM_FUNC_PREFIX(ray_slab_avx)(r.origin.packed[2], r.invDir.packed[2], _mm256_set1_ps(b.min.z), _mm256_set1_ps(b.max.z), &tEnter, &tExit);
+
+	tNear->packed = tEnter;
+	tFar->packed = tExit;
+	return _mm256_movemask_ps(_mm256_cmp_ps(tEnter, tExit, _CMP_LE_OQ));
+
+	#else
+
+	int result = 0;
+
+	for(int i = 0; i < 8; i++)
+	{
+		tNear->v[i] = 0.0f;
+		tFar->v[i] = tMax.v[i];
+
+		for(int a = 0; a < 3; a++)
+			QM_FUNC_PREFIX(ray_slab)(r.origin.v[a][i], r.invDir.v[a][i], b.min.v[a], b.max.v[a], &tNear->v[i], &tFar->v[i]);
+
+		result |= (tNear->v[i] <= tFar->v[i]) << i;
+	}
+
+	return result;
+
+	#endif
+}
+
+//triangle tests:
+//Moller-Trumbore, with t in [0, tMax). a triangle with no area never hits, so unused lanes can be filled with
+//degenerate triangles. returns whether any triangle was hit, and only then fills hit with the nearest one, so
+//passing hit->t as tMax while testing several groups keeps the nearest hit overall
+
+QM_FUNC_ATTRIBS QMtrianglex4 QM_FUNC_PREFIX(trianglex4_load)(const QMvec3* v0, const QMvec3* v1, const QMvec3* v2)
+{
+	QMtrianglex4 result;
+
+	result.v0 = QM_FUNC_PREFIX(vec3x4_load)(v0);
+	result.e1 = QM_FUNC_PREFIX(vec3x4_sub)(QM_FUNC_PREFIX(vec3x4_load)(v1), result.v0);
+	result.e2 = QM_FUNC_PREFIX(vec3x4_sub)(QM_FUNC_PREFIX(vec3x4_load)(v2), result.v0);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMtrianglex8 QM_FUNC_PREFIX(trianglex8_load)(const QMvec3* v0, const QMvec3* v1, const QMvec3* v2)
+{
+	QMtrianglex8 result;
+
+	result.v0 = QM_FUNC_PREFIX(vec3x8_load)(v0);
+	result.e1 = QM_FUNC_PREFIX(vec3x8_sub)(QM_FUNC_PREFIX(vec3x8_load)(v1), result.v0);
+	result.e2 = QM_FUNC_PREFIX(vec3x8_sub)(QM_FUNC_PREFIX(vec3x8_load)(v2), result.v0);
+
+	return result;
+}
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(ray_intersect_trianglex4)(QMray r, QMtrianglex4 tri, float tMax, QMrayHit* hit)
+{
+	QMvec3x4 dir = QM_FUNC_PREFIX(vec3x4_full)(r.dir);
+	QMvec3x4 s = QM_FUNC_PREFIX(vec3x4_sub)(QM_FUNC_PREFIX(vec3x4_full)(r.origin), tri.v0);
+
+	QMvec3x4 p = QM_FUNC_PREFIX(vec3x4_cross)(dir, tri.e2);
+	QMvec3x4 q = QM_FUNC_PREFIX(vec3x4_cross)(s, tri.e1);
+
+	QMvec4 det = QM_FUNC_PREFIX(vec3x4_dot)(tri.e1, p);
+	QMvec4 u = QM_FUNC_PREFIX(vec3x4_dot)(s, p);
+	QMvec4 v = QM_FUNC_PREFIX(vec3x4_dot)(dir, q);
+	QMvec4 t = QM_FUNC_PREFIX(vec3x4_dot)(tri.e2, q);
+
+	int lane;
+
+	#if QM_USE_SSE
+
+	//a zero determinant makes u and v infinite or NaN, which fails the tests below without a separate check
+	__m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det.packed);
+	u.packed = _mm_mul_ps(u.packed, invDet);
+	v.packed = _mm_mul_ps(v.packed, invDet);
+	t.packed = _mm_mul_ps(t.packed, invDet);
+
+	__m128 zero   = _mm_setzero_ps();
+	__m128 tLimit = _mm_set1_ps(tMax);
+
+	__m128 mask = _mm_and_ps(_mm_cmpge_ps(u.packed, zero), _mm_cmpge_ps(v.packed, zero));
+	mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u.packed, v.packed), _mm_set1_ps(1.0f)));
+	mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(t.packed, zero), _mm_cmplt_ps(t.packed, tLimit)));
+
+	int hits = _mm_movemask_ps(mask);
+	if(hits == 0)
+		return 0;
+
+	//missed lanes are set to tMax, which every hit is nearer than
+	__m128 tHit = _mm_or_ps(_mm_and_ps(mask, t.packed), _mm_andnot_ps(mask, tLimit));
+	__m128 nearest = _mm_set1_ps(QM_FUNC_PREFIX(hmin_sse)(tHit));
+
+	lane = (int)QM_FUNC_PREFIX(ctz32)((uint32_t)(_mm_movemask_ps(_mm_cmpeq_ps(tHit, nearest)) & hits));
+
+	#else
+
+	lane = -1;
+
+	for(int i = 0; i < 4; i++)
+	{
+		float invDet = 1.0f / det.v[i];
+		u.v[i] *= invDet;
+		v.v[i] *= invDet;
+		t.v[i] *= invDet;
+
+		if(u.v[i] >= 0.0f && v.v[i] >= 0.0f && u.v[i] + v.v[i] <= 1.0f && t.v[i] >= 0.0f && t.v[i] < tMax)
+		{
+			tMax = t.v[i];
+			lane = i;
+		}
+	}
+
+	if(lane < 0)
+		return 0;
+
+	#endif
+
+	hit->t = t.v[lane];
+	hit->u = u.v[lane];
+	hit->v = v.v[lane];
+	hit->index = lane;
+
+	return 1;
+}
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(ray_intersect_trianglex8)(QMray r, QMtrianglex8 tri, float tMax, QMrayHit* hit)
+{
+	QMvec3x8 dir = QM_FUNC_PREFIX(vec3x8_full)(r.dir);
+	QMvec3x8 s = QM_FUNC_PREFIX(vec3x8_sub)(QM_FUNC_PREFIX(vec3x8_full)(r.origin), tri.v0);
+
+	QMvec3x8 p = QM_FUNC_PREFIX(vec3x8_cross)(dir, tri.e2);
+	QMvec3x8 q = QM_FUNC_PREFIX(vec3x8_cross)(s, tri.e1);
+
+	QMvec8 det = QM_FUNC_PREFIX(vec3x8_dot)(tri.e1, p);
+	QMvec8 u = QM_FUNC_PREFIX(vec3x8_dot)(s, p);
+	QMvec8 v = QM_FUNC_PREFIX(vec3x8_dot)(dir, q);
+	QMvec8 t = QM_FUNC_PREFIX(vec3x8_dot)(tri.e2, q);
+
+	int lane;
+
+	#if QM_USE_AVX
+
+	__m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), det.packed);
+	u.packed = _mm256_mul_ps(u.packed, invDet);
+	v.packed = _mm256_mul_ps(v.packed, invDet);
+	t.packed = _mm256_mul_ps(t.packed, invDet);
+
+	__m256 zero   = _mm256_setzero_ps();
+	__m256 tLimit = _mm256_set1_ps(tMax);
+
+	__m256 mask = _mm256_and_ps(_mm256_cmp_ps(u.packed, zero, _CMP_GE_OQ), _mm256_cmp_ps(v.packed, zero, _CMP_GE_OQ));
+	mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u.packed, v.packed), _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+	mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(t.packed, zero, _CMP_GE_OQ), _mm256_cmp_ps(t.packed, tLimit, _CMP_LT_OQ)));
+
+	int hits = _mm256_movemask_ps(mask);
+	if(hits == 0)
+		return 0;
+
+	__m256 tHit = _mm256_blendv_ps(tLimit, t.packed, mask);
+	__m128 tHalf = _mm_min_ps(_mm256_castps256_ps128(tHit), _mm256_extractf128_ps(tHit, 1));
+	__m256 nearest = _mm256_set1_ps(QM_FUNC_PREFIX(hmin_sse)(tHalf));
+
+	lane = (int)QM_FUNC_PREFIX(ctz32)((uint32_t)(_mm256_movemask_ps(_mm256_cmp_ps(tHit, nearest, _CMP_EQ_OQ)) & hits));
+
+	#else
+
+	lane = -1;
+
+	for(int i = 0; i < 8; i++)
+	{
+		float invDet = 1.0f / det.v[i];
+		u.v[i] *= invDet;
+		v.v[i] *= invDet;
+		t.v[i] *= invDet;
+
+		if(u.v[i] >= 0.0f && v.v[i] >= 0.0f && u.v[i] + v.v[i] <= 1.0f && t.v[i] >= 0.0f && t.v[i] < tMax)
+		{
+			tMax = t.v[i];
+			lane = i;
+		}
+	}
+
+	if(lane < 0)
+		return 0;
+
+	#endif
+
+	hit->t = t.v[lane];
+	hit->u = u.v[lane];
+	hit->v = v.v[lane];
+	hit->index = lane;
+
+	return 1;
+}
+
+//----------------------------------------------------------------------//
+//FRUSTUM FUNCTIONS:
+
+//extracts the planes from a projection or view-projection matrix (Gribb/Hartmann), expects clip space
+//depth in [-w, w] like mat4_perspective and mat4_orthographic
+
+QM_FUNC_ATTRIBS QMfrustum QM_FUNC_PREFIX(frustum_from_mat4)(QMmat4 m)
+{
+	QMfrustum result;
+
+	for(int i = 0; i < 3; i++)
+	{
+		for(int j = 0; j < 4; j++)
+		{
+			result.planes[i * 2    ].v[j] = m.m[j][3] + m.m[j][i];
+			result.planes[i * 2 + 1].v[j] = m.m[j][3] - m.m[j][i];
+		}
+	}
+
+	for(int i = 0; i < 6; i++)
+	{
+		QMvec4 p = result.planes[i];
+		float invLen = 1.0f / QM_SQRTF(p.x * p.x + p.y * p.y + p.z * p.z);
+
+		result.planes[i].x = p.x * invLen;
+		result.planes[i].y = p.y * invLen;
+		result.planes[i].z = p.z * invLen;
+		result.planes[i].w = p.w * invLen;
+	}
+
+	return result;
+}
+
+//tests a box against the planes using its p-vertex and n-vertex, the corners furthest along and against
+//each plane's normal. n * p-vertex is the same as max(n * min, n * max) summed over each axis
+
+QM_FUNC_ATTRIBS QMcullResult QM_FUNC_PREFIX(frustum_classify_bbox3)(QMfrustum f, QMbbox3 b)
+{
+	QMcullResult result = QM_INSIDE;
+
+	for(int i = 0; i < 6; i++)
+	{
+		QMvec4 p = f.planes[i];
+
+		float minX = p.x * b.min.x, maxX = p.x * b.max.x;
+		float minY = p.y * b.min.y, maxY = p.y * b.max.y;
+		float minZ = p.z * b.min.z, maxZ = p.z * b.max.z;
+
+		float pDist = QM_MAX(minX, maxX) + QM_MAX(minY, maxY) + QM_MAX(minZ, maxZ) + p.w;
+		float nDist = QM_MIN(minX, maxX) + QM_MIN(minY, maxY) + QM_MIN(minZ, maxZ) + p.w;
+
+		if(pDist < 0.0f)
+			return QM_OUTSIDE;
+		if(nDist < 0.0f)
+			result = QM_INTERSECTS;
+	}
+
+	return result;
+}
+
+//array culling, bit i % 32 of visible[i / 32] is set if boxes[i] is at least partially inside.
+//visible must hold (count + 31) / 32 words
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(frustum_cull_bbox3_scalar)(const QMfrustum* f, const QMbbox3* boxes, size_t count, uint32_t* visible)
+{
+	for(size_t i = 0; i < (count + 31) / 32; i++)
+		visible[i] = 0;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		if(QM_FUNC_PREFIX(frustum_classify_bbox3)(*f, boxes[i]) != QM_OUTSIDE)
+			visible[i / 32] |= 1u << (i % 32);
+	}
+}
+
+#if QM_USE_SSE || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(frustum_cull_bbox3_sse)(const QMfrustum* f, const QMbbox3* boxes, size_t count, uint32_t* visible)
+{
+	size_t i = 0;
+
+	__m128 planes[6][4];
+	for(int p = 0; p < 6; p++)
+	for(int j = 0; j < 4; j++)
+		planes[p][j] = _mm_set1_ps(f->planes[p].v[j]);
+
+	for(size_t w = 0; w < (count + 31) / 32; w++)
+		visible[w] = 0;
+
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 minX, minY, minZ, maxX, maxY, maxZ;
+		QM_FUNC_PREFIX(bbox3_load4_sse)(&boxes[i], &minX, &minY, &minZ, &maxX, &maxY, &maxZ);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for(int p = 0; p < 6; p++)
+		{
+			__m128 dist = _mm_add_ps(_mm_max_ps(_mm_mul_ps(planes[p][0], minX), _mm_mul_ps(planes[p][0], maxX)), planes[p][3]);
+			dist = _mm_add_ps(dist, _mm_max_ps(_mm_mul_ps(planes[p][1], minY), _mm_mul_ps(planes[p][1], maxY)));
+			dist = _mm_add_ps(dist, _mm_max_ps(_mm_mul_ps(planes[p][2], minZ), _mm_mul_ps(planes[p][2], maxZ)));
+
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, _mm_setzero_ps()));
+		}
+
+		visible[i / 32] |= (uint32_t)_mm_movemask_ps(inside) << (i % 32);
+	}
+
+	for(; i < count; i++)
+	{
+		if(QM_FUNC_PREFIX(frustum_classify_bbox3)(*f, boxes[i]) != QM_OUTSIDE)
+			visible[i / 32] |= 1u << (i % 32);
+	}
+}
+
+#endif
+
+#if QM_USE_AVX2 || QM_USE_DISPATCH
+
+QM_FUNC_ATTRIBS QM_TARGET_AVX2 void QM_FUNC_PREFIX(frustum_cull_bbox3_avx2)(const QMfrustum* f, const QMbbox3* boxes, size_t count, uint32_t* visible)
+{
+	size_t i = 0;
+
+	__m256 planes[6][4];
+	for(int p = 0; p < 6; p++)
+	for(int j = 0; j < 4; j++)
+		planes[p][j] = _mm256_set1_ps(f->planes[p].v[j]);
+
+	for(size_t w = 0; w < (count + 31) / 32; w++)
+		visible[w] = 0;
+
+	for(; i < (count & ~(size_t)7); i += 8)
+	{
+		__m128 minX0, minY0, minZ0, maxX0, maxY0, maxZ0;
+		__m128 minX1, minY1, minZ1, maxX1, maxY1, maxZ1;
+		QM_FUNC_PREFIX(bbox3_load4_sse)(&boxes[i    ], &minX0, &minY0, &minZ0, &maxX0, &maxY0, &maxZ0);
+		QM_FUNC_PREFIX(bbox3_load4_sse)(&boxes[i + 4], &minX1, &minY1, &minZ1, &maxX1, &maxY1, &maxZ1);
+
+		__m256 minX = _mm256_insertf128_ps(_mm256_castps128_ps256(minX0), minX1, 1);
+		__m256 minY = _mm256_insertf128_ps(_mm256_castps128_ps256(minY0), minY1, 1);
+		__m256 minZ = _mm256_insertf128_ps(_mm256_castps128_ps256(minZ0), minZ1, 1);
+		__m256 maxX = _mm256_insertf128_ps(_mm256_castps128_ps256(maxX0), maxX1, 1);
+		__m256 maxY = _mm256_insertf128_ps(_mm256_castps128_ps256(maxY0), maxY1, 1);
+		__m256 maxZ = _mm256_insertf128_ps(_mm256_castps128_ps256(maxZ0), maxZ1, 1);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for(int p = 0; p < 6; p++)
+		{
+			__m256 dist = _mm256_add_ps(_mm256_max_ps(_mm256_mul_ps(planes[p][0], minX), _mm256_mul_ps(planes[p][0], maxX)), planes[p][3]);
+			dist = _mm256_add_ps(dist, _mm256_max_ps(_mm256_mul_ps(planes[p][1], minY), _mm256_mul_ps(planes[p][1], maxY)));
+			dist = _mm256_add_ps(dist, _mm256_max_ps(_mm256_mul_ps(planes[p][2], minZ), _mm256_mul_ps(planes[p][2], maxZ)));
+
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+
+		visible[i / 32] |= (uint32_t)_mm256_movemask_ps(inside) << (i % 32);
+	}
+
+	for(; i < count; i++)
+	{
+		if(QM_FUNC_PREFIX(frustum_classify_bbox3)(*f, boxes[i]) != QM_OUTSIDE)
+			visible[i / 32] |= 1u << (i % 32);
+	}
+}
+
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(frustum_cull_bbox3)(QMfrustum f, const QMbbox3* boxes, size_t count, uint32_t* visible)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->frustum_cull_bbox3(&f, boxes, count, visible);
+
+	#elif QM_USE_AVX2
+
+	QM_FUNC_PREFIX(frustum_cull_bbox3_avx2)(&f, boxes, count, visible);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(frustum_cull_bbox3_sse)(&f, boxes, count, visible);
+
+	#else
+
+	QM_FUNC_PREFIX(frustum_cull_bbox3_scalar)(&f, boxes, count, visible);
+
+	#endif
+}
+
+//same as frustum_cull_bbox3, but writes the indices of the visible boxes in order and returns how many there are.
+//indices must be able to hold count elements
+
+QM_FUNC_ATTRIBS size_t QM_FUNC_PREFIX(frustum_cull_bbox3_indices)(QMfrustum f, const QMbbox3* boxes, size_t count, uint32_t* indices)
+{
+	size_t numVisible = 0;
+
+	for(size_t i = 0; i < count; i += 32)
+	{
+		uint32_t visible;
+		QM_FUNC_PREFIX(frustum_cull_bbox3)(f, boxes + i, QM_MIN(count - i, (size_t)32), &visible);
+
+		while(visible != 0)
+		{
+			indices[numVisible++] = (uint32_t)i + QM_FUNC_PREFIX(ctz32)(visible);
+			visible &= visible - 1;
+		}
+	}
+
+	return numVisible;
+}
+
+//hierarchical culling, tests a box against the planes in activePlanes. returns a mask of the planes the box is
+//fully outside of and stores a mask of the planes it straddles in intersecting
+
+#if QM_USE_SSE
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(frustum_test_planes_sse)(const __m128* planes, const QMbbox3* b, uint32_t activePlanes, uint32_t* intersecting)
+{
+	//every plane is tested at once, so activePlanes only masks the result
+	__m128 minX = _mm_set1_ps(b->min.x), minY = _mm_set1_ps(b->min.y), minZ = _mm_set1_ps(b->min.z);
+	__m128 maxX = _mm_set1_ps(b->max.x), maxY = _mm_set1_ps(b->max.y), maxZ = _mm_set1_ps(b->max.z);
+
+	uint32_t outside = 0;
+	uint32_t straddling = 0;
+	for(int g = 0; g < 2; g++)
+	{
+		const __m128* p = &planes[g * 4];
+
+		__m128 x0 = _mm_mul_ps(p[0], minX), x1 = _mm_mul_ps(p[0], maxX);
+		__m128 y0 = _mm_mul_ps(p[1], minY), y1 = _mm_mul_ps(p[1], maxY);
+		__m128 z0 = _mm_mul_ps(p[2], minZ), z1 = _mm_mul_ps(p[2], maxZ);
+
+		__m128 pDist = _mm_add_ps(_mm_add_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)), _mm_add_ps(_mm_max_ps(z0, z1), p[3]));
+		__m128 nDist = _mm_add_ps(_mm_add_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)), _mm_add_ps(_mm_min_ps(z0, z1), p[3]));
+
+		outside    |= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(pDist, _mm_setzero_ps())) << (g * 4);
+		straddling |= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(nDist, _mm_setzero_ps())) << (g * 4);
+	}
+
+	*intersecting = straddling & activePlanes;
+	return outside & activePlanes;
+}
+
+#endif
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(frustum_test_planes_scalar)(const QMfrustum* f, const QMbbox3* b, uint32_t activePlanes, uint32_t* intersecting)
+{
+	uint32_t straddling = 0;
+	for(uint32_t mask = activePlanes; mask != 0; mask &= mask - 1)
+	{
+		uint32_t i = QM_FUNC_PREFIX(ctz32)(mask);
+		QMvec4 p = f->planes[i];
+
+		float minX = p.x * b->min.x, maxX = p.x * b->max.x;
+		float minY = p.y * b->min.y, maxY = p.y * b->max.y;
+		float minZ = p.z * b->min.z, maxZ = p.z * b->max.z;
+
+		if(QM_MAX(minX, maxX) + QM_MAX(minY, maxY) + QM_MAX(minZ, maxZ) + p.w < 0.0f)
+			return 1u << i;
+		if(QM_MIN(minX, maxX) + QM_MIN(minY, maxY) + QM_MIN(minZ, maxZ) + p.w < 0.0f)
+			straddling |= 1u << i;
+	}
+
+	*intersecting = straddling;
+	return 0;
+}
+
+//walks a bounding volume hierarchy and writes the indices of the leaf nodes that are at least partially inside,
+//returns how many there are. each node only tests the planes its parent straddles, so everything below a node
+//that is fully inside is accepted without any tests.
+//planeCache is optional (NULL to disable), otherwise it holds one byte per node (zero initialized) remembering
+//the plane that last rejected the node, which is tested first on the next call.
+//leaves must be able to hold every leaf node, and the tree can be at most QM_BVH_MAX_DEPTH deep
+
+QM_FUNC_ATTRIBS size_t QM_FUNC_PREFIX(frustum_cull_bvh)(QMfrustum f, const QMbvhNode* nodes, uint8_t* planeCache, uint32_t* leaves)
+{
+	#if QM_USE_SSE
+
+	//planes as structure-of-arrays, padded with 2 planes that everything is inside of
+	__m128 planes[8];
+	for(int j = 0; j < 4; j++)
+	{
+		planes[j    ] = _mm_setr_ps(f.planes[0].v[j], f.planes[1].v[j], f.planes[2].v[j], f.planes[3].v[j]);
+		planes[j + 4] = _mm_setr_ps(f.planes[4].v[j], f.planes[5].v[j], 0.0f, 0.0f);
+	}
+	planes[7] = _mm_setr_ps(f.planes[4].w, f.planes[5].w, 1.0f, 1.0f);
+
+	#endif
+
+	uint32_t stackNodes[QM_BVH_MAX_DEPTH];
+	uint32_t stackPlanes[QM_BVH_MAX_DEPTH];
+	int stackSize = 0;
+
+	size_t numLeaves = 0;
+	uint32_t node = 0;
+	uint32_t activePlanes = 0x3f;
+
+	for(;;)
+	{
+		const QMbvhNode* n = &nodes[node];
+		QMbool culled = 0;
+
+		if(activePlanes != 0)
+		{
+			//temporal coherence: the plane that rejected this node last time is likely to reject it again
+			if(planeCache != NULL && (activePlanes & (1u << planeCache[node])))
+			{
+				QMvec4 p = f.planes[planeCache[node]];
+				float dist = QM_MAX(p.x * n->bounds.min.x, p.x * n->bounds.max.x) +
+				             QM_MAX(p.y * n->bounds.min.y, p.y * n->bounds.max.y) +
+				             QM_MAX(p.z * n->bounds.min.z, p.z * n->bounds.max.z) + p.w;
+
+				culled = dist < 0.0f;
+			}
+
+			if(!culled)
+			{
+				uint32_t intersecting;
+
+				#if QM_USE_SSE
+
+				uint32_t outside = QM_FUNC_PREFIX(frustum_test_planes_sse)(planes, &n->bounds, activePlanes, &intersecting);
+
+				#else
+
+				uint32_t outside = QM_FUNC_PREFIX(frustum_test_planes_scalar)(&f, &n->bounds, activePlanes, &intersecting);
+
+				#endif
+
+				if(outside != 0)
+				{
+					culled = 1;
+					if(planeCache != NULL)
+						planeCache[node] = (uint8_t)QM_FUNC_PREFIX(ctz32)(outside);
+				}
+				else
+					activePlanes = intersecting;
+			}
+		}
+
+		if(!culled)
+		{
+			if(n->count > 0)
+				leaves[numLeaves++] = node;
+			else
+			{
+				stackNodes[stackSize] = n->leftFirst + 1;
+				stackPlanes[stackSize] = activePlanes;
+				stackSize++;
+
+				node = n->leftFirst;
+				continue;
+			}
+		}
+
+		if(stackSize == 0)
+			break;
+
+		stackSize--;
+		node = stackNodes[stackSize];
+		activePlanes = stackPlanes[stackSize];
+	}
+
+	return numLeaves;
+}
+
+//----------------------------------------------------------------------//
+//BOUNDING VOLUME HIERARCHY FUNCTIONS:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_bins_init)(QMbvhBins* bins, QMbbox3 centroids, uint32_t count)
+{
+	//small nodes use fewer bins since setting up and sweeping the bins would cost more than the primitives themselves
+	bins->numBins = (int)QM_MIN(count, (uint32_t)QM_BVH_BINS);
+	bins->offset = centroids.min;
+
+	for(int a = 0; a < 3; a++)
+	{
+		float extent = centroids.max.v[a] - centroids.min.v[a];
+		bins->scale[a] = extent > 1e-30f ? (float)bins->numBins / extent : 0.0f;
+
+		for(int b = 0; b < bins->numBins; b++)
+		{
+			bins->bounds[a][b] = QM_FUNC_PREFIX(bbox3_initialized)();
+			bins->counts[a][b] = 0;
+		}
+	}
+}
+
+QM_FUNC_ATTRIBS int QM_FUNC_PREFIX(bvh_bin_index)(const QMbvhBins* bins, QMvec3 centroid, int axis)
+{
+	int b = (int)((centroid.v[axis] - bins->offset.v[axis]) * bins->scale[axis]);
+	return QM_MIN(b, bins->numBins - 1);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_bins_add)(QMbvhBins* bins, const QMbbox3* prims, const uint32_t* primIndices, uint32_t first, uint32_t count)
+{
+	for(uint32_t i = first; i < first + count; i++)
+	{
+		QMbbox3 prim = prims[primIndices[i]];
+		QMvec3 centroid = QM_FUNC_PREFIX(bbox3_centroid)(prim);
+
+		for(int a = 0; a < 3; a++)
+		{
+			int b = QM_FUNC_PREFIX(bvh_bin_index)(bins, centroid, a);
+
+			bins->bounds[a][b] = QM_FUNC_PREFIX(bbox3_union)(bins->bounds[a][b], prim);
+			bins->counts[a][b]++;
+		}
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_bins_merge)(QMbvhBins* bins, const QMbvhBins* other)
+{
+	for(int a = 0; a < 3; a++)
+	for(int b = 0; b < bins->numBins; b++)
+	{
+		bins->bounds[a][b] = QM_FUNC_PREFIX(bbox3_union)(bins->bounds[a][b], other->bounds[a][b]);
+		bins->counts[a][b] += other->counts[a][b];
+	}
+}
+
+//the area used for the surface area heuristic, flat nodes (no area) use the sum of the extents instead so
+//that planar and linear primitive sets still get balanced splits
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bvh_split_area)(QMbbox3 b, QMbool flat)
+{
+	if(flat)
+	{
+		QMvec3 extent = QM_FUNC_PREFIX(bbox3_extent)(b);
+		return extent.x + extent.y + extent.z;
+	}
+
+	return QM_FUNC_PREFIX(bbox3_surface_area)(b);
+}
+
+//sweeps the planes between bins for the cheapest split, cost = area(left) * count(left) + area(right) * count(right).
+//returns 0 if the node should stay a leaf, otherwise primitives in bins below split on axis go to the left child
+
+QM_FUNC_ATTRIBS QMbool QM_FUNC_PREFIX(bvh_find_split)(const QMbvhBins* bins, QMbbox3 bounds, uint32_t count, int* axis, int* split)
+{
+	float nodeArea = QM_FUNC_PREFIX(bbox3_surface_area)(bounds);
+	QMbool flat = nodeArea <= 0.0f;
+	if(flat)
+		nodeArea = QM_FUNC_PREFIX(bvh_split_area)(bounds, flat);
+
+	float bestCost = INFINITY;
+	int bestAxis = -1;
+	int bestSplit = 0;
+
+	for(int a = 0; a < 3; a++)
+	{
+		if(bins->scale[a] == 0.0f)
+			continue;
+
+		float leftCost[QM_BVH_BINS];
+		QMbbox3 box = QM_FUNC_PREFIX(bbox3_initialized)();
+		uint32_t boxCount = 0;
+		for(int b = 0; b < bins->numBins - 1; b++)
+		{
+			box = QM_FUNC_PREFIX(bbox3_union)(box, bins->bounds[a][b]);
+			boxCount += bins->counts[a][b];
+			leftCost[b] = boxCount > 0 ? QM_FUNC_PREFIX(bvh_split_area)(box, flat) * (float)boxCount : INFINITY;
+		}
+
+		box = QM_FUNC_PREFIX(bbox3_initialized)();
+		boxCount = 0;
+		for(int b = bins->numBins - 1; b > 0; b--)
+		{
+			box = QM_FUNC_PREFIX(bbox3_union)(box, bins->bounds[a][b]);
+			boxCount += bins->counts[a][b];
+			if(boxCount == 0)
+				continue;
+
+			float cost = leftCost[b - 1] + QM_FUNC_PREFIX(bvh_split_area)(box, flat) * (float)boxCount;
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = a;
+				bestSplit = b;
+			}
+		}
+	}
+
+	//all centroids in the same place, can't be split
+	if(bestAxis < 0)
+		return 0;
+
+	//traversal is assumed to cost the same as testing one primitive
+	if(nodeArea > 0.0f && 1.0f + bestCost / nodeArea >= (float)count && count <= QM_BVH_MAX_LEAF_SIZE)
+		return 0;
+
+	*axis = bestAxis;
+	*split = bestSplit;
+	return 1;
+}
+
+//partitions [first, first + count) with the same bin computation as the binning, so the split matches the bin
+//counts exactly. returns where the right child's primitives start and gathers the children's centroid bounds
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(bvh_partition)(const QMbvhBins* bins, int axis, int split, const QMbbox3* prims, uint32_t* primIndices,
+                                                        uint32_t first, uint32_t count, QMbbox3* leftCentroids, QMbbox3* rightCentroids)
+{
+	uint32_t i = first;
+	uint32_t j = first + count;
+	while(i < j)
+	{
+		QMvec3 centroid = QM_FUNC_PREFIX(bbox3_centroid)(prims[primIndices[i]]);
+
+		if(QM_FUNC_PREFIX(bvh_bin_index)(bins, centroid, axis) < split)
+		{
+			*leftCentroids = QM_FUNC_PREFIX(bbox3_union_vec3)(*leftCentroids, centroid);
+			i++;
+		}
+		else
+		{
+			*rightCentroids = QM_FUNC_PREFIX(bbox3_union_vec3)(*rightCentroids, centroid);
+
+			j--;
+			uint32_t temp = primIndices[i];
+			primIndices[i] = primIndices[j];
+			primIndices[j] = temp;
+		}
+	}
+
+	return i;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_split_bounds)(const QMbvhBins* bins, int axis, int split, QMbbox3* left, QMbbox3* right)
+{
+	*left  = QM_FUNC_PREFIX(bbox3_initialized)();
+	*right = QM_FUNC_PREFIX(bbox3_initialized)();
+
+	for(int b = 0; b < bins->numBins; b++)
+	{
+		if(b < split)
+			*left  = QM_FUNC_PREFIX(bbox3_union)(*left, bins->bounds[axis][b]);
+		else
+			*right = QM_FUNC_PREFIX(bbox3_union)(*right, bins->bounds[axis][b]);
+	}
+}
+
+//builds the subtree below root, allocating child pairs from nodeCount on in depth-first order, returns the new
+//node count. leaves have their primitive indices sorted, so the result doesn't depend on the partition order
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(bvh_build_subtree)(const QMbbox3* prims, QMbvhNode* nodes, uint32_t* primIndices,
+                                                            QMbvhNode* root, uint32_t rootDepth, QMbbox3 rootCentroids, uint32_t nodeCount)
+{
+	//each pending node's depth and centroid bounds, the node's bounds and primitive range are already written
+	struct
+	{
+		QMbvhNode* node;
+		uint32_t depth;
+		QMbbox3 centroids;
+	} stack[QM_BVH_MAX_DEPTH];
+	int stackSize = 0;
+
+	stack[0].node = root;
+	stack[0].depth = rootDepth;
+	stack[0].centroids = rootCentroids;
+	stackSize = 1;
+
+	while(stackSize > 0)
+	{
+		stackSize--;
+		QMbvhNode* node = stack[stackSize].node;
+		uint32_t depth = stack[stackSize].depth;
+		QMbbox3 centroids = stack[stackSize].centroids;
+
+		uint32_t first = node->leftFirst;
+		uint32_t n = node->count;
+
+		int axis, split;
+		QMbvhBins bins;
+		QMbool isLeaf = n <= 1 || depth + 1 >= QM_BVH_MAX_DEPTH;
+		if(!isLeaf)
+		{
+			QM_FUNC_PREFIX(bvh_bins_init)(&bins, centroids, n);
+			QM_FUNC_PREFIX(bvh_bins_add)(&bins, prims, primIndices, first, n);
+			isLeaf = !QM_FUNC_PREFIX(bvh_find_split)(&bins, node->bounds, n, &axis, &split);
+		}
+
+		if(isLeaf)
+		{
+			QM_FUNC_PREFIX(sort_ints)((int*)&primIndices[first], (int)n);
+			continue;
+		}
+
+		QMbbox3 leftCentroids  = QM_FUNC_PREFIX(bbox3_initialized)();
+		QMbbox3 rightCentroids = QM_FUNC_PREFIX(bbox3_initialized)();
+		uint32_t mid = QM_FUNC_PREFIX(bvh_partition)(&bins, axis, split, prims, primIndices, first, n, &leftCentroids, &rightCentroids);
+
+		uint32_t left = nodeCount;
+		nodeCount += 2;
+
+		QM_FUNC_PREFIX(bvh_split_bounds)(&bins, axis, split, &nodes[left].bounds, &nodes[left + 1].bounds);
+		nodes[left].leftFirst = first;
+		nodes[left].count = mid - first;
+		nodes[left + 1].leftFirst = mid;
+		nodes[left + 1].count = first + n - mid;
+
+		node->leftFirst = left;
+		node->count = 0;
+
+		stack[stackSize].node = &nodes[left + 1];
+		stack[stackSize].depth = depth + 1;
+		stack[stackSize].centroids = rightCentroids;
+		stack[stackSize + 1].node = &nodes[left];
+		stack[stackSize + 1].depth = depth + 1;
+		stack[stackSize + 1].centroids = leftCentroids;
+		stackSize += 2;
+	}
+
+	return nodeCount;
+}
+
+//builds a bounding volume hierarchy over prims using the surface area heuristic, choosing splits from
+//QM_BVH_BINS centroid bins per axis. returns the number of nodes written.
+//nodes must be able to hold 2 * count - 1 nodes and primIndices count elements, leaves refer to the
+//primitives primIndices[leftFirst] to primIndices[leftFirst + count - 1]
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(bvh_build)(const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices)
+{
+	if(count == 0)
+		return 0;
+
+	QMbbox3 rootBounds = QM_FUNC_PREFIX(bbox3_initialized)();
+	QMbbox3 rootCentroids = QM_FUNC_PREFIX(bbox3_initialized)();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		primIndices[i] = i;
+		rootBounds = QM_FUNC_PREFIX(bbox3_union)(rootBounds, prims[i]);
+		rootCentroids = QM_FUNC_PREFIX(bbox3_union_vec3)(rootCentroids, QM_FUNC_PREFIX(bbox3_centroid)(prims[i]));
+	}
+
+	nodes[0].bounds = rootBounds;
+	nodes[0].leftFirst = 0;
+	nodes[0].count = count;
+
+	return QM_FUNC_PREFIX(bvh_build_subtree)(prims, nodes, primIndices, &nodes[0], 0, rootCentroids, 1);
+}
+
+//parallel building:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_chunk_init_task)(void* data, uint32_t index)
+{
+	QMbvhParallelState* s = (QMbvhParallelState*)data;
+
+	QMbbox3 bounds = QM_FUNC_PREFIX(bbox3_initialized)();
+	QMbbox3 centroids = QM_FUNC_PREFIX(bbox3_initialized)();
+	for(uint32_t i = s->chunkFirst[index]; i < s->chunkFirst[index + 1]; i++)
+	{
+		s->primIndices[i] = i;
+		bounds = QM_FUNC_PREFIX(bbox3_union)(bounds, s->prims[i]);
+		centroids = QM_FUNC_PREFIX(bbox3_union_vec3)(centroids, QM_FUNC_PREFIX(bbox3_centroid)(s->prims[i]));
+	}
+
+	s->chunkBounds[index] = bounds;
+	s->chunkCentroids[index] = centroids;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_chunk_bin_task)(void* data, uint32_t index)
+{
+	QMbvhParallelState* s = (QMbvhParallelState*)data;
+
+	uint32_t first = s->chunkFirst[index];
+	QM_FUNC_PREFIX(bvh_bins_add)(&s->chunkBins[index], s->prims, s->primIndices, first, s->chunkFirst[index + 1] - first);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_chunk_partition_task)(void* data, uint32_t index)
+{
+	QMbvhParallelState* s = (QMbvhParallelState*)data;
+
+	uint32_t first = s->chunkFirst[index];
+	s->chunkCentroids[index] = QM_FUNC_PREFIX(bbox3_initialized)();
+	s->chunkRightCentroids[index] = QM_FUNC_PREFIX(bbox3_initialized)();
+	s->chunkMid[index] = QM_FUNC_PREFIX(bvh_partition)(s->bins, s->axis, s->split, s->prims, s->primIndices, first, s->chunkFirst[index + 1] - first,
+	                                                   &s->chunkCentroids[index], &s->chunkRightCentroids[index]);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_chunk_swap_task)(void* data, uint32_t index)
+{
+	QMbvhParallelState* s = (QMbvhParallelState*)data;
+
+	uint32_t begin = (uint32_t)((uint64_t)s->numMisplaced *  index      / s->numChunks);
+	uint32_t end   = (uint32_t)((uint64_t)s->numMisplaced * (index + 1) / s->numChunks);
+	if(begin == end)
+		return;
+
+	//find where misplaced element number begin is in both lists of ranges
+	uint32_t rightRange = 0, rightOffset = begin;
+	while(rightOffset >= s->misplacedRight[rightRange][1] - s->misplacedRight[rightRange][0])
+	{
+		rightOffset -= s->misplacedRight[rightRange][1] - s->misplacedRight[rightRange][0];
+		rightRange++;
+	}
+
+	uint32_t leftRange = 0, leftOffset = begin;
+	while(leftOffset >= s->misplacedLeft[leftRange][1] - s->misplacedLeft[leftRange][0])
+	{
+		leftOffset -= s->misplacedLeft[leftRange][1] - s->misplacedLeft[leftRange][0];
+		leftRange++;
+	}
+
+	uint32_t r = s->misplacedRight[rightRange][0] + rightOffset;
+	uint32_t l = s->misplacedLeft[leftRange][0] + leftOffset;
+	for(uint32_t i = begin; i < end; i++)
+	{
+		uint32_t temp = s->primIndices[r];
+		s->primIndices[r] = s->primIndices[l];
+		s->primIndices[l] = temp;
+
+		if(++r == s->misplacedRight[rightRange][1] && rightRange + 1 < s->numMisplacedRight)
+			r = s->misplacedRight[++rightRange][0];
+		if(++l == s->misplacedLeft[leftRange][1] && leftRange + 1 < s->numMisplacedLeft)
+			l = s->misplacedLeft[++leftRange][0];
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_subtree_task)(void* data, uint32_t index)
+{
+	QMbvhParallelState* s = (QMbvhParallelState*)data;
+
+	uint32_t t = s->taskTop[index];
+	s->taskEnd[index] = QM_FUNC_PREFIX(bvh_build_subtree)(s->prims, s->nodes, s->primIndices, &s->top[t], s->topDepth[t], s->topCentroids[t], s->taskStart[index]);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_set_chunks)(QMbvhParallelState* s, uint32_t first, uint32_t count)
+{
+	s->numChunks = QM_MAX(QM_MIN(count / QM_BVH_PARALLEL_MIN_CHUNK, (uint32_t)QM_BVH_PARALLEL_CHUNKS), 1u);
+	for(uint32_t c = 0; c <= s->numChunks; c++)
+		s->chunkFirst[c] = first + (uint32_t)((uint64_t)count * c / s->numChunks);
+}
+
+//same as bvh_build, but runs on the caller's thread pool through parallelFor. the result is identical to bvh_build's.
+//state is scratch memory for the build, it is too large to put on the stack
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(bvh_build_parallel)(const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices,
+                                                             QMbvhParallelState* s, QMparallelForFunc parallelFor, void* user)
+{
+	if(count == 0)
+		return 0;
+
+	s->prims = prims;
+	s->nodes = nodes;
+	s->primIndices = primIndices;
+
+	//root bounds
+	QM_FUNC_PREFIX(bvh_set_chunks)(s, 0, count);
+	parallelFor(user, QM_FUNC_PREFIX(bvh_chunk_init_task), s, s->numChunks);
+
+	s->top[0].bounds = QM_FUNC_PREFIX(bbox3_initialized)();
+	s->top[0].leftFirst = 0;
+	s->top[0].count = count;
+	s->topDepth[0] = 0;
+	s->topCentroids[0] = QM_FUNC_PREFIX(bbox3_initialized)();
+	for(uint32_t c = 0; c < s->numChunks; c++)
+	{
+		s->top[0].bounds = QM_FUNC_PREFIX(bbox3_union)(s->top[0].bounds, s->chunkBounds[c]);
+		s->topCentroids[0] = QM_FUNC_PREFIX(bbox3_union)(s->topCentroids[0], s->chunkCentroids[c]);
+	}
+
+	//split the top of the tree in depth-first order, nodes small enough (or once there are enough leaves) become tasks
+	uint32_t taskSize = QM_MAX(count / (QM_BVH_PARALLEL_TASKS / 4), (uint32_t)QM_BVH_PARALLEL_MIN_CHUNK);
+	uint32_t topCount = 1;
+	uint32_t topLeaves = 1;
+	s->numTasks = 0;
+
+	uint32_t stack[QM_BVH_MAX_DEPTH];
+	int stackSize = 1;
+	stack[0] = 0;
+
+	while(stackSize > 0)
+	{
+		uint32_t t = stack[--stackSize];
+		QMbvhNode* node = &s->top[t];
+		uint32_t first = node->leftFirst;
+		uint32_t n = node->count;
+		uint32_t depth = s->topDepth[t];
+
+		int axis, split;
+		QMbvhBins bins;
+		QMbool isTask = n <= taskSize || topLeaves >= QM_BVH_PARALLEL_TASKS || depth + 1 >= QM_BVH_MAX_DEPTH;
+		if(!isTask)
+		{
+			QM_FUNC_PREFIX(bvh_bins_init)(&bins, s->topCentroids[t], n);
+
+			QM_FUNC_PREFIX(bvh_set_chunks)(s, first, n);
+			for(uint32_t c = 0; c < s->numChunks; c++)
+				s->chunkBins[c] = bins;
+			parallelFor(user, QM_FUNC_PREFIX(bvh_chunk_bin_task), s, s->numChunks);
+
+			for(uint32_t c = 0; c < s->numChunks; c++)
+				QM_FUNC_PREFIX(bvh_bins_merge)(&bins, &s->chunkBins[c]);
+
+			isTask = !QM_FUNC_PREFIX(bvh_find_split)(&bins, node->bounds, n, &axis, &split);
+		}
+
+		if(isTask)
+		{
+			s->topTask[t] = (int)s->numTasks;
+			s->taskTop[s->numTasks++] = t;
+			continue;
+		}
+
+		//partition each chunk, then swap the right primitives in front of mid with the left ones after it
+		s->bins = &bins;
+		s->axis = axis;
+		s->split = split;
+		parallelFor(user, QM_FUNC_PREFIX(bvh_chunk_partition_task), s, s->numChunks);
+
+		QMbbox3 leftCentroids  = QM_FUNC_PREFIX(bbox3_initialized)();
+		QMbbox3 rightCentroids = QM_FUNC_PREFIX(bbox3_initialized)();
+		uint32_t mid = first;
+		for(uint32_t c = 0; c < s->numChunks; c++)
+		{
+			leftCentroids  = QM_FUNC_PREFIX(bbox3_union)(leftCentroids, s->chunkCentroids[c]);
+			rightCentroids = QM_FUNC_PREFIX(bbox3_union)(rightCentroids, s->chunkRightCentroids[c]);
+			mid += s->chunkMid[c] - s->chunkFirst[c];
+		}
+
+		s->numMisplaced = 0;
+		s->numMisplacedRight = 0;
+		s->numMisplacedLeft = 0;
+		for(uint32_t c = 0; c < s->numChunks; c++)
+		{
+			uint32_t chunkFirst = s->chunkFirst[c];
+			uint32_t chunkMid = s->chunkMid[c];
+			uint32_t chunkEnd = s->chunkFirst[c + 1];
+
+			if(chunkMid < mid && chunkMid < chunkEnd)
+			{
+				s->misplacedRight[s->numMisplacedRight][0] = chunkMid;
+				s->misplacedRight[s->numMisplacedRight][1] = QM_MIN(chunkEnd, mid);
+				s->numMisplaced += s->misplacedRight[s->numMisplacedRight][1] - chunkMid;
+				s->numMisplacedRight++;
+			}
+			if(chunkMid > mid && chunkFirst < chunkMid)
+			{
+				s->misplacedLeft[s->numMisplacedLeft][0] = QM_MAX(chunkFirst, mid);
+				s->misplacedLeft[s->numMisplacedLeft][1] = chunkMid;
+				s->numMisplacedLeft++;
+			}
+		}
+
+		if(s->numMisplaced > 0)
+			parallelFor(user, QM_FUNC_PREFIX(bvh_chunk_swap_task), s, s->numChunks);
+
+		uint32_t left = topCount;
+		topCount += 2;
+		topLeaves++;
+
+		QM_FUNC_PREFIX(bvh_split_bounds)(&bins, axis, split, &s->top[left].bounds, &s->top[left + 1].bounds);
+		s->top[left].leftFirst = first;
+		s->top[left].count = mid - first;
+		s->top[left + 1].leftFirst = mid;
+		s->top[left + 1].count = first + n - mid;
+
+		s->topDepth[left] = depth + 1;
+		s->topDepth[left + 1] = depth + 1;
+		s->topCentroids[left] = leftCentroids;
+		s->topCentroids[left + 1] = rightCentroids;
+
+		node->leftFirst = left;
+		node->count = 0;
+		s->topTask[t] = -1;
+
+		stack[stackSize++] = left + 1;
+		stack[stackSize++] = left;
+	}
+
+	//build the subtrees, each writing its descendants after room for the whole top of the tree and every earlier
+	//subtree's worst case (2 * count - 2 descendants), so they never overlap
+	uint32_t start = 2 * s->numTasks - 1;
+	for(uint32_t i = 0; i < s->numTasks; i++)
+	{
+		s->taskStart[i] = start;
+		start += 2 * s->top[s->taskTop[i]].count - 2;
+	}
+
+	parallelFor(user, QM_FUNC_PREFIX(bvh_subtree_task), s, s->numTasks);
+
+	//find where bvh_build would have put every node by walking the top in the same order, then move the subtrees
+	//down into place. they only ever move towards the front, so they can be moved in order without overlapping
+	uint32_t finalIndex[2 * QM_BVH_PARALLEL_TASKS];
+	uint32_t taskFinal[QM_BVH_PARALLEL_TASKS];
+	uint32_t nodeCount = 1;
+
+	finalIndex[0] = 0;
+	stackSize = 1;
+	stack[0] = 0;
+	while(stackSize > 0)
+	{
+		uint32_t t = stack[--stackSize];
+
+		if(s->topTask[t] >= 0)
+		{
+			int task = s->topTask[t];
+			taskFinal[task] = nodeCount;
+			nodeCount += s->taskEnd[task] - s->taskStart[task];
+		}
+		else
+		{
+			uint32_t left = s->top[t].leftFirst;
+			finalIndex[left] = nodeCount;
+			finalIndex[left + 1] = nodeCount + 1;
+			nodeCount += 2;
+
+			stack[stackSize++] = left + 1;
+			stack[stackSize++] = left;
+		}
+	}
+
+	for(uint32_t i = 0; i < s->numTasks; i++)
+	{
+		uint32_t from = s->taskStart[i];
+		uint32_t to = taskFinal[i];
+		uint32_t offset = from - to;
+
+		for(uint32_t j = 0; j < s->taskEnd[i] - from; j++)
+		{
+			QMbvhNode node = nodes[from + j];
+			if(node.count == 0)
+				node.leftFirst -= offset;
+
+			nodes[to + j] = node;
+		}
+
+		QMbvhNode* root = &s->top[s->taskTop[i]];
+		if(root->count == 0)
+			root->leftFirst -= offset;
+	}
+
+	for(uint32_t t = 0; t < topCount; t++)
+	{
+		QMbvhNode node = s->top[t];
+		if(s->topTask[t] < 0)
+			node.leftFirst = finalIndex[node.leftFirst];
+
+		nodes[finalIndex[t]] = node;
+	}
+
+	return nodeCount;
+}
+
+//linear building:
+
+//spreads the low 10 bits of x out to every third bit, for interleaving into morton codes
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(morton_expand_bits)(uint32_t x)
+{
+	x = (x | (x << 16)) & 0x030000FF;
+	x = (x | (x <<  8)) & 0x0300F00F;
+	x = (x | (x <<  4)) & 0x030C30C3;
+	x = (x | (x <<  2)) & 0x09249249;
+
+	return x;
+}
+
+//quantizes a point normalized to [0, 1]^3 to 10 bits per axis and interleaves them into a 30 bit morton code
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(morton_code)(QMvec3 v)
+{
+	uint32_t x = (uint32_t)(QM_MIN(QM_MAX(v.x, 0.0f), 1.0f) * 1023.0f);
+	uint32_t y = (uint32_t)(QM_MIN(QM_MAX(v.y, 0.0f), 1.0f) * 1023.0f);
+	uint32_t z = (uint32_t)(QM_MIN(QM_MAX(v.z, 0.0f), 1.0f) * 1023.0f);
+
+	return (QM_FUNC_PREFIX(morton_expand_bits)(x) << 2) | (QM_FUNC_PREFIX(morton_expand_bits)(y) << 1) | QM_FUNC_PREFIX(morton_expand_bits)(z);
+}
+
+#if QM_USE_SSE
+
+QM_FUNC_ATTRIBS __m128i QM_FUNC_PREFIX(morton_expand_bits_sse)(__m128i x)
+{
+	x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x, 16)), _mm_set1_epi32(0x030000FF));
+	x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x,  8)), _mm_set1_epi32(0x0300F00F));
+	x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x,  4)), _mm_set1_epi32(0x030C30C3));
+	x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x,  2)), _mm_set1_epi32(0x09249249));
+
+	return x;
+}
+
+#endif
+
+//morton codes of the primitives' centroids, offset into the bounds of all the centroids
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_morton_codes)(const QMbbox3* prims, uint32_t count, QMbbox3 centroids, uint32_t* codes)
+{
+	uint32_t i = 0;
+
+	#if QM_USE_SSE
+
+	__m128 offsetX = _mm_set1_ps(centroids.min.x), offsetY = _mm_set1_ps(centroids.min.y), offsetZ = _mm_set1_ps(centroids.min.z);
+	__m128 extentX = _mm_set1_ps(centroids.max.x - centroids.min.x);
+	__m128 extentY = _mm_set1_ps(centroids.max.y - centroids.min.y);
+	__m128 extentZ = _mm_set1_ps(centroids.max.z - centroids.min.z);
+
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_set1_ps(1023.0f);
+
+	for(; i < (count & ~(uint32_t)3); i += 4)
+	{
+		__m128 minX, minY, minZ, maxX, maxY, maxZ;
+		QM_FUNC_PREFIX(bbox3_load4_sse)(&prims[i], &minX, &minY, &minZ, &maxX, &maxY, &maxZ);
+
+		__m128 x = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(maxX, minX), half), offsetX), extentX);
+		__m128 y = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(maxY, minY), half), offsetY), extentY);
+		__m128 z = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(maxZ, minZ), half), offsetZ), extentZ);
+
+		__m128i qx = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, zero), one), scale));
+		__m128i qy = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, zero), one), scale));
+		__m128i qz = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(z, zero), one), scale));
+
+		__m128i code = _mm_slli_epi32(QM_FUNC_PREFIX(morton_expand_bits_sse)(qx), 2);
+		code = _mm_or_si128(code, _mm_slli_epi32(QM_FUNC_PREFIX(morton_expand_bits_sse)(qy), 1));
+		code = _mm_or_si128(code, QM_FUNC_PREFIX(morton_expand_bits_sse)(qz));
+
+		_mm_storeu_si128((__m128i*)&codes[i], code);
+	}
+
+	#endif
+
+	for(; i < count; i++)
+	{
+		QMvec3 offset = QM_FUNC_PREFIX(bbox3_offset)(centroids, QM_FUNC_PREFIX(bbox3_centroid)(prims[i]));
+		codes[i] = QM_FUNC_PREFIX(morton_code)(offset);
+	}
+}
+
+//sorts 30 bit keys and their values with 3 passes of 11, 11, and 10 bits. the result ends up in tempKeys and tempValues
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(radix_sort_30)(uint32_t* keys, uint32_t* values, uint32_t* tempKeys, uint32_t* tempValues, uint32_t count)
+{
+	uint32_t offsets[3][2048] = {0};
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t key = keys[i];
+		offsets[0][ key        & 2047]++;
+		offsets[1][(key >> 11) & 2047]++;
+		offsets[2][(key >> 22) & 2047]++;
+	}
+
+	for(int p = 0; p < 3; p++)
+	{
+		uint32_t sum = 0;
+		for(int b = 0; b < 2048; b++)
+		{
+			uint32_t c = offsets[p][b];
+			offsets[p][b] = sum;
+			sum += c;
+		}
+	}
+
+	uint32_t* fromKeys = keys, *fromValues = values;
+	uint32_t* toKeys = tempKeys, *toValues = tempValues;
+	for(int p = 0; p < 3; p++)
+	{
+		int shift = p * 11;
+		for(uint32_t i = 0; i < count; i++)
+		{
+			uint32_t dst = offsets[p][(fromKeys[i] >> shift) & 2047]++;
+			toKeys[dst] = fromKeys[i];
+			toValues[dst] = fromValues[i];
+		}
+
+		uint32_t* temp;
+		temp = fromKeys;   fromKeys = toKeys;     toKeys = temp;
+		temp = fromValues; fromValues = toValues; toValues = temp;
+	}
+}
+
+//builds a bounding volume hierarchy by sorting the primitives along a morton curve and splitting each range where the
+//highest differing bit of its codes changes. much faster to build than bvh_build, but the tree is of lower quality.
+//leaves hold one primitive, so nodes must be able to hold 2 * count - 1 nodes. scratch must hold 3 * count elements
+
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(bvh_build_lbvh)(const QMbbox3* prims, uint32_t count, QMbvhNode* nodes, uint32_t* primIndices, uint32_t* scratch)
+{
+	if(count == 0)
+		return 0;
+
+	QMbbox3 centroids = QM_FUNC_PREFIX(bbox3_initialized)();
+	for(uint32_t i = 0; i < count; i++)
+		centroids = QM_FUNC_PREFIX(bbox3_union_vec3)(centroids, QM_FUNC_PREFIX(bbox3_centroid)(prims[i]));
+
+	//flat axes would divide by 0
+	for(int a = 0; a < 3; a++)
+	{
+		if(centroids.max.v[a] <= centroids.min.v[a])
+			centroids.max.v[a] = centroids.min.v[a] + 1.0f;
+	}
+
+	//sort, the passes go from the codes and indices in scratch to the codes in scratch + count and indices in primIndices
+	uint32_t* codes = scratch + count;
+	QM_FUNC_PREFIX(bvh_morton_codes)(prims, count, centroids, scratch);
+	for(uint32_t i = 0; i < count; i++)
+		scratch[count * 2 + i] = i;
+
+	QM_FUNC_PREFIX(radix_sort_30)(scratch, scratch + count * 2, codes, primIndices, count);
+
+	//emit the topology top down in depth-first order, like bvh_build
+	uint32_t stackNodes[QM_BVH_MAX_DEPTH];
+	uint32_t stackDepths[QM_BVH_MAX_DEPTH];
+	int stackSize = 1;
+	stackNodes[0] = 0;
+	stackDepths[0] = 0;
+
+	nodes[0].leftFirst = 0;
+	nodes[0].count = count;
+	uint32_t nodeCount = 1;
+
+	while(stackSize > 0)
+	{
+		stackSize--;
+		QMbvhNode* node = &nodes[stackNodes[stackSize]];
+		uint32_t depth = stackDepths[stackSize];
+
+		uint32_t first = node->leftFirst;
+		uint32_t n = node->count;
+		if(n <= 1 || depth + 1 >= QM_BVH_MAX_DEPTH)
+			continue;
+
+		//find the first code with the highest differing bit set, equal codes are split in half
+		uint32_t last = first + n - 1;
+		uint32_t diff = codes[first] ^ codes[last];
+		uint32_t mid;
+		if(diff == 0)
+			mid = first + n / 2;
+		else
+		{
+			uint32_t bit = 0x80000000u >> QM_FUNC_PREFIX(clz32)(diff);
+			uint32_t target = codes[last] & ~(bit - 1);
+
+			uint32_t lo = first + 1;
+			uint32_t hi = last;
+			while(lo < hi)
+			{
+				uint32_t m = lo + (hi - lo) / 2;
+				if(codes[m] < target)
+					lo = m + 1;
+				else
+					hi = m;
+			}
+
+			mid = lo;
+		}
+
+		uint32_t left = nodeCount;
+		nodeCount += 2;
+
+		nodes[left].leftFirst = first;
+		nodes[left].count = mid - first;
+		nodes[left + 1].leftFirst = mid;
+		nodes[left + 1].count = first + n - mid;
+
+		node->leftFirst = left;
+		node->count = 0;
+
+		stackNodes[stackSize] = left + 1;
+		stackDepths[stackSize] = depth + 1;
+		stackNodes[stackSize + 1] = left;
+		stackDepths[stackSize + 1] = depth + 1;
+		stackSize += 2;
+	}
+
+	//children always come after their parents, so the bounds can be filled in bottom up with one backwards pass
+	for(uint32_t i = nodeCount; i > 0; i--)
+	{
+		QMbvhNode* node = &nodes[i - 1];
+
+		if(node->count > 0)
+		{
+			node->bounds = prims[primIndices[node->leftFirst]];
+			for(uint32_t j = 1; j < node->count; j++)
+				node->bounds = QM_FUNC_PREFIX(bbox3_union)(node->bounds, prims[primIndices[node->leftFirst + j]]);
+		}
+		else
+			node->bounds = QM_FUNC_PREFIX(bbox3_union)(nodes[node->leftFirst].bounds, nodes[node->leftFirst + 1].bounds);
+	}
+
+	return nodeCount;
+}
+
+//the expected cost of a ray traversing the hierarchy under the surface area heuristic, relative to testing
+//one primitive. useful for comparing the quality of different builds over the same primitives
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bvh_sah_cost)(const QMbvhNode* nodes)
+{
+	uint32_t stack[QM_BVH_MAX_DEPTH];
+	int stackSize = 0;
+
+	float rootArea = QM_FUNC_PREFIX(bbox3_surface_area)(nodes[0].bounds);
+	if(rootArea <= 0.0f)
+		return (float)nodes[0].count;
+
+	float cost = 0.0f;
+	uint32_t node = 0;
+	for(;;)
+	{
+		const QMbvhNode* n = &nodes[node];
+		float area = QM_FUNC_PREFIX(bbox3_surface_area)(n->bounds);
+
+		if(n->count > 0)
+			cost += area * (float)n->count;
+		else
+		{
+			cost += area;
+
+			stack[stackSize++] = n->leftFirst + 1;
+			node = n->leftFirst;
+			continue;
+		}
+
+		if(stackSize == 0)
+			break;
+
+		node = stack[--stackSize];
+	}
+
+	return cost / rootArea;
+}
+
+//refitting:
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bvh_node_cost)(const QMbvhNode* node)
+{
+	//the node's term of the sah cost before dividing by the root's area
+	float area = QM_FUNC_PREFIX(bbox3_surface_area)(node->bounds);
+	return node->count > 0 ? area * (float)node->count : area;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit_relink)(QMbvhRefit* r, uint32_t node)
+{
+	//points the children or primitives of a node that was moved to a new index back at it
+	const QMbvhNode* n = &r->nodes[node];
+
+	if(n->count > 0)
+	{
+		for(uint32_t i = 0; i < n->count; i++)
+			r->primLeaves[r->primIndices[n->leftFirst + i]] = node;
+	}
+	else
+	{
+		r->parents[n->leftFirst] = node;
+		r->parents[n->leftFirst + 1] = node;
+	}
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit_interior)(QMbvhRefit* r, uint32_t node)
+{
+	QMbvhNode* n = &r->nodes[node];
+	uint32_t left = n->leftFirst;
+
+	r->areaSum -= QM_FUNC_PREFIX(bvh_node_cost)(n);
+	n->bounds = QM_FUNC_PREFIX(bbox3_union)(r->nodes[left].bounds, r->nodes[left + 1].bounds);
+	r->areaSum += QM_FUNC_PREFIX(bvh_node_cost)(n);
+
+	r->heights[node] = (uint8_t)(QM_MAX(r->heights[left], r->heights[left + 1]) + 1);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_rotate)(QMbvhRefit* r, uint32_t node, uint32_t depth)
+{
+	//tries swapping each child with a grandchild under its sibling, keeping the swap that shrinks the
+	//sibling the most. only the sibling's bounds change, every other node keeps the same primitives
+	QMbvhNode* nodes = r->nodes;
+	uint32_t children = nodes[node].leftFirst;
+
+	float bestGain = 0.0f;
+	uint32_t bestChild = 0;
+	uint32_t bestGrandchild = 0;
+
+	for(uint32_t c = 0; c < 2; c++)
+	{
+		uint32_t child = children + c;
+		uint32_t sibling = children + (c ^ 1);
+		if(nodes[sibling].count > 0)
+			continue;
+
+		//the child moves one level down, which must not push its subtree past the traversal stack limit
+		if(depth + 2 + r->heights[child] >= QM_BVH_MAX_DEPTH)
+			continue;
+
+		float siblingArea = QM_FUNC_PREFIX(bbox3_surface_area)(nodes[sibling].bounds);
+		uint32_t grandchildren = nodes[sibling].leftFirst;
+
+		for(uint32_t g = 0; g < 2; g++)
+		{
+			QMbbox3 rotated = QM_FUNC_PREFIX(bbox3_union)(nodes[child].bounds, nodes[grandchildren + (g ^ 1)].bounds);
+			float gain = siblingArea - QM_FUNC_PREFIX(bbox3_surface_area)(rotated);
+
+			if(gain > bestGain)
+			{
+				bestGain = gain;
+				bestChild = child;
+				bestGrandchild = grandchildren + g;
+			}
+		}
+	}
+
+	if(bestGain <= 0.0f)
+		return;
+
+	QMbvhNode temp = nodes[bestChild];
+	nodes[bestChild] = nodes[bestGrandchild];
+	nodes[bestGrandchild] = temp;
+
+	uint8_t tempHeight = r->heights[bestChild];
+	r->heights[bestChild] = r->heights[bestGrandchild];
+	r->heights[bestGrandchild] = tempHeight;
+
+	QM_FUNC_PREFIX(bvh_refit_relink)(r, bestChild);
+	QM_FUNC_PREFIX(bvh_refit_relink)(r, bestGrandchild);
+	QM_FUNC_PREFIX(bvh_refit_interior)(r, r->parents[bestGrandchild]);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit_dirty)(QMbvhRefit* r, QMbool rotate)
+{
+	//visits the dirty nodes in post-order so every node is recomputed once, after its children.
+	//rotations move subtrees between indices, so children can't be assumed to come after their parents
+	uint32_t stack[2 * QM_BVH_MAX_DEPTH + 1];
+	uint32_t stackDepth[2 * QM_BVH_MAX_DEPTH + 1];
+	QMbool stackVisited[2 * QM_BVH_MAX_DEPTH + 1];
+	int stackSize = 0;
+
+	if(!r->dirty[0])
+		return;
+
+	stack[0] = 0;
+	stackDepth[0] = 0;
+	stackVisited[0] = 0;
+	stackSize = 1;
+
+	while(stackSize > 0)
+	{
+		int top = stackSize - 1;
+		uint32_t node = stack[top];
+		QMbvhNode* n = &r->nodes[node];
+
+		if(!stackVisited[top])
+		{
+			stackVisited[top] = 1;
+
+			if(n->count == 0)
+				for(uint32_t c = 2; c > 0; c--)
+				{
+					uint32_t child = n->leftFirst + c - 1;
+					if(!r->dirty[child])
+						continue;
+
+					stack[stackSize] = child;
+					stackDepth[stackSize] = stackDepth[top] + 1;
+					stackVisited[stackSize] = 0;
+					stackSize++;
+				}
+
+			continue;
+		}
+
+		stackSize--;
+		r->dirty[node] = 0;
+
+		if(n->count > 0)
+		{
+			r->areaSum -= QM_FUNC_PREFIX(bvh_node_cost)(n);
+
+			n->bounds = r->prims[r->primIndices[n->leftFirst]];
+			for(uint32_t i = 1; i < n->count; i++)
+				n->bounds = QM_FUNC_PREFIX(bbox3_union)(n->bounds, r->prims[r->primIndices[n->leftFirst + i]]);
+
+			r->areaSum += QM_FUNC_PREFIX(bvh_node_cost)(n);
+			r->heights[node] = 0;
+		}
+		else
+		{
+			if(rotate)
+				QM_FUNC_PREFIX(bvh_rotate)(r, node, stackDepth[top]);
+
+			QM_FUNC_PREFIX(bvh_refit_interior)(r, node);
+		}
+	}
+}
+
+//fills the parent links and refits the whole hierarchy to the current primitive bounds. the sah cost
+//afterwards is what qm_bvh_refit_cost_drift compares against, so call this again after rebuilding
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit_init)(QMbvhRefit* r)
+{
+	r->dirtyCount = 0;
+	r->areaSum = 0.0f;
+	r->initialCost = 0.0f;
+
+	if(r->nodeCount == 0)
+		return;
+
+	r->parents[0] = UINT32_MAX;
+	for(uint32_t i = 0; i < r->nodeCount; i++)
+	{
+		r->dirty[i] = 1;
+		r->heights[i] = 0;
+		r->areaSum += QM_FUNC_PREFIX(bvh_node_cost)(&r->nodes[i]);
+		QM_FUNC_PREFIX(bvh_refit_relink)(r, i);
+	}
+
+	QM_FUNC_PREFIX(bvh_refit_dirty)(r, 0);
+
+	//summed from scratch rather than keeping the rounding of every update above
+	r->initialCost = QM_FUNC_PREFIX(bvh_sah_cost)(r->nodes);
+	r->areaSum = r->initialCost * QM_FUNC_PREFIX(bbox3_surface_area)(r->nodes[0].bounds);
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit_mark_dirty)(QMbvhRefit* r, uint32_t prim)
+{
+	uint32_t leaf = r->primLeaves[prim];
+	if(r->dirty[leaf])
+		return;
+
+	r->dirty[leaf] = 1;
+	r->dirtyList[r->dirtyCount++] = leaf;
+}
+
+//recomputes the dirty leaves and only their ancestors, the cost is proportional to the number of dirty leaves
+//times the depth. with rotate set, each recomputed node also swaps a child with a grandchild when that lowers
+//the sah cost, which slows the decay of the tree as primitives move away from where it was built
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bvh_refit)(QMbvhRefit* r, QMbool rotate)
+{
+	//marks the ancestors of every dirty leaf, stopping at the first one already marked by another leaf
+	for(uint32_t i = 0; i < r->dirtyCount; i++)
+	{
+		uint32_t node = r->dirtyList[i];
+		while(node != 0)
+		{
+			node = r->parents[node];
+			if(r->dirty[node])
+				break;
+
+			r->dirty[node] = 1;
+		}
+	}
+
+	r->dirtyCount = 0;
+	if(r->nodeCount > 0)
+		QM_FUNC_PREFIX(bvh_refit_dirty)(r, rotate);
+}
+
+//the current sah cost relative to the cost after qm_bvh_refit_init, 1.0 when the tree is as good as when
+//it was built. nodes overlap more as their primitives drift apart, so rebuild once this passes a threshold like 1.5
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bvh_refit_cost_drift)(const QMbvhRefit* r)
+{
+	if(r->nodeCount == 0 || r->initialCost <= 0.0f)
+		return 1.0f;
+
+	float rootArea = QM_FUNC_PREFIX(bbox3_surface_area)(r->nodes[0].bounds);
+	if(rootArea <= 0.0f)
+		return 1.0f;
+
+	return r->areaSum / rootArea / r->initialCost;
+}
+
+//----------------------------------------------------------------------//
+//TRANSFORM HIERARCHY FUNCTIONS:
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(hierarchy_init)(QMhierarchy* h)
+{
+	//in depth-first order a subtree ends where the last subtree of its children ends,
+	//so walking backwards sees every child's range before its parent's
+	for(int i = 0; i < h->count; i++)
+	{
+		h->subtreeEnd[i] = i + 1;
+		h->dirty[i] = 0;
+	}
+
+	for(int i = h->count - 1; i >= 0; i--)
+	{
+		int parent = h->parents[i];
+		if(parent >= 0)
+			h->subtreeEnd[parent] = QM_MAX(h->subtreeEnd[parent], h->subtreeEnd[i]);
+	}
+
+	h->dirtyCount = 0;
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(hierarchy_mark_dirty)(QMhierarchy* h, int node)
+{
+	if(h->dirty[node])
+		return;
 
-	return result;
+	h->dirty[node] = 1;
+	h->dirtyList[h->dirtyCount++] = node;
 }
 
-QM_FUNC_ATTRIBS QMvec4 QM_FUNC_PREFIX(mat4_mult_vec4)(QMmat4 m, QMvec4 v)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(hierarchy_update_range)(QMhierarchy* h, int start, int end)
 {
-	QMvec4 result;
+	for(int i = start; i < end; i++)
+	{
+		int parent = h->parents[i];
 
-	#if QM_USE_SSE
+		if(parent >= 0)
+			h->world[i] = QM_FUNC_PREFIX(mat4_mult)(h->world[parent], h->local[i]);
+		else
+			h->world[i] = h->local[i];
 
-	result.packed = QM_FUNC_PREFIX(mat4_mult_column_sse)(v.packed, m);
+		h->dirty[i] = 0;
+	}
+}
 
-	#else
+//recomputes only the subtrees of the dirty nodes, the cost is proportional to the size of those subtrees
 
-	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z + m.m[3][0] * v.w;
-	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z + m.m[3][1] * v.w;
-	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z + m.m[3][2] * v.w;
-	result.w = m.m[0][3] * v.x + m.m[1][3] * v.y + m.m[2][3] * v.z + m.m[3][3] * v.w;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(hierarchy_update)(QMhierarchy* h)
+{
+	//once sorted, a dirty node inside the previous recomputed range has a dirty ancestor and is already done
+	QM_FUNC_PREFIX(sort_ints)(h->dirtyList, h->dirtyCount);
 
-	#endif
+	int coveredEnd = 0;
+	for(int i = 0; i < h->dirtyCount; i++)
+	{
+		int node = h->dirtyList[i];
+		if(node < coveredEnd)
+			continue;
 
-	return result;
+		coveredEnd = h->subtreeEnd[node];
+		QM_FUNC_PREFIX(hierarchy_update_range)(h, node, coveredEnd);
+	}
+
+	h->dirtyCount = 0;
 }
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(mat4_transform_vec3)(QMmat4 m, QMvec3 v)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(hierarchy_update_all)(QMhierarchy* h)
 {
-	QMvec3 result;
-
-	result.x = m.m[0][0] * v.x + m.m[1][0] * v.y + m.m[2][0] * v.z + m.m[3][0];
-	result.y = m.m[0][1] * v.x + m.m[1][1] * v.y + m.m[2][1] * v.z + m.m[3][1];
-	result.z = m.m[0][2] * v.x + m.m[1][2] * v.y + m.m[2][2] * v.z + m.m[3][2];
-
-	return result;	
+	QM_FUNC_PREFIX(hierarchy_update_range)(h, 0, h->count);
+	h->dirtyCount = 0;
 }
 
-//transpose:
+//----------------------------------------------------------------------//
+//COMPRESSION FUNCTIONS:
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_transpose)(QMmat3 m)
+//smallest-three quaternions: q and -q are the same rotation, so q is negated to make its largest component positive,
+//which is then dropped and rebuilt from the unit length. the other 3 lie in [-1/sqrt(2), 1/sqrt(2)] and are
+//quantized to bits bits each, with 0 exactly representable. q must be normalized
+
+QM_FUNC_ATTRIBS uint64_t QM_FUNC_PREFIX(quaternion_pack_smallest3)(QMquaternion q, int bits)
 {
-	QMmat3 result;
+	int largest = 0;
+	for(int i = 1; i < 4; i++)
+		if(QM_FUNC_PREFIX(absf)(q.q[i]) > QM_FUNC_PREFIX(absf)(q.q[largest]))
+			largest = i;
 
-	result.m[0][0] = m.m[0][0];
-	result.m[0][1] = m.m[1][0];
-	result.m[0][2] = m.m[2][0];
-	result.m[1][0] = m.m[0][1];
-	result.m[1][1] = m.m[1][1];
-	result.m[1][2] = m.m[2][1];
-	result.m[2][0] = m.m[0][2];
-	result.m[2][1] = m.m[1][2];
-	result.m[2][2] = m.m[2][2];
+	float half = (float)((1 << (bits - 1)) - 1);
+	float scale = q.q[largest] < 0.0f ? -1.41421356f * half : 1.41421356f * half;
+
+	uint64_t result = (uint64_t)largest;
+	for(int i = 0; i < 4; i++)
+	{
+		if(i == largest)
+			continue;
+
+		float n = QM_MIN(QM_MAX(q.q[i] * scale + (half + 0.5f), 0.0f), 2.0f * half);
+		result = (result << bits) | (uint64_t)n;
+	}
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_transpose)(QMmat4 m)
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_unpack_smallest3)(uint64_t packed, int bits)
 {
-	QMmat4 result = m;
-
-	#if QM_USE_SSE
+	QMquaternion result;
 
-	_MM_TRANSPOSE4_PS(result.packed[0], result.packed[1], result.packed[2], result.packed[3]);
+	float half = (float)((1 << (bits - 1)) - 1);
+	float scale = 0.70710678f / half;
+	uint32_t mask = (1u << bits) - 1;
+	int largest = (int)(packed >> (3 * bits)) & 3;
 
-	#else
+	float lengthSqr = 0.0f;
+	for(int i = 3; i >= 0; i--)
+	{
+		if(i == largest)
+			continue;
 
-	result.m[0][0] = m.m[0][0];
-	result.m[0][1] = m.m[1][0];
-	result.m[0][2] = m.m[2][0];
-	result.m[0][3] = m.m[3][0];
-	result.m[1][0] = m.m[0][1];
-	result.m[1][1] = m.m[1][1];
-	result.m[1][2] = m.m[2][1];
-	result.m[1][3] = m.m[3][1];
-	result.m[2][0] = m.m[0][2];
-	result.m[2][1] = m.m[1][2];
-	result.m[2][2] = m.m[2][2];
-	result.m[2][3] = m.m[3][2];
-	result.m[3][0] = m.m[0][3];
-	result.m[3][1] = m.m[1][3];
-	result.m[3][2] = m.m[2][3];
-	result.m[3][3] = m.m[3][3];
+		result.q[i] = ((float)(uint32_t)(packed & mask) - half) * scale;
+		lengthSqr += result.q[i] * result.q[i];
+		packed >>= bits;
+	}
 
-	#endif
+	result.q[largest] = QM_SQRTF(QM_MAX(1.0f - lengthSqr, 0.0f));
 
 	return result;
 }
 
-//inverse:
+//32 bits, the index of the dropped component in the top 2 bits and the others in 10 bits each. the max error is
+//0.0007 for the kept components and 0.0021 for the dropped one
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_inv)(QMmat3 m)
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(quaternion_pack32)(QMquaternion q)
 {
-	QMmat3 result;
+	return (uint32_t)QM_FUNC_PREFIX(quaternion_pack_smallest3)(q, 10);
+}
 
-	float det;
-  	float a = m.m[0][0], b = m.m[0][1], c = m.m[0][2],
-	      d = m.m[1][0], e = m.m[1][1], f = m.m[1][2],
-	      g = m.m[2][0], h = m.m[2][1], i = m.m[2][2];
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_unpack32)(uint32_t packed)
+{
+	return QM_FUNC_PREFIX(quaternion_unpack_smallest3)(packed, 10);
+}
 
-	result.m[0][0] =   e * i - f * h;
-	result.m[0][1] = -(b * i - h * c);
-	result.m[0][2] =   b * f - e * c;
-	result.m[1][0] = -(d * i - g * f);
-	result.m[1][1] =   a * i - c * g;
-	result.m[1][2] = -(a * f - d * c);
-	result.m[2][0] =   d * h - g * e;
-	result.m[2][1] = -(a * h - g * b);
-	result.m[2][2] =   a * e - b * d;
+//48 bits, the index of the dropped component in bits 45-46 and the others in 15 bits each. the max error is
+//0.000022 for the kept components and 0.000065 for the dropped one
 
-	det = 1.0f / (a * result.m[0][0] + b * result.m[1][0] + c * result.m[2][0]);
+QM_FUNC_ATTRIBS QMquaternion48 QM_FUNC_PREFIX(quaternion_pack48)(QMquaternion q)
+{
+	QMquaternion48 result;
 
-	result.m[0][0] *= det;
-	result.m[0][1] *= det;
-	result.m[0][2] *= det;
-	result.m[1][0] *= det;
-	result.m[1][1] *= det;
-	result.m[1][2] *= det;
-	result.m[2][0] *= det;
-	result.m[2][1] *= det;
-	result.m[2][2] *= det;
+	uint64_t packed = QM_FUNC_PREFIX(quaternion_pack_smallest3)(q, 15);
+	result.v[0] = (uint16_t)packed;
+	result.v[1] = (uint16_t)(packed >> 16);
+	result.v[2] = (uint16_t)(packed >> 32);
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_inv)(QMmat4 mat)
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_unpack48)(QMquaternion48 packed)
 {
-	//TODO: this function is not SIMD optimized, figure out how to do it
+	uint64_t bits = (uint64_t)packed.v[0] | ((uint64_t)packed.v[1] << 16) | ((uint64_t)packed.v[2] << 32);
+	return QM_FUNC_PREFIX(quaternion_unpack_smallest3)(bits, 15);
+}
 
-	QMmat4 result;
+//positions quantized to 16 bits per axis within b, from qm_bbox3_offset. points outside b are clamped to it, the
+//max error is the extent of b / 131070 per axis
 
-	float tmp[6];
-	float det;
-	float a = mat.m[0][0], b = mat.m[0][1], c = mat.m[0][2], d = mat.m[0][3],
-	      e = mat.m[1][0], f = mat.m[1][1], g = mat.m[1][2], h = mat.m[1][3],
-	      i = mat.m[2][0], j = mat.m[2][1], k = mat.m[2][2], l = mat.m[2][3],
-	      m = mat.m[3][0], n = mat.m[3][1], o = mat.m[3][2], p = mat.m[3][3];
+QM_FUNC_ATTRIBS QMvec3u16 QM_FUNC_PREFIX(vec3_pack16)(QMbbox3 b, QMvec3 v)
+{
+	QMvec3u16 result;
 
-	tmp[0] = k * p - o * l; 
-	tmp[1] = j * p - n * l; 
-	tmp[2] = j * o - n * k;
-	tmp[3] = i * p - m * l; 
-	tmp[4] = i * o - m * k; 
-	tmp[5] = i * n - m * j;
+	QMvec3 offset = QM_FUNC_PREFIX(bbox3_offset)(b, v);
+	for(int i = 0; i < 3; i++)
+		result.v[i] = (uint16_t)(QM_MIN(QM_MAX(offset.v[i], 0.0f), 1.0f) * 65535.0f + 0.5f);
 
-	result.m[0][0] =   f * tmp[0] - g * tmp[1] + h * tmp[2];
-	result.m[1][0] = -(e * tmp[0] - g * tmp[3] + h * tmp[4]);
-	result.m[2][0] =   e * tmp[1] - f * tmp[3] + h * tmp[5];
-	result.m[3][0] = -(e * tmp[2] - f * tmp[4] + g * tmp[5]);
+	return result;
+}
 
-	result.m[0][1] = -(b * tmp[0] - c * tmp[1] + d * tmp[2]);
-	result.m[1][1] =   a * tmp[0] - c * tmp[3] + d * tmp[4];
-	result.m[2][1] = -(a * tmp[1] - b * tmp[3] + d * tmp[5]);
-	result.m[3][1] =   a * tmp[2] - b * tmp[4] + c * tmp[5];
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_unpack16)(QMbbox3 b, QMvec3u16 packed)
+{
+	QMvec3 result;
 
-	tmp[0] = g * p - o * h;
-	tmp[1] = f * p - n * h;
-	tmp[2] = f * o - n * g;
-	tmp[3] = e * p - m * h;
-	tmp[4] = e * o - m * g;
-	tmp[5] = e * n - m * f;
+	QMvec3 scale = QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(bbox3_extent)(b), 1.0f / 65535.0f);
+	for(int i = 0; i < 3; i++)
+		result.v[i] = b.min.v[i] + (float)packed.v[i] * scale.v[i];
 
-	result.m[0][2] =   b * tmp[0] - c * tmp[1] + d * tmp[2];
-	result.m[1][2] = -(a * tmp[0] - c * tmp[3] + d * tmp[4]);
-	result.m[2][2] =   a * tmp[1] - b * tmp[3] + d * tmp[5];
-	result.m[3][2] = -(a * tmp[2] - b * tmp[4] + c * tmp[5]);
+	return result;
+}
 
-	tmp[0] = g * l - k * h;
-	tmp[1] = f * l - j * h;
-	tmp[2] = f * k - j * g;
-	tmp[3] = e * l - i * h;
-	tmp[4] = e * k - i * g;
-	tmp[5] = e * j - i * f;
+//octahedral unit vectors: v is projected onto the octahedron |x| + |y| + |z| = 1 and the lower half folded over the
+//diagonals of the upper half's square, leaving 2 components in [-1, 1] that are stored in 16 bits each. the max
+//angle between v and the unpacked vector is 0.0038 degrees (6.6e-5 radians). v must be normalized
 
-	result.m[0][3] = -(b * tmp[0] - c * tmp[1] + d * tmp[2]);
-	result.m[1][3] =   a * tmp[0] - c * tmp[3] + d * tmp[4];
-	result.m[2][3] = -(a * tmp[1] - b * tmp[3] + d * tmp[5]);
-  	result.m[3][3] =   a * tmp[2] - b * tmp[4] + c * tmp[5];
+QM_FUNC_ATTRIBS uint32_t QM_FUNC_PREFIX(vec3_pack_oct)(QMvec3 v)
+{
+	float invLength = 1.0f / (QM_FUNC_PREFIX(absf)(v.x) + QM_FUNC_PREFIX(absf)(v.y) + QM_FUNC_PREFIX(absf)(v.z));
+	float x = v.x * invLength;
+	float y = v.y * invLength;
 
-  	det = 1.0f / (a * result.m[0][0] + b * result.m[1][0]
-                + c * result.m[2][0] + d * result.m[3][0]);
+	if(v.z < 0.0f)
+	{
+		float foldedX = (1.0f - QM_FUNC_PREFIX(absf)(y)) * (x < 0.0f ? -1.0f : 1.0f);
+		float foldedY = (1.0f - QM_FUNC_PREFIX(absf)(x)) * (y < 0.0f ? -1.0f : 1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
 
-	#if QM_USE_SSE
+	uint32_t packedX = (uint32_t)(QM_MIN(QM_MAX(x, -1.0f), 1.0f) * 32767.0f + 32767.5f);
+	uint32_t packedY = (uint32_t)(QM_MIN(QM_MAX(y, -1.0f), 1.0f) * 32767.0f + 32767.5f);
 
-	__m128 scale = _mm_set1_ps(det);
-	result.packed[0] = _mm_mul_ps(result.packed[0], scale);
-	result.packed[1] = _mm_mul_ps(result.packed[1], scale);
-	result.packed[2] = _mm_mul_ps(result.packed[2], scale);
-	result.packed[3] = _mm_mul_ps(result.packed[3], scale);
+	return packedX | (packedY << 16);
+}
 
-	#else
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(vec3_unpack_oct)(uint32_t packed)
+{
+	QMvec3 result;
 
-	result.m[0][0] = result.m[0][0] * det;
-	result.m[0][1] = result.m[0][1] * det;
-	result.m[0][2] = result.m[0][2] * det;
-	result.m[0][3] = result.m[0][3] * det;
-	result.m[1][0] = result.m[1][0] * det;
-	result.m[1][1] = result.m[1][1] * det;
-	result.m[1][2] = result.m[1][2] * det;
-	result.m[1][3] = result.m[1][3] * det;
-	result.m[2][0] = result.m[2][0] * det;
-	result.m[2][1] = result.m[2][1] * det;
-	result.m[2][2] = result.m[2][2] * det;
-	result.m[2][3] = result.m[2][3] * det;
-	result.m[3][0] = result.m[3][0] * det;
-	result.m[3][1] = result.m[3][1] * det;
-	result.m[3][2] = result.m[3][2] * det;
-	result.m[3][3] = result.m[3][3] * det;
+	float x = ((float)(packed & 0xFFFF) - 32767.0f) * (1.0f / 32767.0f);
+	float y = ((float)(packed >> 16) - 32767.0f) * (1.0f / 32767.0f);
+	float z = 1.0f - QM_FUNC_PREFIX(absf)(x) - QM_FUNC_PREFIX(absf)(y);
 
-	#endif
+	//unfold the lower half
+	float fold = QM_MAX(-z, 0.0f);
+	x -= x < 0.0f ? -fold : fold;
+	y -= y < 0.0f ? -fold : fold;
 
-  	return result;
+	float invLength = 1.0f / QM_SQRTF(x * x + y * y + z * z);
+	result.x = x * invLength;
+	result.y = y * invLength;
+	result.z = z * invLength;
+
+	return result;
 }
 
-//translation:
+//array:
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_translate)(QMvec2 t)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack32_array_scalar)(const QMquaternion* in, uint32_t* out, size_t count)
 {
-	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(quaternion_pack32)(in[i]);
+}
 
-	result.m[2][0] = t.x;
-	result.m[2][1] = t.y;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack32_array_scalar)(const uint32_t* in, QMquaternion* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(quaternion_unpack32)(in[i]);
+}
 
-	return result;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack48_array_scalar)(const QMquaternion* in, QMquaternion48* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(quaternion_pack48)(in[i]);
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_translate)(QMvec3 t)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack48_array_scalar)(const QMquaternion48* in, QMquaternion* out, size_t count)
 {
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(quaternion_unpack48)(in[i]);
+}
 
-	result.m[3][0] = t.x;
-	result.m[3][1] = t.y;
-	result.m[3][2] = t.z;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack16_array_scalar)(QMbbox3 b, const QMvec3* in, QMvec3u16* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(vec3_pack16)(b, in[i]);
+}
 
-	return result;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack16_array_scalar)(QMbbox3 b, const QMvec3u16* in, QMvec3* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(vec3_unpack16)(b, in[i]);
 }
 
-//scaling:
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack_oct_array_scalar)(const QMvec3* in, uint32_t* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(vec3_pack_oct)(in[i]);
+}
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_scale)(QMvec2 s)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack_oct_array_scalar)(const uint32_t* in, QMvec3* out, size_t count)
 {
-	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+	for(size_t i = 0; i < count; i++)
+		out[i] = QM_FUNC_PREFIX(vec3_unpack_oct)(in[i]);
+}
 
-	result.m[0][0] = s.x;
-	result.m[1][1] = s.y;
+#if QM_USE_SSE || QM_USE_DISPATCH
 
-	return result;
-}
+//the SIMD kernels match the scalar functions operation for operation, so they produce the same bits unless the
+//compiler contracts the scalar ones into fused multiply-adds
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_scale)(QMvec3 s)
+QM_FUNC_ATTRIBS __m128 QM_FUNC_PREFIX(select_sse)(__m128 mask, __m128 a, __m128 b)
 {
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
-
-	result.m[0][0] = s.x;
-	result.m[1][1] = s.y;
-	result.m[2][2] = s.z;
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
 
-	return result;
+QM_FUNC_ATTRIBS __m128i QM_FUNC_PREFIX(quantize_sse)(__m128 v, __m128 scale, __m128 offset, __m128 maxValue)
+{
+	__m128 n = _mm_add_ps(_mm_mul_ps(v, scale), offset);
+	return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(n, _mm_setzero_ps()), maxValue));
 }
 
-//rotation:
+//packs 4 quaternions as x, y, z, and w lanes into the dropped component's index and the other 3 components
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack_smallest3_sse)(__m128 x, __m128 y, __m128 z, __m128 w, int bits,
+                                                                   __m128i* index, __m128i* a, __m128i* b, __m128i* c)
+{
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	//the largest component, ties go to the first like the scalar loop
+	__m128 largest = _mm_and_ps(x, absMask);
+	__m128 is1 = _mm_cmpgt_ps(_mm_and_ps(y, absMask), largest);
+	largest = QM_FUNC_PREFIX(select_sse)(is1, _mm_and_ps(y, absMask), largest);
+	__m128 is2 = _mm_cmpgt_ps(_mm_and_ps(z, absMask), largest);
+	largest = QM_FUNC_PREFIX(select_sse)(is2, _mm_and_ps(z, absMask), largest);
+	__m128 is3 = _mm_cmpgt_ps(_mm_and_ps(w, absMask), largest);
+	is2 = _mm_andnot_ps(is3, is2);
+	is1 = _mm_andnot_ps(_mm_or_ps(is2, is3), is1);
+
+	__m128i one = _mm_set1_epi32(1);
+	*index = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(_mm_castps_si128(is1), one), _mm_and_si128(_mm_castps_si128(is2), _mm_set1_epi32(2))),
+	                       _mm_and_si128(_mm_castps_si128(is3), _mm_set1_epi32(3)));
+
+	//the kept components in order, and the sign of the dropped one
+	__m128 after0 = _mm_or_ps(_mm_or_ps(is1, is2), is3);
+	__m128 after1 = _mm_or_ps(is2, is3);
+	__m128 keptA = QM_FUNC_PREFIX(select_sse)(after0, x, y);
+	__m128 keptB = QM_FUNC_PREFIX(select_sse)(after1, y, z);
+	__m128 keptC = QM_FUNC_PREFIX(select_sse)(is3, z, w);
+
+	__m128 dropped = QM_FUNC_PREFIX(select_sse)(is3, w, QM_FUNC_PREFIX(select_sse)(is2, z, QM_FUNC_PREFIX(select_sse)(is1, y, x)));
+	__m128 sign = _mm_and_ps(dropped, _mm_set1_ps(-0.0f));
+
+	float half = (float)((1 << (bits - 1)) - 1);
+	__m128 scale = _mm_set1_ps(1.41421356f * half);
+	__m128 offset = _mm_set1_ps(half + 0.5f);
+	__m128 maxValue = _mm_set1_ps(2.0f * half);
+
+	*a = QM_FUNC_PREFIX(quantize_sse)(_mm_xor_ps(keptA, sign), scale, offset, maxValue);
+	*b = QM_FUNC_PREFIX(quantize_sse)(_mm_xor_ps(keptB, sign), scale, offset, maxValue);
+	*c = QM_FUNC_PREFIX(quantize_sse)(_mm_xor_ps(keptC, sign), scale, offset, maxValue);
+}
 
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat3_rotate)(float angle)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack_smallest3_sse)(__m128i index, __m128i a, __m128i b, __m128i c, int bits,
+                                                                     __m128* x, __m128* y, __m128* z, __m128* w)
 {
-	QMmat3 result = QM_FUNC_PREFIX(mat3_identity)();
+	float half = (float)((1 << (bits - 1)) - 1);
+	__m128 halfPacked = _mm_set1_ps(half);
+	__m128 scale = _mm_set1_ps(0.70710678f / half);
 
-	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle);
-	float sine   = QM_SINF(radians);
-	float cosine = QM_COSF(radians);
+	__m128 keptA = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(a), halfPacked), scale);
+	__m128 keptB = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(b), halfPacked), scale);
+	__m128 keptC = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(c), halfPacked), scale);
 
-	result.m[0][0] = cosine;
-	result.m[1][0] =   sine;
-	result.m[0][1] =  -sine;
-	result.m[1][1] = cosine;
+	__m128 lengthSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(keptC, keptC), _mm_mul_ps(keptB, keptB)), _mm_mul_ps(keptA, keptA));
+	__m128 dropped = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), lengthSqr), _mm_setzero_ps()));
 
-	return result;
+	__m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_setzero_si128()));
+	__m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(1)));
+	__m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(2)));
+	__m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(3)));
+
+	*x = QM_FUNC_PREFIX(select_sse)(is0, dropped, keptA);
+	*y = QM_FUNC_PREFIX(select_sse)(is0, keptA, QM_FUNC_PREFIX(select_sse)(is1, dropped, keptB));
+	*z = QM_FUNC_PREFIX(select_sse)(_mm_or_ps(is0, is1), keptB, QM_FUNC_PREFIX(select_sse)(is2, dropped, keptC));
+	*w = QM_FUNC_PREFIX(select_sse)(is3, dropped, keptC);
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_rotate)(QMvec3 axis, float angle)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack32_array_sse)(const QMquaternion* in, uint32_t* out, size_t count)
 {
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
-
-	axis = QM_FUNC_PREFIX(vec3_normalize)(axis);
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x, y, z, w;
+		QM_FUNC_PREFIX(quaternion_load4_sse)(&in[i], &x, &y, &z, &w);
 
-	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle);
-	float sine    = QM_SINF(radians);
-	float cosine  = QM_COSF(radians);
-	float cosine2 = 1.0f - cosine;
+		__m128i index, a, b, c;
+		QM_FUNC_PREFIX(quaternion_pack_smallest3_sse)(x, y, z, w, 10, &index, &a, &b, &c);
 
-	result.m[0][0] = axis.x * axis.x * cosine2 + cosine;
-	result.m[0][1] = axis.x * axis.y * cosine2 + axis.z * sine;
-	result.m[0][2] = axis.x * axis.z * cosine2 - axis.y * sine;
-	result.m[1][0] = axis.y * axis.x * cosine2 - axis.z * sine;
-	result.m[1][1] = axis.y * axis.y * cosine2 + cosine;
-	result.m[1][2] = axis.y * axis.z * cosine2 + axis.x * sine;
-	result.m[2][0] = axis.z * axis.x * cosine2 + axis.y * sine;
-	result.m[2][1] = axis.z * axis.y * cosine2 - axis.x * sine;
-	result.m[2][2] = axis.z * axis.z * cosine2 + cosine;
+		__m128i packed = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(index, 30), _mm_slli_epi32(a, 20)), _mm_or_si128(_mm_slli_epi32(b, 10), c));
+		_mm_storeu_si128((__m128i*)&out[i], packed);
+	}
 
-	return result;
+	QM_FUNC_PREFIX(quaternion_pack32_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_rotate_euler)(QMvec3 angles)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack32_array_sse)(const uint32_t* in, QMquaternion* out, size_t count)
 {
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+	__m128i mask = _mm_set1_epi32(0x3FF);
 
-	QMvec3 radians;
-	radians.x = QM_FUNC_PREFIX(deg_to_rad)(angles.x);
-	radians.y = QM_FUNC_PREFIX(deg_to_rad)(angles.y);
-	radians.z = QM_FUNC_PREFIX(deg_to_rad)(angles.z);
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i*)&in[i]);
 
-	float sinX = QM_SINF(radians.x);
-	float cosX = QM_COSF(radians.x);
-	float sinY = QM_SINF(radians.y);
-	float cosY = QM_COSF(radians.y);
-	float sinZ = QM_SINF(radians.z);
-	float cosZ = QM_COSF(radians.z);
+		__m128 x, y, z, w;
+		QM_FUNC_PREFIX(quaternion_unpack_smallest3_sse)(_mm_srli_epi32(packed, 30), _mm_and_si128(_mm_srli_epi32(packed, 20), mask),
+		                                                _mm_and_si128(_mm_srli_epi32(packed, 10), mask), _mm_and_si128(packed, mask), 10, &x, &y, &z, &w);
 
-	result.m[0][0] = cosY * cosZ;
-	result.m[0][1] = cosY * sinZ;
-	result.m[0][2] = -sinY;
-	result.m[1][0] = sinX * sinY * cosZ - cosX * sinZ;
-	result.m[1][1] = sinX * sinY * sinZ + cosX * cosZ;
-	result.m[1][2] = sinX * cosY;
-	result.m[2][0] = cosX * sinY * cosZ + sinX * sinZ;
-	result.m[2][1] = cosX * sinY * sinZ - sinX * cosZ;
-	result.m[2][2] = cosX * cosY;
+		QM_FUNC_PREFIX(quaternion_store4_sse)(x, y, z, w, &out[i]);
+	}
 
-	return result;
+	QM_FUNC_PREFIX(quaternion_unpack32_array_scalar)(in + i, out + i, count - i);
 }
 
-//to mat3:
-
-QM_FUNC_ATTRIBS QMmat3 QM_FUNC_PREFIX(mat4_top_left)(QMmat4 m)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack48_array_sse)(const QMquaternion* in, QMquaternion48* out, size_t count)
 {
-	QMmat3 result;
+	__m128i mask = _mm_set1_epi32(0xFFFF);
 
-	result.m[0][0] = m.m[0][0];
-	result.m[0][1] = m.m[0][1];
-	result.m[0][2] = m.m[0][2];
-	result.m[1][0] = m.m[1][0];
-	result.m[1][1] = m.m[1][1];
-	result.m[1][2] = m.m[1][2];
-	result.m[2][0] = m.m[2][0];
-	result.m[2][1] = m.m[2][1];
-	result.m[2][2] = m.m[2][2];
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x, y, z, w;
+		QM_FUNC_PREFIX(quaternion_load4_sse)(&in[i], &x, &y, &z, &w);
+
+		__m128i index, a, b, c;
+		QM_FUNC_PREFIX(quaternion_pack_smallest3_sse)(x, y, z, w, 15, &index, &a, &b, &c);
+
+		//the low 30 and high 17 bits, split into 16-bit words
+		__m128i low = _mm_or_si128(_mm_slli_epi32(b, 15), c);
+		__m128i high = _mm_or_si128(_mm_slli_epi32(index, 15), a);
+
+		uint32_t words[3][4];
+		_mm_storeu_si128((__m128i*)words[0], _mm_and_si128(low, mask));
+		_mm_storeu_si128((__m128i*)words[1], _mm_and_si128(_mm_or_si128(_mm_srli_epi32(low, 16), _mm_slli_epi32(high, 14)), mask));
+		_mm_storeu_si128((__m128i*)words[2], _mm_srli_epi32(high, 2));
+
+		for(int j = 0; j < 4; j++)
+		{
+			out[i + j].v[0] = (uint16_t)words[0][j];
+			out[i + j].v[1] = (uint16_t)words[1][j];
+			out[i + j].v[2] = (uint16_t)words[2][j];
+		}
+	}
 
-	return result;
+	QM_FUNC_PREFIX(quaternion_pack48_array_scalar)(in + i, out + i, count - i);
 }
 
-//projection:
-
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_perspective)(float fov, float aspect, float near, float far)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack48_array_sse)(const QMquaternion48* in, QMquaternion* out, size_t count)
 {
-	QMmat4 result = {0};
+	__m128i mask = _mm_set1_epi32(0x7FFF);
 
-	float scale = QM_TANF(QM_FUNC_PREFIX(deg_to_rad)(fov * 0.5f)) * near;
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128i word0 = _mm_setr_epi32(in[i].v[0], in[i + 1].v[0], in[i + 2].v[0], in[i + 3].v[0]);
+		__m128i word1 = _mm_setr_epi32(in[i].v[1], in[i + 1].v[1], in[i + 2].v[1], in[i + 3].v[1]);
+		__m128i word2 = _mm_setr_epi32(in[i].v[2], in[i + 1].v[2], in[i + 2].v[2], in[i + 3].v[2]);
 
-	float right = aspect * scale;
-	float top   = scale;
+		__m128i low = _mm_or_si128(word0, _mm_slli_epi32(_mm_and_si128(word1, _mm_set1_epi32(0x3FFF)), 16));
+		__m128i high = _mm_or_si128(_mm_srli_epi32(word1, 14), _mm_slli_epi32(word2, 2));
 
-	result.m[0][0] = near / right;
-	result.m[1][1] = near / top;
-	result.m[2][2] = -(far + near) / (far - near);
-	result.m[3][2] = -2.0f * far * near / (far - near);
-	result.m[2][3] = -1.0f;
+		__m128 x, y, z, w;
+		QM_FUNC_PREFIX(quaternion_unpack_smallest3_sse)(_mm_and_si128(_mm_srli_epi32(high, 15), _mm_set1_epi32(3)), _mm_and_si128(high, mask),
+		                                                _mm_srli_epi32(low, 15), _mm_and_si128(low, mask), 15, &x, &y, &z, &w);
 
-	return result;
+		QM_FUNC_PREFIX(quaternion_store4_sse)(x, y, z, w, &out[i]);
+	}
+
+	QM_FUNC_PREFIX(quaternion_unpack48_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_orthographic)(float left, float right, float bot, float top, float near, float far)
-{
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+//4 QMvec3s are 3 registers of components in memory order, the box's min and extent are loaded in the same pattern
 
-	result.m[0][0] = 2.0f / (right - left);
-	result.m[1][1] = 2.0f / (top - bot);
-	result.m[2][2] = 2.0f / (near - far);
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pattern3_sse)(QMvec3 v, __m128* v0, __m128* v1, __m128* v2)
+{
+	*v0 = _mm_setr_ps(v.x, v.y, v.z, v.x);
+	*v1 = _mm_setr_ps(v.y, v.z, v.x, v.y);
+	*v2 = _mm_setr_ps(v.z, v.x, v.y, v.z);
+}
 
-	result.m[3][0] = (left + right) / (left - right);
-	result.m[3][1] = (bot  + top  ) / (bot  - top  );
-	result.m[3][2] = (near + far  ) / (near - far  );
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack16_array_sse)(QMbbox3 b, const QMvec3* in, QMvec3u16* out, size_t count)
+{
+	__m128 min0, min1, min2, extent0, extent1, extent2;
+	QM_FUNC_PREFIX(vec3_pattern3_sse)(b.min, &min0, &min1, &min2);
+	QM_FUNC_PREFIX(vec3_pattern3_sse)(QM_FUNC_PREFIX(bbox3_extent)(b), &extent0, &extent1, &extent2);
 
-	return result;
-}
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_set1_ps(65535.0f);
+	__m128 offset = _mm_set1_ps(0.5f);
+	__m128i bias = _mm_set1_epi32(0x8000);
+	__m128i bias16 = _mm_set1_epi16((short)0x8000);
 
-//view matrix:
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		const float* f = (const float*)&in[i];
+		uint16_t* o = (uint16_t*)&out[i];
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_look)(QMvec3 pos, QMvec3 dir, QMvec3 up)
-{
-	QMmat4 result;
+		//same as qm_bbox3_offset, the max clamps NaN (from an empty axis) to 0 like QM_MAX
+		__m128 offset0 = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(_mm_loadu_ps(f    ), min0), extent0), _mm_setzero_ps()), one);
+		__m128 offset1 = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(_mm_loadu_ps(f + 4), min1), extent1), _mm_setzero_ps()), one);
+		__m128 offset2 = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(_mm_loadu_ps(f + 8), min2), extent2), _mm_setzero_ps()), one);
 
-	QMvec3 r = QM_FUNC_PREFIX(vec3_normalize)(QM_FUNC_PREFIX(vec3_cross)(up, dir));
-	QMvec3 u = QM_FUNC_PREFIX(vec3_cross)(dir, r);
+		__m128i n0 = QM_FUNC_PREFIX(quantize_sse)(offset0, scale, offset, scale);
+		__m128i n1 = QM_FUNC_PREFIX(quantize_sse)(offset1, scale, offset, scale);
+		__m128i n2 = QM_FUNC_PREFIX(quantize_sse)(offset2, scale, offset, scale);
 
-	QMmat4 RUD = QM_FUNC_PREFIX(mat4_identity)();
-	RUD.m[0][0] = r.x;
-	RUD.m[1][0] = r.y;
-	RUD.m[2][0] = r.z;
-	RUD.m[0][1] = u.x;
-	RUD.m[1][1] = u.y;
-	RUD.m[2][1] = u.z;
-	RUD.m[0][2] = -dir.x;
-	RUD.m[1][2] = -dir.y;
-	RUD.m[2][2] = -dir.z;
+		//SSE2 can only pack with signed saturation, so the values are biased into its range and back
+		__m128i packed01 = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(n0, bias), _mm_sub_epi32(n1, bias)), bias16);
+		__m128i packed2 = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(n2, bias), _mm_sub_epi32(n2, bias)), bias16);
 
-	QMvec3 oppPos = {-pos.x, -pos.y, -pos.z};	
-	result = QM_FUNC_PREFIX(mat4_mult)(RUD, QM_FUNC_PREFIX(mat4_translate)(oppPos));
+		_mm_storeu_si128((__m128i*)o, packed01);
+		_mm_storel_epi64((__m128i*)(o + 8), packed2);
+	}
 
-	return result;
+	QM_FUNC_PREFIX(vec3_pack16_array_scalar)(b, in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(mat4_lookat)(QMvec3 pos, QMvec3 target, QMvec3 up)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack16_array_sse)(QMbbox3 b, const QMvec3u16* in, QMvec3* out, size_t count)
 {
-	QMmat4 result;
+	__m128 min0, min1, min2, scale0, scale1, scale2;
+	QM_FUNC_PREFIX(vec3_pattern3_sse)(b.min, &min0, &min1, &min2);
+	QM_FUNC_PREFIX(vec3_pattern3_sse)(QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(bbox3_extent)(b), 1.0f / 65535.0f), &scale0, &scale1, &scale2);
 
-	QMvec3 dir = QM_FUNC_PREFIX(vec3_normalize)(QM_FUNC_PREFIX(vec3_sub)(pos, target));
-	result = QM_FUNC_PREFIX(mat4_look)(pos, dir, up);
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		const uint16_t* p = (const uint16_t*)&in[i];
+		float* f = (float*)&out[i];
 
-	return result;
-}
+		__m128i packed01 = _mm_loadu_si128((const __m128i*)p);
+		__m128i packed2 = _mm_loadl_epi64((const __m128i*)(p + 8));
 
-//----------------------------------------------------------------------//
-//QUATERNION FUNCTIONS:
+		__m128 n0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed01, _mm_setzero_si128()));
+		__m128 n1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed01, _mm_setzero_si128()));
+		__m128 n2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed2, _mm_setzero_si128()));
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_load)(const float* in)
-{
-	return (QMquaternion){ in[0], in[1], in[2], in[3] };
+		_mm_storeu_ps(f    , _mm_add_ps(min0, _mm_mul_ps(n0, scale0)));
+		_mm_storeu_ps(f + 4, _mm_add_ps(min1, _mm_mul_ps(n1, scale1)));
+		_mm_storeu_ps(f + 8, _mm_add_ps(min2, _mm_mul_ps(n2, scale2)));
+	}
+
+	QM_FUNC_PREFIX(vec3_unpack16_array_scalar)(b, in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_store)(QMquaternion q, float* out)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack_oct_array_sse)(const QMvec3* in, uint32_t* out, size_t count)
 {
-	out[0] = q.x;
-	out[1] = q.y;
-	out[2] = q.z;
-	out[3] = q.w;
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_set1_ps(32767.0f);
+	__m128 offset = _mm_set1_ps(32767.5f);
+
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128 x, y, z;
+		QM_FUNC_PREFIX(vec3_load4_sse)(&in[i], &x, &y, &z);
+
+		__m128 absX = _mm_and_ps(x, absMask), absY = _mm_and_ps(y, absMask), absZ = _mm_and_ps(z, absMask);
+		__m128 invLength = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(absX, absY), absZ));
+		x = _mm_mul_ps(x, invLength);
+		y = _mm_mul_ps(y, invLength);
+
+		__m128 signX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_set1_ps(-0.0f)), one);
+		__m128 signY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), _mm_set1_ps(-0.0f)), one);
+		__m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(y, absMask)), signX);
+		__m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(x, absMask)), signY);
+
+		__m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+		x = QM_FUNC_PREFIX(select_sse)(lower, foldedX, x);
+		y = QM_FUNC_PREFIX(select_sse)(lower, foldedY, y);
+
+		//[-1, 1] is clamped before quantizing, so the 0 clamp in quantize_sse never applies
+		__m128i packedX = QM_FUNC_PREFIX(quantize_sse)(_mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), one), scale, offset, _mm_set1_ps(65535.0f));
+		__m128i packedY = QM_FUNC_PREFIX(quantize_sse)(_mm_min_ps(_mm_max_ps(y, _mm_set1_ps(-1.0f)), one), scale, offset, _mm_set1_ps(65535.0f));
+
+		_mm_storeu_si128((__m128i*)&out[i], _mm_or_si128(packedX, _mm_slli_epi32(packedY, 16)));
+	}
+
+	QM_FUNC_PREFIX(vec3_pack_oct_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_identity)()
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack_oct_array_sse)(const uint32_t* in, QMvec3* out, size_t count)
 {
-	QMquaternion result;
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 offset = _mm_set1_ps(32767.0f);
+	__m128 scale = _mm_set1_ps(1.0f / 32767.0f);
 
-	result.x = 0.0f;
-	result.y = 0.0f;
-	result.z = 0.0f;
-	result.w = 1.0f;
+	size_t i = 0;
+	for(; i < (count & ~(size_t)3); i += 4)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i*)&in[i]);
 
-	return result;
+		__m128 x = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, _mm_set1_epi32(0xFFFF))), offset), scale);
+		__m128 y = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srli_epi32(packed, 16)), offset), scale);
+		__m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_and_ps(x, absMask)), _mm_and_ps(y, absMask));
+
+		__m128 fold = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+		x = _mm_sub_ps(x, _mm_xor_ps(fold, _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_set1_ps(-0.0f))));
+		y = _mm_sub_ps(y, _mm_xor_ps(fold, _mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), _mm_set1_ps(-0.0f))));
+
+		__m128 lengthSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSqr));
+
+		QM_FUNC_PREFIX(vec3_store4_sse)(_mm_mul_ps(x, invLength), _mm_mul_ps(y, invLength), _mm_mul_ps(z, invLength), &out[i]);
+	}
+
+	QM_FUNC_PREFIX(vec3_unpack_oct_array_scalar)(in + i, out + i, count - i);
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_add)(QMquaternion q1, QMquaternion q2)
+#endif
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack32_array)(const QMquaternion* in, uint32_t* out, size_t count)
 {
-	QMquaternion result;
+	#if QM_USE_DISPATCH
 
-	#if QM_USE_SSE
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_pack32_array(in, out, count);
 
-	result.packed = _mm_add_ps(q1.packed, q2.packed);
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(quaternion_pack32_array_sse)(in, out, count);
 
 	#else
 
-	result.x = q1.x + q2.x;
-	result.y = q1.y + q2.y;
-	result.z = q1.z + q2.z;
-	result.w = q1.w + q2.w;
+	QM_FUNC_PREFIX(quaternion_pack32_array_scalar)(in, out, count);
 
 	#endif
-
-	return result;
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_sub)(QMquaternion q1, QMquaternion q2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack32_array)(const uint32_t* in, QMquaternion* out, size_t count)
 {
-	QMquaternion result;
+	#if QM_USE_DISPATCH
 
-	#if QM_USE_SSE
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_unpack32_array(in, out, count);
 
-	result.packed = _mm_sub_ps(q1.packed, q2.packed);
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(quaternion_unpack32_array_sse)(in, out, count);
 
 	#else
 
-	result.x = q1.x - q2.x;
-	result.y = q1.y - q2.y;
-	result.z = q1.z - q2.z;
-	result.w = q1.w - q2.w;
+	QM_FUNC_PREFIX(quaternion_unpack32_array_scalar)(in, out, count);
 
 	#endif
-
-	return result;
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_mult)(QMquaternion q1, QMquaternion q2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_pack48_array)(const QMquaternion* in, QMquaternion48* out, size_t count)
 {
-	QMquaternion result;
+	#if QM_USE_DISPATCH
 
-	#if QM_USE_SSE
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_pack48_array(in, out, count);
 
-	__m128 temp1;
-	__m128 temp2;
+	#elif QM_USE_SSE
 
-	temp1 = _mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(3, 3, 3, 3));
-	temp2 = q2.packed;
-	result.packed = _mm_mul_ps(temp1, temp2);
+	QM_FUNC_PREFIX(quaternion_pack48_array_sse)(in, out, count);
 
-	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(0, 0, 0, 0)), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f));
-	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(0, 1, 2, 3));
-	result.packed = _mm_add_ps(result.packed, _mm_mul_ps(temp1, temp2));
+	#else
 
-	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(1, 1, 1, 1)), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f));
-	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(1, 0, 3, 2));
-	result.packed = _mm_add_ps(result.packed, _mm_mul_ps(temp1, temp2));
+	QM_FUNC_PREFIX(quaternion_pack48_array_scalar)(in, out, count);
 
-	temp1 = _mm_xor_ps(_mm_shuffle_ps(q1.packed, q1.packed, _MM_SHUFFLE(2, 2, 2, 2)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
-	temp2 = _mm_shuffle_ps(q2.packed, q2.packed, _MM_SHUFFLE(2, 3, 0, 1));
-	result.packed = _mm_add_ps(result.packed, _mm_mul_ps(temp1, temp2));
+	#endif
+}
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(quaternion_unpack48_array)(const QMquaternion48* in, QMquaternion* out, size_t count)
+{
+	#if QM_USE_DISPATCH
+
+	QM_FUNC_PREFIX(dispatch_table)()->quaternion_unpack48_array(in, out, count);
+
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(quaternion_unpack48_array_sse)(in, out, count);
 
 	#else
 
-	result.x = q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y;
-    result.y = q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x;
-    result.z = q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w;
-    result.w = q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z;
+	QM_FUNC_PREFIX(quaternion_unpack48_array_scalar)(in, out, count);
 
 	#endif
-
-	return result;
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_scale)(QMquaternion q, float s)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack16_array)(QMbbox3 b, const QMvec3* in, QMvec3u16* out, size_t count)
 {
-	QMquaternion result;
+	#if QM_USE_DISPATCH
 
-	#if QM_USE_SSE
+	QM_FUNC_PREFIX(dispatch_table)()->vec3_pack16_array(b, in, out, count);
 
-	__m128 scale = _mm_set1_ps(s);
-	result.packed = _mm_mul_ps(q.packed, scale);
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec3_pack16_array_sse)(b, in, out, count);
 
 	#else
 
-	result.x = q.x * s;
-	result.y = q.y * s;
-	result.z = q.z * s;
-	result.w = q.w * s;
+	QM_FUNC_PREFIX(vec3_pack16_array_scalar)(b, in, out, count);
 
 	#endif
-
-	return result;
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(quaternion_dot)(QMquaternion q1, QMquaternion q2)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack16_array)(QMbbox3 b, const QMvec3u16* in, QMvec3* out, size_t count)
 {
-	float result;
+	#if QM_USE_DISPATCH
 
-	#if QM_USE_SSE
+	QM_FUNC_PREFIX(dispatch_table)()->vec3_unpack16_array(b, in, out, count);
 
-	__m128 r = _mm_mul_ps(q1.packed, q2.packed);
-	r = _mm_hadd_ps(r, r);
-	r = _mm_hadd_ps(r, r);
-	_mm_store_ss(&result, r);
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec3_unpack16_array_sse)(b, in, out, count);
 
 	#else
 
-	result = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	QM_FUNC_PREFIX(vec3_unpack16_array_scalar)(b, in, out, count);
 
 	#endif
-
-	return result;
 }
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(quaternion_length)(QMquaternion q)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_pack_oct_array)(const QMvec3* in, uint32_t* out, size_t count)
 {
-	float result;
+	#if QM_USE_DISPATCH
 
-	result = QM_SQRTF(QM_FUNC_PREFIX(quaternion_dot)(q, q));
+	QM_FUNC_PREFIX(dispatch_table)()->vec3_pack_oct_array(in, out, count);
 
-	return result;
+	#elif QM_USE_SSE
+
+	QM_FUNC_PREFIX(vec3_pack_oct_array_sse)(in, out, count);
+
+	#else
+
+	QM_FUNC_PREFIX(vec3_pack_oct_array_scalar)(in, out, count);
+
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_normalize)(QMquaternion q)
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(vec3_unpack_oct_array)(const uint32_t* in, QMvec3* out, size_t count)
 {
-	QMquaternion result = {0};
-
-	float len = QM_FUNC_PREFIX(quaternion_length)(q);
-	if(len != 0.0f)
-	{
-		#if QM_USE_SSE
+	#if QM_USE_DISPATCH
 
-		__m128 scale = _mm_set1_ps(len);
-		result.packed = _mm_div_ps(q.packed, scale);
+	QM_FUNC_PREFIX(dispatch_table)()->vec3_unpack_oct_array(in, out, count);
 
-		#else
+	#elif QM_USE_SSE
 
-		float invLen = 1.0f / len;
+	QM_FUNC_PREFIX(vec3_unpack_oct_array_sse)(in, out, count);
 
-		result.x = q.x * invLen;
-		result.y = q.y * invLen;
-		result.z = q.z * invLen;
-		result.w = q.w * invLen;
+	#else
 
-		#endif
-	}
+	QM_FUNC_PREFIX(vec3_unpack_oct_array_scalar)(in, out, count);
 
-	return result;
+	#endif
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_conjugate)(QMquaternion q)
+//----------------------------------------------------------------------//
+//ANIMATION FUNCTIONS:
+
+//packs count keys into (count + 3) / 4 blocks, the last block is padded with copies of the last key
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(anim_track_pack)(const QManimKey* keys, uint32_t count, QManimKeyBlock* blocks)
 {
-	QMquaternion result;
+	for(uint32_t i = 0; i < (count + 3) / 4 * 4; i++)
+	{
+		const QManimKey* key = &keys[QM_MIN(i, count - 1)];
+		QManimKeyBlock* block = &blocks[i / 4];
+		uint32_t lane = i % 4;
 
-	result.x = -q.x;
-	result.y = -q.y;
-	result.z = -q.z;
-	result.w = q.w;
+		block->time[lane] = key->time;
+		block->unused[lane] = 0.0f;
 
-	return result;
+		for(int j = 0; j < 3; j++)
+		{
+			block->translation.v[j][lane] = key->translation.v[j];
+			block->scale.v[j][lane] = key->scale.v[j];
+		}
+
+		for(int j = 0; j < 4; j++)
+			block->rotation[j][lane] = key->rotation.q[j];
+	}
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_inv)(QMquaternion q)
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(anim_track_time)(const QManimTrack* track, uint32_t key)
+{
+	return track->blocks[key / 4].time[key % 4];
+}
+
+//moves the cursor to the last key at or before t and returns how far t is towards the key after it. sequential
+//playback only steps the cursor a key or two, larger jumps skip whole blocks by their first time
+
+QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(anim_track_seek)(const QManimTrack* track, uint32_t* cursor, float t, uint32_t* next)
 {
-	QMquaternion result;
+	uint32_t last = track->keyCount - 1;
+	uint32_t key = *cursor;
 
-	result.x = -q.x;
-	result.y = -q.y;
-	result.z = -q.z;
-	result.w = q.w;
+	//playing backwards or looping restarts the search from the first key
+	if(key > last || t < QM_FUNC_PREFIX(anim_track_time)(track, key))
+		key = 0;
 
-	#if QM_USE_SSE
+	while((key | 3) < last && track->blocks[key / 4 + 1].time[0] <= t)
+		key = (key | 3) + 1;
+	while(key < last && QM_FUNC_PREFIX(anim_track_time)(track, key + 1) <= t)
+		key++;
 
-	__m128 scale = _mm_set1_ps(QM_FUNC_PREFIX(quaternion_dot)(q, q));
-	_mm_div_ps(result.packed, scale);
+	*cursor = key;
+	*next = QM_MIN(key + 1, last);
 
-	#else
+	//before the first key and after the last one the track holds its end pose
+	float start = QM_FUNC_PREFIX(anim_track_time)(track, key);
+	float end = QM_FUNC_PREFIX(anim_track_time)(track, *next);
+	if(end <= start)
+		return 0.0f;
 
-	float invLen2 = 1.0f / QM_FUNC_PREFIX(quaternion_dot)(q, q);
+	return QM_MIN(QM_MAX((t - start) / (end - start), 0.0f), 1.0f);
+}
 
-	result.x *= invLen2;
-	result.y *= invLen2;
-	result.z *= invLen2;
-	result.w *= invLen2;
+QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(anim_lerp_lanes)(const QMvec3x4* from, uint32_t fromLane, const QMvec3x4* to, uint32_t toLane, float a)
+{
+	QMvec3 result;
 
-	#endif
+	for(int i = 0; i < 3; i++)
+		result.v[i] = from->v[i][fromLane] + (to->v[i][toLane] - from->v[i][fromLane]) * a;
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_slerp)(QMquaternion q1, QMquaternion q2, float a)
+QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(anim_rotation)(const QManimKeyBlock* block, uint32_t lane)
 {
 	QMquaternion result;
 
-	float cosine = QM_FUNC_PREFIX(quaternion_dot)(q1, q2);
-	float angle = QM_ACOSF(cosine);
-
-	float sine1 = QM_SINF((1.0f - a) * angle);
-	float sine2 = QM_SINF(a * angle);
-	float invSine = 1.0f / QM_SINF(angle);
-
-	q1 = QM_FUNC_PREFIX(quaternion_scale)(q1, sine1);
-	q2 = QM_FUNC_PREFIX(quaternion_scale)(q2, sine2);
-
-	result = QM_FUNC_PREFIX(quaternion_add)(q1, q2);
-	result = QM_FUNC_PREFIX(quaternion_scale)(result, invSine);
+	for(int i = 0; i < 4; i++)
+		result.q[i] = block->rotation[i][lane];
 
 	return result;
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_from_axis_angle)(QMvec3 axis, float angle)
+//samples one track at time t, the rotation is blended along the shortest arc by qm_quaternion_blend_array like
+//qm_anim_sample does, so both agree to within its error
+
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(anim_track_sample)(QManimTrack track, uint32_t* cursor, float t, QMvec3* translation, QMquaternion* rotation, QMvec3* scale)
 {
-	QMquaternion result;
+	uint32_t next;
+	float a = QM_FUNC_PREFIX(anim_track_seek)(&track, cursor, t, &next);
 
-	float radians = QM_FUNC_PREFIX(deg_to_rad)(angle * 0.5f);
-	axis = QM_FUNC_PREFIX(vec3_normalize)(axis);
-	float sine = QM_SINF(radians);
+	const QManimKeyBlock* from = &track.blocks[*cursor / 4];
+	const QManimKeyBlock* to = &track.blocks[next / 4];
+	uint32_t fromLane = *cursor % 4;
+	uint32_t toLane = next % 4;
 
-	result.x = axis.x * sine;
-	result.y = axis.y * sine;
-	result.z = axis.z * sine;
-	result.w = QM_COSF(radians);
+	*translation = QM_FUNC_PREFIX(anim_lerp_lanes)(&from->translation, fromLane, &to->translation, toLane, a);
+	*scale = QM_FUNC_PREFIX(anim_lerp_lanes)(&from->scale, fromLane, &to->scale, toLane, a);
 
-	return result;
+	QMquaternion rotationFrom = QM_FUNC_PREFIX(anim_rotation)(from, fromLane);
+	QMquaternion rotationTo = QM_FUNC_PREFIX(anim_rotation)(to, toLane);
+	QM_FUNC_PREFIX(quaternion_blend_array)(&rotationFrom, &rotationTo, &a, rotation, 1);
 }
 
-QM_FUNC_ATTRIBS QMquaternion QM_FUNC_PREFIX(quaternion_from_euler)(QMvec3 angles)
-{
-	QMquaternion result;
+//samples count tracks at time t, cursors holds one cursor per track (start them at 0). the keys around t are gathered
+//QM_ANIM_BATCH tracks at a time and their rotations blended together with qm_quaternion_blend_array
 
-	QMvec3 radians;
-	radians.x = QM_FUNC_PREFIX(deg_to_rad)(angles.x * 0.5f);
-	radians.y = QM_FUNC_PREFIX(deg_to_rad)(angles.y * 0.5f);
-	radians.z = QM_FUNC_PREFIX(deg_to_rad)(angles.z * 0.5f);
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(anim_sample)(const QManimTrack* tracks, uint32_t* cursors, size_t count, float t,
+                                                 QMvec3* translations, QMquaternion* rotations, QMvec3* scales)
+{
+	QMquaternion rotationFrom[QM_ANIM_BATCH];
+	QMquaternion rotationTo[QM_ANIM_BATCH];
+	float alpha[QM_ANIM_BATCH];
 
-	float sinx = QM_SINF(radians.x);
-	float cosx = QM_COSF(radians.x);
-	float siny = QM_SINF(radians.y);
-	float cosy = QM_COSF(radians.y);
-	float sinz = QM_SINF(radians.z);
-	float cosz = QM_COSF(radians.z);
+	for(size_t i = 0; i < count; i += QM_ANIM_BATCH)
+	{
+		size_t batchCount = QM_MIN(count - i, (size_t)QM_ANIM_BATCH);
 
-	#if QM_USE_SSE
+		for(size_t j = 0; j < batchCount; j++)
+		{
+			#if QM_USE_SSE
 
-	__m128 packedx = _mm_setr_ps(sinx, cosx, cosx, cosx);
-	__m128 packedy = _mm_setr_ps(cosy, siny, cosy, cosy);
-	__m128 packedz = _mm_setr_ps(cosz, cosz, sinz, cosz);
+			//the tracks' blocks are far apart, prefetch the 3 cache lines of the block an upcoming cursor is in
+			if(i + j + QM_PREFETCH_DISTANCE < count)
+			{
+				const char* upcoming = (const char*)&tracks[i + j + QM_PREFETCH_DISTANCE].blocks[cursors[i + j + QM_PREFETCH_DISTANCE] / 4];
+				_mm_prefetch(upcoming, _MM_HINT_T0);
+				_mm_prefetch(upcoming + 64, _MM_HINT_T0);
+				_mm_prefetch(upcoming + 128, _MM_HINT_T0);
+			}
 
-	result.packed = _mm_mul_ps(_mm_mul_ps(packedx, packedy), packedz);
+			#endif
 
-	packedx = _mm_shuffle_ps(packedx, packedx, _MM_SHUFFLE(0, 0, 0, 1));
-	packedy = _mm_shuffle_ps(packedy, packedy, _MM_SHUFFLE(1, 1, 0, 1));
-	packedz = _mm_shuffle_ps(packedz, packedz, _MM_SHUFFLE(2, 0, 2, 2));
+			const QManimTrack* track = &tracks[i + j];
 
-	result.packed = _mm_addsub_ps(result.packed, _mm_mul_ps(_mm_mul_ps(packedx, packedy), packedz));
+			uint32_t next;
+			float a = QM_FUNC_PREFIX(anim_track_seek)(track, &cursors[i + j], t, &next);
 
-	#else
+			const QManimKeyBlock* from = &track->blocks[cursors[i + j] / 4];
+			const QManimKeyBlock* to = &track->blocks[next / 4];
+			uint32_t fromLane = cursors[i + j] % 4;
+			uint32_t toLane = next % 4;
 
-	result.x = sinx * cosy * cosz - cosx * siny * sinz;
-	result.y = cosx * siny * cosz + sinx * cosy * sinz;
-	result.z = cosx * cosy * sinz - sinx * siny * cosz;
-	result.w = cosx * cosy * cosz + sinx * siny * sinz;
+			translations[i + j] = QM_FUNC_PREFIX(anim_lerp_lanes)(&from->translation, fromLane, &to->translation, toLane, a);
+			scales[i + j] = QM_FUNC_PREFIX(anim_lerp_lanes)(&from->scale, fromLane, &to->scale, toLane, a);
 
-	#endif
+			rotationFrom[j] = QM_FUNC_PREFIX(anim_rotation)(from, fromLane);
+			rotationTo[j] = QM_FUNC_PREFIX(anim_rotation)(to, toLane);
+			alpha[j] = a;
+		}
 
-	return result;
+		QM_FUNC_PREFIX(quaternion_blend_array)(rotationFrom, rotationTo, alpha, &rotations[i], batchCount);
+	}
 }
 
-QM_FUNC_ATTRIBS QMmat4 QM_FUNC_PREFIX(quaternion_to_mat4)(QMquaternion q)
-{
-	QMmat4 result = QM_FUNC_PREFIX(mat4_identity)();
+//samples count tracks at time t into transformation matrices, same as qm_anim_sample followed by
+//qm_mat4_from_trs_array but the sampled transforms only pass through small stack buffers that stay in cache
 
-	float x2  = q.x + q.x;
-    float y2  = q.y + q.y;
-    float z2  = q.z + q.z;
-    float xx2 = q.x * x2;
-    float xy2 = q.x * y2;
-    float xz2 = q.x * z2;
-    float yy2 = q.y * y2;
-    float yz2 = q.y * z2;
-    float zz2 = q.z * z2;
-    float sx2 = q.w * x2;
-    float sy2 = q.w * y2;
-    float sz2 = q.w * z2;
+QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(anim_sample_mat4)(const QManimTrack* tracks, uint32_t* cursors, size_t count, float t, QMmat4* out)
+{
+	QMvec3 translations[QM_ANIM_BATCH];
+	QMquaternion rotations[QM_ANIM_BATCH];
+	QMvec3 scales[QM_ANIM_BATCH];
 
-	result.m[0][0] = 1.0f - (yy2 + zz2);
-	result.m[0][1] = xy2 - sz2;
-	result.m[0][2] = xz2 + sy2;
-	result.m[1][0] = xy2 + sz2;
-	result.m[1][1] = 1.0f - (xx2 + zz2);
-	result.m[1][2] = yz2 - sx2;
-	result.m[2][0] = xz2 - sy2;
-	result.m[2][1] = yz2 + sx2;
-	result.m[2][2] = 1.0f - (xx2 + yy2);
+	for(size_t i = 0; i < count; i += QM_ANIM_BATCH)
+	{
+		size_t batchCount = QM_MIN(count - i, (size_t)QM_ANIM_BATCH);
 
-	return result;
+		QM_FUNC_PREFIX(anim_sample)(&tracks[i], &cursors[i], batchCount, t, translations, rotations, scales);
+		QM_FUNC_PREFIX(mat4_from_trs_array)(translations, rotations, scales, &out[i], batchCount);
+	}
 }
 
 //----------------------------------------------------------------------//
-//BOUNING BOX FUNCTIONS:
+//RUNTIME DISPATCH:
 
-//loading:
+#if QM_USE_DISPATCH
 
-QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_load)(const float* in)
-{
-	return (QMbbox2){ { in[0], in[1] }, { in[2], in[3] } };
-}
+//returns the best tier supported by both the cpu and the os
 
-QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_load)(const float* in)
+QM_FUNC_ATTRIBS QMsimdTier QM_FUNC_PREFIX(cpu_simd_tier)(void)
 {
-	return (QMbbox3){ { in[0], in[1], in[2] }, { in[3], in[4], in[5] } };
-}
-
-//storing:
+	unsigned int ecx1 = 0, ebx7 = 0;
+	unsigned long long xcr0 = 0;
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_store)(QMbbox2 b, float* out)
-{
-	out[0] = b.min.x;
-	out[1] = b.min.y;
-	out[2] = b.max.x;
-	out[3] = b.max.y;
-}
+	#if defined(_MSC_VER) && !defined(__clang__)
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_store)(QMbbox3 b, float* out)
-{
-	out[0] = b.min.x;
-	out[1] = b.min.y;
-	out[2] = b.min.z;
-	out[3] = b.max.x;
-	out[4] = b.max.y;
-	out[5] = b.max.z;
-}
+	int regs[4];
+	__cpuid(regs, 0);
+	int maxLeaf = regs[0];
 
-//initialized:
+	if(maxLeaf >= 1)
+	{
+		__cpuid(regs, 1);
+		ecx1 = (unsigned int)regs[2];
+	}
+	if(maxLeaf >= 7)
+	{
+		__cpuidex(regs, 7, 0);
+		ebx7 = (unsigned int)regs[1];
+	}
 
-QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_initialized)()
-{
-	return (QMbbox2){ { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
-}
+	if(ecx1 & (1u << 27)) //OSXSAVE
+		xcr0 = _xgetbv(0);
 
-QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_initialized)()
-{
-	return (QMbbox3){ { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
-}
+	#else
 
-//union:
+	unsigned int eax, ebx, ecx, edx;
+	unsigned int maxLeaf = __get_cpuid_max(0, NULL);
 
-QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_union)(QMbbox2 b1, QMbbox2 b2)
-{
-	QMbbox2 result;
+	if(maxLeaf >= 1)
+	{
+		__cpuid(1, eax, ebx, ecx, edx);
+		ecx1 = ecx;
+	}
+	if(maxLeaf >= 7)
+	{
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		ebx7 = ebx;
+	}
 
-	result.min = QM_FUNC_PREFIX(vec2_min)(b1.min, b2.min);
-	result.max = QM_FUNC_PREFIX(vec2_max)(b1.max, b2.max);
+	if(ecx1 & (1u << 27)) //OSXSAVE
+	{
+		unsigned int lo, hi;
+		__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		xcr0 = ((unsigned long long)hi << 32) | lo;
+	}
 
-	return result;
-}
+	#endif
 
-QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union)(QMbbox3 b1, QMbbox3 b2)
-{
-	QMbbox3 result;
+	//the os must also save the ymm/zmm registers on context switches (checked through xcr0). the AVX2 tier also
+	//needs FMA and F16C, which every cpu with AVX2 has
+	QMbool avx2   = (ecx1 & (1u << 28)) && (ecx1 & (1u << 12)) && (ecx1 & (1u << 29)) && (ebx7 & (1u << 5)) && (xcr0 & 0x06) == 0x06;
+	QMbool avx512 = avx2 && (ebx7 & (1u << 16)) && (xcr0 & 0xE6) == 0xE6;
 
-	result.min = QM_FUNC_PREFIX(vec3_min)(b1.min, b2.min);
-	result.max = QM_FUNC_PREFIX(vec3_max)(b1.max, b2.max);
+	if(avx512)
+		return QM_SIMD_AVX512;
+	if(avx2)
+		return QM_SIMD_AVX2;
 
-	return result;
+	return QM_SIMD_SSE; //SSE2 is always available on x86-64
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_union_inplace)(QMbbox2* b1, QMbbox2 b2)
-{
-	b1->min = QM_FUNC_PREFIX(vec2_min)(b1->min, b2.min);
-	b1->max = QM_FUNC_PREFIX(vec2_max)(b1->max, b2.max);
+//the kernels for each tier, in QMdispatchTable's field order. they are constant, so publishing a pointer to one
+//is the only write dispatch_init makes
+
+QM_FUNC_ATTRIBS const QMdispatchTable* QM_FUNC_PREFIX(dispatch_tables)(void)
+{
+	static const QMdispatchTable tables[] = {
+		{
+			QM_SIMD_SCALAR,
+			QM_FUNC_PREFIX(mat4_mult_array_scalar),
+			QM_FUNC_PREFIX(mat4_mult_array_pairwise_scalar),
+			QM_FUNC_PREFIX(frustum_cull_bbox3_scalar),
+			QM_FUNC_PREFIX(mat4_from_trs_array_scalar),
+			QM_FUNC_PREFIX(mat4_mult_vec4_array_scalar),
+			QM_FUNC_PREFIX(mat4_transform_vec3_array_scalar),
+			QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_scalar),
+			QM_FUNC_PREFIX(vec4_dot_array_scalar),
+			QM_FUNC_PREFIX(quaternion_normalize_array_scalar),
+			QM_FUNC_PREFIX(quaternion_blend_array_scalar),
+			QM_FUNC_PREFIX(bbox3_union_vec3_array_scalar),
+			QM_FUNC_PREFIX(bbox3_union_array_scalar),
+			QM_FUNC_PREFIX(bbox3_transform_array_scalar),
+			QM_FUNC_PREFIX(quaternion_pack32_array_scalar),
+			QM_FUNC_PREFIX(quaternion_unpack32_array_scalar),
+			QM_FUNC_PREFIX(quaternion_pack48_array_scalar),
+			QM_FUNC_PREFIX(quaternion_unpack48_array_scalar),
+			QM_FUNC_PREFIX(vec3_pack16_array_scalar),
+			QM_FUNC_PREFIX(vec3_unpack16_array_scalar),
+			QM_FUNC_PREFIX(vec3_pack_oct_array_scalar),
+			QM_FUNC_PREFIX(vec3_unpack_oct_array_scalar),
+			QM_FUNC_PREFIX(float_to_half_array_scalar),
+			QM_FUNC_PREFIX(half_to_float_array_scalar)
+		},
+		{
+			QM_SIMD_SSE,
+			QM_FUNC_PREFIX(mat4_mult_array_sse),
+			QM_FUNC_PREFIX(mat4_mult_array_pairwise_sse),
+			QM_FUNC_PREFIX(frustum_cull_bbox3_sse),
+			QM_FUNC_PREFIX(mat4_from_trs_array_sse),
+			QM_FUNC_PREFIX(mat4_mult_vec4_array_sse),
+			QM_FUNC_PREFIX(mat4_transform_vec3_array_sse),
+			QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_sse),
+			QM_FUNC_PREFIX(vec4_dot_array_sse),
+			QM_FUNC_PREFIX(quaternion_normalize_array_sse),
+			QM_FUNC_PREFIX(quaternion_blend_array_sse),
+			QM_FUNC_PREFIX(bbox3_union_vec3_array_sse),
+			QM_FUNC_PREFIX(bbox3_union_array_sse),
+			QM_FUNC_PREFIX(bbox3_transform_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack48_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack48_array_sse),
+			QM_FUNC_PREFIX(vec3_pack16_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack16_array_sse),
+			QM_FUNC_PREFIX(vec3_pack_oct_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack_oct_array_sse),
+			QM_FUNC_PREFIX(float_to_half_array_sse),
+			QM_FUNC_PREFIX(half_to_float_array_sse)
+		},
+		{
+			QM_SIMD_AVX2,
+			QM_FUNC_PREFIX(mat4_mult_array_avx2),
+			QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx2),
+			QM_FUNC_PREFIX(frustum_cull_bbox3_avx2),
+			QM_FUNC_PREFIX(mat4_from_trs_array_sse),
+			QM_FUNC_PREFIX(mat4_mult_vec4_array_avx2),
+			QM_FUNC_PREFIX(mat4_transform_vec3_array_avx2),
+			QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx2),
+			QM_FUNC_PREFIX(vec4_dot_array_sse),
+			QM_FUNC_PREFIX(quaternion_normalize_array_sse),
+			QM_FUNC_PREFIX(quaternion_blend_array_avx2),
+			QM_FUNC_PREFIX(bbox3_union_vec3_array_avx2),
+			QM_FUNC_PREFIX(bbox3_union_array_avx2),
+			QM_FUNC_PREFIX(bbox3_transform_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack48_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack48_array_sse),
+			QM_FUNC_PREFIX(vec3_pack16_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack16_array_sse),
+			QM_FUNC_PREFIX(vec3_pack_oct_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack_oct_array_sse),
+			QM_FUNC_PREFIX(float_to_half_array_f16c),
+			QM_FUNC_PREFIX(half_to_float_array_f16c)
+		},
+		{
+			QM_SIMD_AVX512,
+			QM_FUNC_PREFIX(mat4_mult_array_avx512),
+			QM_FUNC_PREFIX(mat4_mult_array_pairwise_avx512),
+			QM_FUNC_PREFIX(frustum_cull_bbox3_avx2),
+			QM_FUNC_PREFIX(mat4_from_trs_array_sse),
+			QM_FUNC_PREFIX(mat4_mult_vec4_array_avx512),
+			QM_FUNC_PREFIX(mat4_transform_vec3_array_avx512),
+			QM_FUNC_PREFIX(mat4_transform_vec3_dir_array_avx512),
+			QM_FUNC_PREFIX(vec4_dot_array_avx512),
+			QM_FUNC_PREFIX(quaternion_normalize_array_avx512),
+			QM_FUNC_PREFIX(quaternion_blend_array_avx2),
+			QM_FUNC_PREFIX(bbox3_union_vec3_array_avx512),
+			QM_FUNC_PREFIX(bbox3_union_array_avx512),
+			QM_FUNC_PREFIX(bbox3_transform_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack32_array_sse),
+			QM_FUNC_PREFIX(quaternion_pack48_array_sse),
+			QM_FUNC_PREFIX(quaternion_unpack48_array_sse),
+			QM_FUNC_PREFIX(vec3_pack16_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack16_array_sse),
+			QM_FUNC_PREFIX(vec3_pack_oct_array_sse),
+			QM_FUNC_PREFIX(vec3_unpack_oct_array_sse),
+			QM_FUNC_PREFIX(float_to_half_array_f16c),
+			QM_FUNC_PREFIX(half_to_float_array_f16c)
+		}
+	};
+
+	return tables;
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_union_inplace)(QMbbox3* b1, QMbbox3 b2)
+//the published table, read with acquire and written with release so that any thread sees either no table or a
+//complete one. aligned pointer accesses are atomic on x86-64, MSVC's volatile accesses are acquire/release there
+
+QM_FUNC_ATTRIBS const QMdispatchTable** QM_FUNC_PREFIX(dispatch_table_storage)(void)
 {
-	b1->min = QM_FUNC_PREFIX(vec3_min)(b1->min, b2.min);
-	b1->max = QM_FUNC_PREFIX(vec3_max)(b1->max, b2.max);
+	static const QMdispatchTable* table = NULL;
+	return &table;
 }
 
-//vector union:
+//binds the kernels for the best tier supported by the cpu, but no higher than maxTier. called automatically
+//on first use, it is safe to call at any time from any thread
 
-QM_FUNC_ATTRIBS QMbbox2 QM_FUNC_PREFIX(bbox2_union_vec2)(QMbbox2 b, QMvec2 v)
+QM_FUNC_ATTRIBS QMsimdTier QM_FUNC_PREFIX(dispatch_init)(QMsimdTier maxTier)
 {
-	QMbbox2 result;
+	QMsimdTier tier = QM_FUNC_PREFIX(cpu_simd_tier)();
+	tier = QM_MIN(tier, maxTier);
 
-	result.min = QM_FUNC_PREFIX(vec2_min)(b.min, v);
-	result.max = QM_FUNC_PREFIX(vec2_max)(b.max, v);
+	const QMdispatchTable* table = &QM_FUNC_PREFIX(dispatch_tables)()[tier];
+	const QMdispatchTable** storage = QM_FUNC_PREFIX(dispatch_table_storage)();
 
-	return result;
-}
+	#if defined(_MSC_VER) && !defined(__clang__)
 
-QM_FUNC_ATTRIBS QMbbox3 QM_FUNC_PREFIX(bbox3_union_vec3)(QMbbox3 b, QMvec3 v)
-{
-	QMbbox3 result;
+	*(const QMdispatchTable* volatile*)storage = table;
 
-	result.min = QM_FUNC_PREFIX(vec3_min)(b.min, v);
-	result.max = QM_FUNC_PREFIX(vec3_max)(b.max, v);
+	#else
 
-	return result;
-}
+	__atomic_store_n(storage, table, __ATOMIC_RELEASE);
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox2_union_vec2_inplace)(QMbbox2* b, QMvec2 v)
-{
-	b->min = QM_FUNC_PREFIX(vec2_min)(b->min, v);
-	b->max = QM_FUNC_PREFIX(vec2_max)(b->max, v);
+	#endif
+
+	return tier;
 }
 
-QM_FUNC_ATTRIBS void QM_FUNC_PREFIX(bbox3_union_vec3_inplace)(QMbbox3* b, QMvec3 v)
+QM_FUNC_ATTRIBS const QMdispatchTable* QM_FUNC_PREFIX(dispatch_table)(void)
 {
-	b->min = QM_FUNC_PREFIX(vec3_min)(b->min, v);
-	b->max = QM_FUNC_PREFIX(vec3_max)(b->max, v);
-}
+	const QMdispatchTable** storage = QM_FUNC_PREFIX(dispatch_table_storage)();
 
-//extent:
+	#if defined(_MSC_VER) && !defined(__clang__)
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_extent)(QMbbox2 b)
-{
-	return QM_FUNC_PREFIX(vec2_sub)(b.max, b.min);
-}
+	const QMdispatchTable* table = *(const QMdispatchTable* volatile*)storage;
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_extent)(QMbbox3 b)
-{
-	return QM_FUNC_PREFIX(vec3_sub)(b.max, b.min);
-}
+	#else
 
-//centroid:
+	const QMdispatchTable* table = __atomic_load_n(storage, __ATOMIC_ACQUIRE);
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_centroid)(QMbbox2 b)
-{
-	return QM_FUNC_PREFIX(vec2_scale)(QM_FUNC_PREFIX(vec2_add)(b.max, b.min), 0.5f);
-}
+	#endif
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_centroid)(QMbbox3 b)
-{
-	return QM_FUNC_PREFIX(vec3_scale)(QM_FUNC_PREFIX(vec3_add)(b.max, b.min), 0.5f);
+	//threads racing here all publish the same table
+	if(table == NULL)
+		table = &QM_FUNC_PREFIX(dispatch_tables)()[QM_FUNC_PREFIX(dispatch_init)(QM_SIMD_AVX512)];
+
+	return table;
 }
 
-//offset:
+#endif
 
-QM_FUNC_ATTRIBS QMvec2 QM_FUNC_PREFIX(bbox2_offset)(QMbbox2 b, QMvec2 v)
-{
-	return QM_FUNC_PREFIX(vec2_div)(QM_FUNC_PREFIX(vec2_sub)(v, b.min), QM_FUNC_PREFIX(bbox2_extent)(b));
-}
+//returns the tier used by the batch functions
 
-QM_FUNC_ATTRIBS QMvec3 QM_FUNC_PREFIX(bbox3_offset)(QMbbox3 b, QMvec3 v)
+QM_FUNC_ATTRIBS QMsimdTier QM_FUNC_PREFIX(simd_tier)(void)
 {
-	return QM_FUNC_PREFIX(vec3_div)(QM_FUNC_PREFIX(vec3_sub)(v, b.min), QM_FUNC_PREFIX(bbox3_extent)(b));
-}
+	#if QM_USE_DISPATCH
 
-//perimeter/sa:
+	return QM_FUNC_PREFIX(dispatch_table)()->tier;
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bbox2_perimeter)(QMbbox2 b)
-{
-	float result = 0.0f;
+	#elif QM_USE_AVX512
 
-	QMvec2 extent = QM_FUNC_PREFIX(bbox2_extent)(b);
-	
-	result += extent.x;
-	result += extent.y;
-	result *= 2.0f;
+	return QM_SIMD_AVX512;
 
-	return result;
-}
+	#elif QM_USE_AVX2
 
-QM_FUNC_ATTRIBS float QM_FUNC_PREFIX(bbox3_surface_area)(QMbbox3 b)
-{
-	float result = 0.0f;
+	return QM_SIMD_AVX2;
 
-	QMvec3 extent = QM_FUNC_PREFIX(bbox3_extent)(b);
+	#elif QM_USE_SSE
 
-	result += extent.x * extent.y;
-	result += extent.x * extent.z;
-	result += extent.y * extent.z;
-	result *= 2.0f;
+	return QM_SIMD_SSE;
 
-	return result;
+	#else
+
+	return QM_SIMD_SCALAR;
+
+	#endif
+}
+
+QM_FUNC_ATTRIBS const char* QM_FUNC_PREFIX(simd_tier_name)(QMsimdTier tier)
+{
+	switch(tier)
+	{
+	case QM_SIMD_SCALAR:
+		return "scalar";
+	case QM_SIMD_SSE:
+		return "SSE";
+	case QM_SIMD_AVX2:
+		return "AVX2";
+	case QM_SIMD_AVX512:
+		return "AVX-512";
+	default:
+		return "unknown";
+	}
 }
 
+
 #ifdef __cplusplus
 } //extern "C"
 #endif
@@ -0,0 +1,60 @@
+#!/bin/sh
+# builds every test as C and C++ under each SIMD configuration and runs it
+#
+# usage: tests/run_tests.sh [test_name ...]   (e.g. tests/run_tests.sh test_half, all tests by default)
+#
+# CC, CXX, and CFLAGS override the compilers and add flags. QM_TEST_CONFIGS overrides the configurations, a list
+# of flag sets separated by ";". configurations the cpu cannot run (the test dies with SIGILL) are skipped
+
+cd "$(dirname "$0")" || exit 1
+
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CONFIGS=${QM_TEST_CONFIGS:-"-mno-sse3;-msse3;-mavx;-mavx2 -mfma -mf16c;-march=skylake-avx512;-msse3 -DQM_RUNTIME_DISPATCH;-mavx2 -mfma -DQM_FAST_TRIG"}
+WARNINGS="-Wall -Wextra -Wno-missing-braces -Wno-missing-field-initializers"
+
+if [ $# -gt 0 ]; then
+	TESTS="$*"
+else
+	TESTS=$(ls test_*.c | sed 's/\.c$//')
+fi
+
+BIN=$(mktemp -d)
+trap 'rm -rf "$BIN"' EXIT
+
+failed=0
+IFS=';'
+for config in $CONFIGS; do
+	unset IFS
+	for test in $TESTS; do
+		for lang in c c++; do
+			if [ "$lang" = c ]; then
+				compile="$CC -std=c99 -O2 $WARNINGS"
+			else
+				# gcc's AVX-512 headers trip -Wuninitialized in C++ through _mm512_undefined_ps
+				compile="$CXX -x c++ -O2 $WARNINGS -Wno-uninitialized"
+			fi
+
+			if ! $compile $config $CFLAGS "$test.c" -o "$BIN/$test" -lm -lpthread; then
+				echo "$test [$lang $config]: build failed"
+				failed=1
+				continue
+			fi
+
+			output=$("$BIN/$test" 2>&1)
+			status=$?
+			if [ $status -eq 132 ]; then
+				echo "$test [$lang $config]: skipped, unsupported by this cpu"
+			elif [ $status -ne 0 ]; then
+				echo "$output"
+				echo "$test [$lang $config]: FAILED"
+				failed=1
+			else
+				echo "$output [$lang $config]"
+			fi
+		done
+	done
+	IFS=';'
+done
+
+exit $failed
@@ -0,0 +1,315 @@
+/* ------------------------------------------------------------------------
+ *
+ * test.h
+ * description: shared helpers for the quickmath tests. each test_*.c file is a standalone
+ * program, run_tests.sh builds and runs them under every SIMD configuration
+ *
+ * ------------------------------------------------------------------------
+ */
+
+#ifndef QM_TEST_H
+#define QM_TEST_H
+
+#include "../quickmath.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------//
+//CHECKS:
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { if(!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); testFailures++; } } while(0)
+
+//runs the statement after it once per SIMD tier when runtime dispatch is enabled, and once otherwise. tiers the
+//cpu does not support are clamped by qm_dispatch_init, so they repeat the best supported one
+
+#if QM_USE_DISPATCH
+	#define FOR_EACH_TIER(tier) for(int tier = QM_SIMD_SCALAR; tier <= QM_SIMD_AVX512 && (qm_dispatch_init((QMsimdTier)tier), 1); tier++)
+#else
+	#define FOR_EACH_TIER(tier) for(int tier = 0; tier < 1; tier++)
+#endif
+
+static inline int test_report(const char* name)
+{
+	#if QM_USE_DISPATCH
+
+	qm_dispatch_init(QM_SIMD_AVX512);
+
+	#endif
+
+	if(testFailures)
+		printf("%s: %d checks failed (%s)\n", name, testFailures, qm_simd_tier_name(qm_simd_tier()));
+	else
+		printf("%s: ok (%s)\n", name, qm_simd_tier_name(qm_simd_tier()));
+
+	return testFailures ? 1 : 0;
+}
+
+//----------------------------------------------------------------------//
+//COMPARISONS:
+
+//relative to the magnitude of the operands, with an absolute floor of eps near 0
+
+static inline int test_near(float a, float b, float eps)
+{
+	return fabsf(a - b) <= eps * (1.0f + fabsf(a) + fabsf(b));
+}
+
+static inline int test_vec3_near(QMvec3 a, QMvec3 b, float eps)
+{
+	return test_near(a.x, b.x, eps) && test_near(a.y, b.y, eps) && test_near(a.z, b.z, eps);
+}
+
+static inline int test_mat4_near(QMmat4 a, QMmat4 b, float eps)
+{
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			if(!test_near(a.m[i][j], b.m[i][j], eps))
+				return 0;
+
+	return 1;
+}
+
+static inline int test_bbox3_equal(QMbbox3 a, QMbbox3 b)
+{
+	return memcmp(&a, &b, sizeof(QMbbox3)) == 0;
+}
+
+//----------------------------------------------------------------------//
+//REFERENCES:
+
+//slerp along the shortest arc in double precision, normalized
+
+static inline void test_reference_slerp(QMquaternion a, QMquaternion b, double t, double* out)
+{
+	double cosine = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z + (double)a.w * b.w;
+	double sign = 1.0;
+	if(cosine < 0.0)
+	{
+		cosine = -cosine;
+		sign = -1.0;
+	}
+
+	double angle = acos(fmin(cosine, 1.0));
+	double weight1 = 1.0 - t, weight2 = t;
+	if(angle > 1e-9)
+	{
+		weight1 = sin((1.0 - t) * angle) / sin(angle);
+		weight2 = sin(t * angle) / sin(angle);
+	}
+
+	double len = 0.0;
+	for(int k = 0; k < 4; k++)
+	{
+		out[k] = weight1 * a.q[k] + sign * weight2 * b.q[k];
+		len += out[k] * out[k];
+	}
+
+	for(int k = 0; k < 4; k++)
+		out[k] /= sqrt(len);
+}
+
+//----------------------------------------------------------------------//
+//RANDOM VALUES:
+
+//in [-1, 1]
+
+static inline float test_rand(void)
+{
+	return (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+static inline QMvec3 test_rand_vec3(float scale)
+{
+	QMvec3 result;
+	result.x = test_rand() * scale;
+	result.y = test_rand() * scale;
+	result.z = test_rand() * scale;
+
+	return result;
+}
+
+static inline QMquaternion test_rand_quaternion(void)
+{
+	QMquaternion result;
+	result.x = test_rand();
+	result.y = test_rand();
+	result.z = test_rand();
+	result.w = test_rand();
+
+	return qm_quaternion_normalize(result);
+}
+
+//a box centered within [-center, center] with half extents up to halfSize
+
+static inline QMbbox3 test_rand_bbox3(float center, float halfSize)
+{
+	QMvec3 c = test_rand_vec3(center);
+	QMvec3 e = test_rand_vec3(halfSize);
+	e.x = fabsf(e.x);
+	e.y = fabsf(e.y);
+	e.z = fabsf(e.z);
+
+	QMbbox3 result;
+	result.min = qm_vec3_sub(c, e);
+	result.max = qm_vec3_add(c, e);
+
+	return result;
+}
+
+//translation * rotation * scale, with a uniform scale of 1 when rigid is set
+
+static inline QMmat4 test_rand_trs(int rigid)
+{
+	QMvec3 scale;
+	scale.x = rigid ? 1.0f : 1.0f + test_rand() * 0.5f;
+	scale.y = rigid ? 1.0f : 1.5f;
+	scale.z = rigid ? 1.0f : 0.7f;
+
+	QMmat4 rotation = qm_mat4_rotate(test_rand_vec3(1.0f), test_rand() * 180.0f);
+	return qm_mat4_mult(qm_mat4_translate(test_rand_vec3(50.0f)), qm_mat4_mult(rotation, qm_mat4_scale(scale)));
+}
+
+//----------------------------------------------------------------------//
+//BOUNDING VOLUME HIERARCHIES:
+
+static inline int test_bbox3_contains(QMbbox3 outer, QMbbox3 inner)
+{
+	return inner.min.x >= outer.min.x && inner.min.y >= outer.min.y && inner.min.z >= outer.min.z &&
+	       inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+//walks a built hierarchy and checks that every node is in range, bounds its children and primitives, and that the
+//leaves cover every primitive exactly once. returns the largest leaf, the depth is returned through maxDepth
+
+static inline uint32_t test_check_bvh(const QMbvhNode* nodes, uint32_t nodeCount, const QMbbox3* prims,
+                                      const uint32_t* primIndices, uint32_t primCount, int* maxDepth)
+{
+	uint32_t* seen = (uint32_t*)calloc(primCount, sizeof(uint32_t));
+	uint32_t stackNodes[QM_BVH_MAX_DEPTH + 1];
+	int stackDepths[QM_BVH_MAX_DEPTH + 1];
+	int stackSize = 1;
+	stackNodes[0] = 0;
+	stackDepths[0] = 0;
+
+	uint32_t maxLeaf = 0;
+	*maxDepth = 0;
+
+	while(stackSize > 0)
+	{
+		stackSize--;
+		uint32_t node = stackNodes[stackSize];
+		int depth = stackDepths[stackSize];
+		*maxDepth = depth > *maxDepth ? depth : *maxDepth;
+
+		CHECK(node < nodeCount);
+		if(node >= nodeCount)
+			break;
+
+		QMbvhNode n = nodes[node];
+		if(n.count > 0)
+		{
+			maxLeaf = n.count > maxLeaf ? n.count : maxLeaf;
+
+			CHECK(n.leftFirst + n.count <= primCount);
+			for(uint32_t i = n.leftFirst; i < n.leftFirst + n.count && i < primCount; i++)
+			{
+				CHECK(primIndices[i] < primCount);
+				if(primIndices[i] >= primCount)
+					continue;
+
+				seen[primIndices[i]]++;
+				CHECK(test_bbox3_contains(n.bounds, prims[primIndices[i]]));
+			}
+		}
+		else
+		{
+			CHECK(n.leftFirst + 1 < nodeCount && depth < QM_BVH_MAX_DEPTH);
+			if(n.leftFirst + 1 >= nodeCount || depth >= QM_BVH_MAX_DEPTH)
+				break;
+
+			for(uint32_t c = 0; c < 2; c++)
+			{
+				CHECK(test_bbox3_contains(n.bounds, nodes[n.leftFirst + c].bounds));
+
+				stackNodes[stackSize] = n.leftFirst + c;
+				stackDepths[stackSize] = depth + 1;
+				stackSize++;
+			}
+		}
+	}
+
+	for(uint32_t i = 0; i < primCount; i++)
+		CHECK(seen[i] == 1);
+
+	free(seen);
+	return maxLeaf;
+}
+
+//----------------------------------------------------------------------//
+//THREADS:
+
+//a minimal QMparallelForFunc: user points to the thread count, each thread takes the next index until none are left
+
+typedef struct
+{
+	QMtaskFunc task;
+	void* data;
+	uint32_t count;
+	uint32_t next;
+	pthread_mutex_t lock;
+} TestJob;
+
+static inline void* test_worker(void* arg)
+{
+	TestJob* job = (TestJob*)arg;
+	for(;;)
+	{
+		pthread_mutex_lock(&job->lock);
+		uint32_t index = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if(index >= job->count)
+			break;
+
+		job->task(job->data, index);
+	}
+
+	return NULL;
+}
+
+static inline void test_parallel_for(void* user, QMtaskFunc task, void* data, uint32_t count)
+{
+	int threadCount = *(int*)user;
+
+	TestJob job;
+	job.task = task;
+	job.data = data;
+	job.count = count;
+	job.next = 0;
+	pthread_mutex_init(&job.lock, NULL);
+
+	pthread_t threads[16];
+	for(int i = 0; i < threadCount; i++)
+		pthread_create(&threads[i], NULL, test_worker, &job);
+	for(int i = 0; i < threadCount; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&job.lock);
+}
+
+//runs the tasks serially in reverse order, results must not depend on the order tasks run in
+
+static inline void test_reverse_for(void* user, QMtaskFunc task, void* data, uint32_t count)
+{
+	(void)user;
+	for(uint32_t i = count; i > 0; i--)
+		task(data, i - 1);
+}
+
+#endif //QM_TEST_H
@@ -0,0 +1,136 @@
+#include "test.h"
+
+#define TRACKS 150
+#define MAX_KEYS 40
+
+static QManimKey keys[TRACKS][MAX_KEYS];
+static QManimKeyBlock blocks[TRACKS][(MAX_KEYS + 3) / 4];
+static QManimTrack tracks[TRACKS];
+static uint32_t cursors[TRACKS], matCursors[TRACKS];
+
+static QMvec3 translations[TRACKS], scales[TRACKS];
+static QMquaternion rotations[TRACKS];
+static QMmat4 matrices[TRACKS + 1];
+
+//searches every key for the last one at or before t, then lerps and slerps in double precision
+
+static void reference_sample(const QManimKey* k, uint32_t count, float t, QMvec3* translation, double* rotation, QMvec3* scale)
+{
+	uint32_t from = 0;
+	for(uint32_t i = 0; i < count; i++)
+		if(k[i].time <= t)
+			from = i;
+
+	uint32_t to = from + 1 < count ? from + 1 : from;
+
+	float a = 0.0f;
+	if(k[to].time > k[from].time)
+		a = QM_MIN(QM_MAX((t - k[from].time) / (k[to].time - k[from].time), 0.0f), 1.0f);
+
+	for(int j = 0; j < 3; j++)
+	{
+		translation->v[j] = k[from].translation.v[j] + (k[to].translation.v[j] - k[from].translation.v[j]) * a;
+		scale->v[j] = k[from].scale.v[j] + (k[to].scale.v[j] - k[from].scale.v[j]) * a;
+	}
+
+	test_reference_slerp(k[from].rotation, k[to].rotation, a, rotation);
+}
+
+//tracks of 1 to MAX_KEYS keys with some repeated times, and rotations that wander with occasional sign flips and jumps
+
+static void generate(void)
+{
+	for(int i = 0; i < TRACKS; i++)
+	{
+		uint32_t count = 1 + rand() % MAX_KEYS;
+		float time = test_rand() * 2.0f;
+		QMquaternion rotation = test_rand_quaternion();
+
+		for(uint32_t k = 0; k < count; k++)
+		{
+			keys[i][k].time = time;
+			time += rand() % 6 == 0 ? 0.0f : (test_rand() + 1.0f) * 0.3f;
+
+			keys[i][k].translation = test_rand_vec3(5.0f);
+			keys[i][k].scale = qm_vec3_add((QMvec3){{ 1.0f, 1.0f, 1.0f }}, test_rand_vec3(0.5f));
+
+			QMquaternion step = {{ test_rand() * 0.4f, test_rand() * 0.4f, test_rand() * 0.4f, test_rand() * 0.4f }};
+			rotation = qm_quaternion_normalize(qm_quaternion_add(rotation, step));
+			if(rand() % 4 == 0)
+				rotation = qm_quaternion_scale(rotation, -1.0f);
+
+			keys[i][k].rotation = rand() % 9 == 0 ? test_rand_quaternion() : rotation;
+		}
+
+		qm_anim_track_pack(keys[i], count, blocks[i]);
+
+		//the last block is padded with the last key
+		CHECK(blocks[i][(count + 3) / 4 - 1].time[3] == keys[i][count - 1].time);
+
+		tracks[i].blocks = blocks[i];
+		tracks[i].keyCount = count;
+		cursors[i] = 0;
+		matCursors[i] = 0;
+	}
+}
+
+static void test_time(float t, int first)
+{
+	qm_anim_sample(tracks, cursors, TRACKS, t, translations, rotations, scales);
+	qm_anim_sample_mat4(tracks, matCursors, TRACKS, t, matrices);
+
+	for(int i = 0; i < TRACKS; i++)
+	{
+		QMvec3 translation, scale;
+		double rotation[4];
+		reference_sample(keys[i], tracks[i].keyCount, t, &translation, rotation, &scale);
+
+		CHECK(cursors[i] < tracks[i].keyCount && cursors[i] == matCursors[i]);
+		CHECK(test_vec3_near(translations[i], translation, 1e-5f) && test_vec3_near(scales[i], scale, 1e-5f));
+		for(int k = 0; k < 4; k++)
+			CHECK(fabs(rotations[i].q[k] - rotation[k]) < 2e-6);
+
+		CHECK(test_mat4_near(matrices[i], qm_mat4_from_trs(translations[i], rotations[i], scales[i]), 1e-5f));
+
+		//one track at a time blends through the same kernel, so it agrees with the batch to within the kernel's error
+		//and lands on the same key
+		uint32_t cursor = first ? 0 : cursors[i];
+		QMvec3 trackTranslation, trackScale;
+		QMquaternion trackRotation;
+		qm_anim_track_sample(tracks[i], &cursor, t, &trackTranslation, &trackRotation, &trackScale);
+
+		CHECK(cursor == cursors[i]);
+		CHECK(memcmp(&trackTranslation, &translations[i], sizeof(QMvec3)) == 0 && memcmp(&trackScale, &scales[i], sizeof(QMvec3)) == 0);
+		for(int k = 0; k < 4; k++)
+		{
+			CHECK(fabs(trackRotation.q[k] - rotation[k]) < 2e-6);
+			CHECK(fabsf(trackRotation.q[k] - rotations[i].q[k]) < 4e-6f);
+		}
+	}
+}
+
+int main(void)
+{
+	generate();
+
+	memset(&matrices[TRACKS], 0x5A, sizeof(QMmat4));
+	QMmat4 sentinel = matrices[TRACKS];
+
+	FOR_EACH_TIER(tier)
+	{
+		//sequential playback from before the first keys to after the last, then random seeks both ways
+		int first = 1;
+		for(float t = -3.0f; t < 16.0f; t += 0.05f, first = 0)
+			test_time(t, first);
+
+		for(int i = 0; i < 60; i++)
+			test_time(test_rand() * 20.0f, 0);
+
+		test_time(1e30f, 0);
+		test_time(-1e30f, 0);
+	}
+
+	CHECK(memcmp(&matrices[TRACKS], &sentinel, sizeof(QMmat4)) == 0);
+
+	return test_report("test_anim");
+}
@@ -0,0 +1,91 @@
+#include "test.h"
+
+#define MAX_COUNT 48
+#define SENTINEL 12345.0f
+
+//the bulk vector kernels against their scalar versions, at every length up to several times the 16-wide AVX-512
+//kernels so each tail size is hit
+
+static void test_lengths(void)
+{
+	QMvec4 a[MAX_COUNT], b[MAX_COUNT];
+	QMquaternion q[MAX_COUNT];
+	QMvec3 points[MAX_COUNT];
+	QMbbox3 boxes[MAX_COUNT];
+	for(int i = 0; i < MAX_COUNT; i++)
+	{
+		a[i] = (QMvec4){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		b[i] = (QMvec4){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		q[i] = (QMquaternion){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		points[i] = test_rand_vec3(4.0f);
+		boxes[i] = test_rand_bbox3(4.0f, 1.0f);
+	}
+
+	//a zero quaternion normalizes to zero instead of NaN
+	q[3] = (QMquaternion){{ 0.0f, 0.0f, 0.0f, 0.0f }};
+
+	for(int n = 0; n < MAX_COUNT; n++)
+	{
+		float dots[MAX_COUNT], expectedDots[MAX_COUNT];
+		QMquaternion normalized[MAX_COUNT], expectedNormalized[MAX_COUNT];
+		dots[n] = SENTINEL;
+		normalized[n].x = SENTINEL;
+
+		qm_vec4_dot_array(a, b, dots, n);
+		qm_vec4_dot_array_scalar(a, b, expectedDots, n);
+		qm_quaternion_normalize_array(q, normalized, n);
+		qm_quaternion_normalize_array_scalar(q, expectedNormalized, n);
+
+		for(int i = 0; i < n; i++)
+		{
+			CHECK(test_near(dots[i], expectedDots[i], 1e-6f));
+			for(int j = 0; j < 4; j++)
+				CHECK(test_near(normalized[i].q[j], expectedNormalized[i].q[j], 1e-6f));
+		}
+
+		if(n > 3)
+			CHECK(normalized[3].x == 0.0f && normalized[3].y == 0.0f && normalized[3].z == 0.0f && normalized[3].w == 0.0f);
+
+		//nothing past the end is written
+		CHECK(dots[n] == SENTINEL && normalized[n].x == SENTINEL);
+
+		//min and max are exact, so the unions match bit for bit
+		QMbbox3 start = qm_bbox3_initialized();
+		start.min.y = -0.5f;
+		start.max.y = 0.5f;
+
+		CHECK(test_bbox3_equal(qm_bbox3_union_vec3_array(start, points, n), qm_bbox3_union_vec3_array_scalar(start, points, n)));
+		CHECK(test_bbox3_equal(qm_bbox3_union_array(start, boxes, n), qm_bbox3_union_array_scalar(start, boxes, n)));
+	}
+}
+
+static void test_in_place(void)
+{
+	enum { N = 37 };
+
+	QMquaternion q[N], expected[N];
+	for(int i = 0; i < N; i++)
+	{
+		q[i] = (QMquaternion){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		expected[i] = qm_quaternion_normalize(q[i]);
+	}
+
+	qm_quaternion_normalize_array(q, q, N);
+	for(int i = 0; i < N; i++)
+		for(int j = 0; j < 4; j++)
+			CHECK(test_near(q[i].q[j], expected[i].q[j], 1e-6f));
+}
+
+int main(void)
+{
+	FOR_EACH_TIER(tier)
+	{
+		for(int i = 0; i < 20; i++)
+		{
+			test_lengths();
+			test_in_place();
+		}
+	}
+
+	return test_report("test_batch");
+}
@@ -0,0 +1,85 @@
+#include "test.h"
+
+#define COUNT 37
+
+static QMmat4 matrices[COUNT];
+static QMbbox3 boxes[COUNT], corners[COUNT];
+
+//the union of the 8 transformed corners, which Arvo's method must reproduce
+
+static QMbbox3 transform_corners(QMmat4 m, QMbbox3 b)
+{
+	QMbbox3 result = qm_bbox3_initialized();
+	for(int c = 0; c < 8; c++)
+	{
+		QMvec3 p;
+		p.x = (c & 1) ? b.max.x : b.min.x;
+		p.y = (c & 2) ? b.max.y : b.min.y;
+		p.z = (c & 4) ? b.max.z : b.min.z;
+
+		result = qm_bbox3_union_vec3(result, qm_mat4_transform_vec3(m, p));
+	}
+
+	return result;
+}
+
+static int bbox3_near(QMbbox3 a, QMbbox3 b, float eps)
+{
+	return test_vec3_near(a.min, b.min, eps) && test_vec3_near(a.max, b.max, eps);
+}
+
+static void test_single(void)
+{
+	for(int i = 0; i < COUNT; i++)
+		CHECK(bbox3_near(qm_bbox3_transform(matrices[i], boxes[i]), corners[i], 1e-4f));
+
+	//a point box stays a point, and the identity changes nothing beyond rounding through the center and extent
+	QMbbox3 point = {{{ 1.0f, 2.0f, 3.0f }}, {{ 1.0f, 2.0f, 3.0f }}};
+	QMbbox3 moved = qm_bbox3_transform(matrices[0], point);
+	CHECK(test_vec3_near(moved.min, qm_mat4_transform_vec3(matrices[0], point.min), 1e-5f));
+	CHECK(test_vec3_near(moved.min, moved.max, 1e-6f));
+
+	CHECK(bbox3_near(qm_bbox3_transform(qm_mat4_identity(), boxes[0]), boxes[0], 1e-6f));
+}
+
+//every length up to COUNT matches the single box function on every tier, without writing past the end
+
+static void test_array(void)
+{
+	FOR_EACH_TIER(tier)
+	{
+		QMbbox3 out[COUNT + 1];
+		memset(&out[COUNT], 0x5A, sizeof(QMbbox3));
+		QMbbox3 sentinel = out[COUNT];
+
+		for(int n = 0; n <= COUNT; n++)
+		{
+			qm_bbox3_transform_array(matrices, boxes, out, n);
+			for(int i = 0; i < n; i++)
+				CHECK(bbox3_near(out[i], qm_bbox3_transform(matrices[i], boxes[i]), 1e-6f));
+		}
+
+		CHECK(test_bbox3_equal(out[COUNT], sentinel));
+
+		//in place
+		memcpy(out, boxes, sizeof(boxes));
+		qm_bbox3_transform_array(matrices, out, out, COUNT);
+		for(int i = 0; i < COUNT; i++)
+			CHECK(bbox3_near(out[i], corners[i], 1e-4f));
+	}
+}
+
+int main(void)
+{
+	for(int i = 0; i < COUNT; i++)
+	{
+		matrices[i] = test_rand_trs(i & 1);
+		boxes[i] = test_rand_bbox3(5.0f, 3.0f);
+		corners[i] = transform_corners(matrices[i], boxes[i]);
+	}
+
+	test_single();
+	test_array();
+
+	return test_report("test_bbox_transform");
+}
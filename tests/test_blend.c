@@ -0,0 +1,100 @@
+#include "test.h"
+
+#define COUNT 203
+
+static QMquaternion from[COUNT], to[COUNT];
+static float alphas[COUNT];
+
+static int near_reference(QMquaternion q, QMquaternion a, QMquaternion b, float t, float eps)
+{
+	double expected[4];
+	test_reference_slerp(a, b, t, expected);
+
+	for(int k = 0; k < 4; k++)
+		if(fabs(q.q[k] - expected[k]) > eps)
+			return 0;
+
+	return 1;
+}
+
+//identical, nearly identical, opposite hemisphere, nearly opposite, and unrelated pairs, with alphas of exactly 0
+//and 1 mixed in
+
+static void generate(void)
+{
+	for(int i = 0; i < COUNT; i++)
+	{
+		from[i] = test_rand_quaternion();
+
+		QMquaternion offset = {{ test_rand(), test_rand(), test_rand(), 0.0f }};
+		switch(i % 5)
+		{
+		case 0:
+			to[i] = from[i];
+			break;
+		case 1:
+			to[i] = qm_quaternion_normalize(qm_quaternion_add(from[i], qm_quaternion_scale(offset, 1e-3f)));
+			break;
+		case 2:
+			to[i] = qm_quaternion_scale(test_rand_quaternion(), -1.0f);
+			break;
+		case 3:
+			to[i] = qm_quaternion_scale(qm_quaternion_normalize(qm_quaternion_add(from[i], qm_quaternion_scale(offset, 0.05f))), -1.0f);
+			break;
+		default:
+			to[i] = test_rand_quaternion();
+			break;
+		}
+
+		alphas[i] = i % 7 == 0 ? 0.0f : i % 7 == 1 ? 1.0f : (test_rand() + 1.0f) * 0.5f;
+	}
+}
+
+static void test_blend_array(void)
+{
+	FOR_EACH_TIER(tier)
+	{
+		QMquaternion out[COUNT + 1];
+		memset(&out[COUNT], 0x5A, sizeof(QMquaternion));
+		QMquaternion sentinel = out[COUNT];
+
+		for(int n = 0; n <= COUNT; n += n < 20 ? 1 : 61)
+		{
+			qm_quaternion_blend_array(from, to, alphas, out, n);
+			for(int i = 0; i < n; i++)
+				CHECK(near_reference(out[i], from[i], to[i], alphas[i], 2e-6f));
+		}
+
+		CHECK(memcmp(&out[COUNT], &sentinel, sizeof(QMquaternion)) == 0);
+
+		//in place
+		memcpy(out, from, sizeof(from));
+		qm_quaternion_blend_array(out, to, alphas, out, COUNT);
+		for(int i = 0; i < COUNT; i++)
+			CHECK(near_reference(out[i], from[i], to[i], alphas[i], 2e-6f));
+	}
+}
+
+static void test_single(void)
+{
+	for(int i = 0; i < COUNT; i++)
+	{
+		CHECK(near_reference(qm_quaternion_slerp(from[i], to[i], alphas[i]), from[i], to[i], alphas[i], 2e-5f));
+
+		//nlerp follows the same arc at a different speed, so only its endpoints and length are fixed
+		QMquaternion nlerp = qm_quaternion_nlerp(from[i], to[i], alphas[i]);
+		CHECK(test_near(qm_quaternion_length(nlerp), 1.0f, 1e-5f));
+		if(alphas[i] == 0.0f || alphas[i] == 1.0f)
+			CHECK(near_reference(nlerp, from[i], to[i], alphas[i], 1e-6f));
+	}
+}
+
+int main(void)
+{
+	generate();
+
+	test_blend_array();
+	test_single();
+
+	return test_report("test_blend");
+}
@@ -0,0 +1,67 @@
+#include "test.h"
+
+#define MAX_PRIMS 5000
+
+static QMbbox3 prims[MAX_PRIMS];
+static QMbvhNode nodes[2 * MAX_PRIMS];
+static uint32_t primIndices[MAX_PRIMS];
+
+enum
+{
+	SCATTERED,
+	SAME_CENTROID,
+	FLAT
+};
+
+static void generate(int count, int layout)
+{
+	for(int i = 0; i < count; i++)
+	{
+		prims[i] = test_rand_bbox3(50.0f, 3.0f);
+
+		if(layout == SAME_CENTROID)
+		{
+			QMvec3 offset = qm_vec3_sub((QMvec3){{ 1.0f, 2.0f, 3.0f }}, qm_bbox3_centroid(prims[i]));
+			prims[i].min = qm_vec3_add(prims[i].min, offset);
+			prims[i].max = qm_vec3_add(prims[i].max, offset);
+		}
+		else if(layout == FLAT)
+			prims[i].min.y = prims[i].max.y = prims[i].min.z = prims[i].max.z = 0.0f;
+	}
+}
+
+static void test_build(int count, int layout)
+{
+	generate(count, layout);
+
+	uint32_t nodeCount = qm_bvh_build(prims, count, nodes, primIndices);
+	CHECK(nodeCount >= 1 && nodeCount <= (uint32_t)(2 * count - 1));
+
+	int depth;
+	uint32_t maxLeaf = test_check_bvh(nodes, nodeCount, prims, primIndices, count, &depth);
+
+	//primitives that share a centroid cannot be split
+	if(layout != SAME_CENTROID)
+		CHECK(maxLeaf <= QM_BVH_MAX_LEAF_SIZE);
+
+	float cost = qm_bvh_sah_cost(nodes);
+	CHECK(cost >= 0.0f && cost < 1e9f);
+
+	//well below testing every primitive
+	if(count == MAX_PRIMS && layout == SCATTERED)
+		CHECK(cost < 100.0f);
+}
+
+int main(void)
+{
+	int counts[] = { 1, 2, 3, 7, 100, MAX_PRIMS };
+	for(int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+		test_build(counts[i], SCATTERED);
+
+	test_build(3000, SAME_CENTROID);
+	test_build(3000, FLAT);
+
+	CHECK(qm_bvh_build(prims, 0, nodes, primIndices) == 0);
+
+	return test_report("test_bvh_build");
+}
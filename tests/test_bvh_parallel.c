@@ -0,0 +1,76 @@
+#include "test.h"
+
+#define MAX_PRIMS 100000
+
+static QMbbox3 prims[MAX_PRIMS];
+static QMbvhNode serialNodes[2 * MAX_PRIMS], parallelNodes[2 * MAX_PRIMS];
+static uint32_t serialIndices[MAX_PRIMS], parallelIndices[MAX_PRIMS];
+static QMbvhParallelState state;
+
+enum
+{
+	SCATTERED,
+	DUPLICATES,
+	SAME_CENTROID,
+	FLAT
+};
+
+//the parallel build must match the serial one exactly, for any thread count and task order
+
+static void test_build(int count, int layout)
+{
+	for(int i = 0; i < count; i++)
+	{
+		prims[i] = test_rand_bbox3(50.0f, 3.0f);
+
+		QMvec3 center = qm_bbox3_centroid(prims[i]);
+		if(layout == DUPLICATES)
+			center = (QMvec3){{ (float)((i * 7) % 13), (float)((i * 3) % 5), 0.0f }};
+		else if(layout == SAME_CENTROID)
+			center = (QMvec3){{ 1.0f, 2.0f, 3.0f }};
+
+		QMvec3 offset = qm_vec3_sub(center, qm_bbox3_centroid(prims[i]));
+		prims[i].min = qm_vec3_add(prims[i].min, offset);
+		prims[i].max = qm_vec3_add(prims[i].max, offset);
+
+		if(layout == FLAT)
+			prims[i].min.y = prims[i].max.y = 0.0f;
+	}
+
+	uint32_t serialCount = qm_bvh_build(prims, count, serialNodes, serialIndices);
+
+	uint32_t parallelCount = 0;
+	int threadCounts[] = { 1, 3, 8 };
+	for(int run = 0; run < 4; run++)
+	{
+		memset(parallelNodes, 0xCD, sizeof(QMbvhNode) * (2 * count));
+		memset(parallelIndices, 0xCD, sizeof(uint32_t) * count);
+
+		if(run < 3)
+			parallelCount = qm_bvh_build_parallel(prims, count, parallelNodes, parallelIndices, &state, test_parallel_for, &threadCounts[run]);
+		else
+			parallelCount = qm_bvh_build_parallel(prims, count, parallelNodes, parallelIndices, &state, test_reverse_for, NULL);
+
+		CHECK(parallelCount == serialCount);
+		CHECK(memcmp(parallelNodes, serialNodes, sizeof(QMbvhNode) * serialCount) == 0);
+		CHECK(memcmp(parallelIndices, serialIndices, sizeof(uint32_t) * count) == 0);
+	}
+
+	int depth;
+	test_check_bvh(parallelNodes, parallelCount, prims, parallelIndices, count, &depth);
+}
+
+int main(void)
+{
+	//small counts stay serial, the large ones split into chunks and subtree tasks
+	test_build(1, SCATTERED);
+	test_build(5, SCATTERED);
+	test_build(1000, SCATTERED);
+	test_build(5000, SCATTERED);
+	test_build(MAX_PRIMS, SCATTERED);
+	test_build(MAX_PRIMS, DUPLICATES);
+	test_build(60000, SAME_CENTROID);
+	test_build(30000, FLAT);
+
+	return test_report("test_bvh_parallel");
+}
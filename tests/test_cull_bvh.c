@@ -0,0 +1,107 @@
+#include "test.h"
+
+#define PRIM_COUNT 3000
+
+static QMbbox3 prims[PRIM_COUNT];
+static QMbvhNode nodes[2 * PRIM_COUNT];
+static uint32_t nodeCount;
+
+//a median split tree, so the culling is tested independently of the builders
+
+static void build(uint32_t node, uint32_t first, uint32_t count, int axis)
+{
+	QMbbox3 bounds = prims[first];
+	for(uint32_t i = 1; i < count; i++)
+		bounds = qm_bbox3_union(bounds, prims[first + i]);
+
+	nodes[node].bounds = bounds;
+	if(count <= 2)
+	{
+		nodes[node].leftFirst = first;
+		nodes[node].count = count;
+		return;
+	}
+
+	//insertion sort by centroid along axis
+	for(uint32_t i = first + 1; i < first + count; i++)
+	{
+		QMbbox3 b = prims[i];
+		float center = b.min.v[axis] + b.max.v[axis];
+
+		uint32_t j = i;
+		while(j > first && prims[j - 1].min.v[axis] + prims[j - 1].max.v[axis] > center)
+		{
+			prims[j] = prims[j - 1];
+			j--;
+		}
+
+		prims[j] = b;
+	}
+
+	uint32_t left = nodeCount;
+	nodeCount += 2;
+
+	nodes[node].leftFirst = left;
+	nodes[node].count = 0;
+
+	build(left, first, count / 2, (axis + 1) % 3);
+	build(left + 1, first + count / 2, count - count / 2, (axis + 1) % 3);
+}
+
+int main(void)
+{
+	for(int i = 0; i < PRIM_COUNT; i++)
+		prims[i] = test_rand_bbox3(80.0f, 2.0f);
+
+	nodeCount = 1;
+	build(0, 0, PRIM_COUNT, 0);
+
+	static uint32_t leaves[2 * PRIM_COUNT];
+	static uint8_t planeCache[2 * PRIM_COUNT];
+	static int expected[2 * PRIM_COUNT];
+
+	//a camera orbiting the scene, so the plane cache is reused across frames where it is both right and wrong
+	for(int frame = 0; frame < 40; frame++)
+	{
+		float angle = frame * 0.15f;
+		QMvec3 pos = {{ cosf(angle) * 5.0f, 1.0f, sinf(angle) * 5.0f }};
+		QMvec3 target = {{ cosf(angle) * 40.0f, 0.0f, sinf(angle) * -30.0f }};
+		QMmat4 view = qm_mat4_lookat(pos, target, (QMvec3){{ 0.0f, 1.0f, 0.0f }});
+		QMfrustum f = qm_frustum_from_mat4(qm_mat4_mult(qm_mat4_perspective(60.0f, 1.3f, 0.5f, 70.0f), view));
+
+		//a leaf is returned exactly when its own bounds are not outside
+		size_t expectedCount = 0;
+		for(uint32_t i = 0; i < nodeCount; i++)
+		{
+			expected[i] = nodes[i].count > 0 && qm_frustum_classify_bbox3(f, nodes[i].bounds) != QM_OUTSIDE;
+			expectedCount += expected[i];
+		}
+
+		if(frame == 0)
+			CHECK(expectedCount > 10 && expectedCount < nodeCount / 2);
+
+		for(int useCache = 0; useCache < 2; useCache++)
+		{
+			size_t count = qm_frustum_cull_bvh(f, nodes, useCache ? planeCache : NULL, leaves);
+			CHECK(count == expectedCount);
+
+			//each leaf once
+			for(size_t i = 0; i < count; i++)
+			{
+				CHECK(expected[leaves[i]] == 1);
+				expected[leaves[i]] = 2;
+			}
+
+			for(uint32_t i = 0; i < nodeCount; i++)
+				if(expected[i] == 2)
+					expected[i] = 1;
+		}
+	}
+
+	//a single leaf root
+	QMbvhNode root = { prims[0], 0, 1 };
+	QMfrustum everything = qm_frustum_from_mat4(qm_mat4_orthographic(-1000.0f, 1000.0f, -1000.0f, 1000.0f, -1000.0f, 1000.0f));
+	CHECK(qm_frustum_cull_bvh(everything, &root, NULL, leaves) == 1 && leaves[0] == 0);
+
+	return test_report("test_cull_bvh");
+}
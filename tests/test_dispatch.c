@@ -0,0 +1,99 @@
+#include "test.h"
+
+#include <pthread.h>
+
+#define THREADS 8
+#define COUNT 1000
+
+static QMmat4 matrix;
+static QMvec4 input[COUNT];
+static QMvec4 expected[COUNT];
+static QMvec4 output[THREADS][COUNT];
+
+//each thread's first batch call races to initialize the table
+
+static void* first_use(void* arg)
+{
+	int thread = (int)(size_t)arg;
+	for(int i = 0; i < 50; i++)
+	{
+		qm_mat4_mult_vec4_array(matrix, input, output[thread], COUNT);
+		qm_float_to_half_array(&input[0].x, (QMhalf*)&output[thread][COUNT / 2], 16);
+	}
+
+	return NULL;
+}
+
+#if QM_USE_DISPATCH
+
+//re-initializing while other threads run must never hand them a partial table
+
+static void* reinit(void* arg)
+{
+	(void)arg;
+	for(int i = 0; i < 2000; i++)
+		qm_dispatch_init((QMsimdTier)(i % (QM_SIMD_AVX512 + 1)));
+
+	return NULL;
+}
+
+#endif
+
+static void test_threads(void)
+{
+	matrix = test_rand_trs(0);
+	for(int i = 0; i < COUNT; i++)
+	{
+		input[i] = (QMvec4){{ test_rand(), test_rand(), test_rand(), 1.0f }};
+		expected[i] = qm_mat4_mult_vec4(matrix, input[i]);
+	}
+
+	pthread_t threads[THREADS + 1];
+	int threadCount = THREADS;
+	for(int i = 0; i < THREADS; i++)
+		pthread_create(&threads[i], NULL, first_use, (void*)(size_t)i);
+
+	#if QM_USE_DISPATCH
+
+	pthread_create(&threads[threadCount++], NULL, reinit, NULL);
+
+	#endif
+
+	for(int i = 0; i < threadCount; i++)
+		pthread_join(threads[i], NULL);
+
+	for(int t = 0; t < THREADS; t++)
+		for(int i = 0; i < COUNT / 2; i++)
+			for(int j = 0; j < 4; j++)
+				CHECK(test_near(output[t][i].v[j], expected[i].v[j], 1e-5f));
+}
+
+static void test_tiers(void)
+{
+	#if QM_USE_DISPATCH
+
+	QMsimdTier cpu = qm_cpu_simd_tier();
+	CHECK(cpu >= QM_SIMD_SSE && cpu <= QM_SIMD_AVX512);
+
+	//requests above what the cpu supports are clamped
+	for(int t = QM_SIMD_SCALAR; t <= QM_SIMD_AVX512; t++)
+	{
+		QMsimdTier tier = qm_dispatch_init((QMsimdTier)t);
+		CHECK((int)tier == QM_MIN(t, (int)cpu));
+		CHECK(qm_simd_tier() == tier);
+	}
+
+	#endif
+
+	for(int t = QM_SIMD_SCALAR; t <= QM_SIMD_AVX512; t++)
+		CHECK(qm_simd_tier_name((QMsimdTier)t) != NULL);
+}
+
+int main(void)
+{
+	//must come first so the threads see an uninitialized table
+	test_threads();
+	test_tiers();
+
+	return test_report("test_dispatch");
+}
@@ -0,0 +1,135 @@
+#include "test.h"
+
+#define BOX_COUNT 203
+
+static QMmat4 viewProj;
+static QMfrustum frustum;
+
+static float plane_distance(QMvec4 plane, QMvec3 p)
+{
+	return plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w;
+}
+
+//the planes against clip space, for points that are not too close to a plane to tell
+
+static void test_planes(void)
+{
+	for(int i = 0; i < 6; i++)
+	{
+		QMvec3 normal = {{ frustum.planes[i].x, frustum.planes[i].y, frustum.planes[i].z }};
+		CHECK(test_near(qm_vec3_length(normal), 1.0f, 1e-5f));
+	}
+
+	for(int i = 0; i < 2000; i++)
+	{
+		QMvec3 p = test_rand_vec3(60.0f);
+		QMvec4 clip = qm_mat4_mult_vec4(viewProj, (QMvec4){{ p.x, p.y, p.z, 1.0f }});
+		int inClip = clip.x >= -clip.w && clip.x <= clip.w && clip.y >= -clip.w && clip.y <= clip.w && clip.z >= -clip.w && clip.z <= clip.w;
+
+		int inPlanes = 1;
+		float closest = INFINITY;
+		for(int j = 0; j < 6; j++)
+		{
+			float dist = plane_distance(frustum.planes[j], p);
+			inPlanes &= dist >= 0.0f;
+			closest = QM_MIN(closest, fabsf(dist));
+		}
+
+		if(closest < 1e-3f)
+			continue;
+
+		CHECK(inPlanes == inClip);
+
+		QMbbox3 point = { p, p };
+		CHECK((qm_frustum_classify_bbox3(frustum, point) == QM_INSIDE) == inClip);
+	}
+}
+
+//a box is outside when all of its corners are behind one plane, and inside when all of them are in front of every plane
+
+static void test_classify(void)
+{
+	for(int i = 0; i < 2000; i++)
+	{
+		QMbbox3 b = test_rand_bbox3(60.0f, 8.0f);
+
+		int outside = 0, inside = 1;
+		for(int j = 0; j < 6; j++)
+		{
+			int behind = 0;
+			for(int corner = 0; corner < 8; corner++)
+			{
+				QMvec3 c = {{ (corner & 1) ? b.max.x : b.min.x, (corner & 2) ? b.max.y : b.min.y, (corner & 4) ? b.max.z : b.min.z }};
+				behind += plane_distance(frustum.planes[j], c) < 0.0f;
+			}
+
+			outside |= behind == 8;
+			inside &= behind == 0;
+		}
+
+		QMcullResult result = qm_frustum_classify_bbox3(frustum, b);
+		CHECK((result == QM_OUTSIDE) == outside);
+		CHECK((result == QM_INSIDE) == inside);
+	}
+}
+
+//the array forms against classify_bbox3, at every short length and a few long ones
+
+static void test_arrays(void)
+{
+	QMbbox3 boxes[BOX_COUNT];
+	int expected[BOX_COUNT];
+	int visibleCount = 0;
+	for(int i = 0; i < BOX_COUNT; i++)
+	{
+		boxes[i] = test_rand_bbox3(60.0f, 5.0f);
+		expected[i] = qm_frustum_classify_bbox3(frustum, boxes[i]) != QM_OUTSIDE;
+		visibleCount += expected[i];
+	}
+
+	CHECK(visibleCount > 5 && visibleCount < BOX_COUNT - 5);
+
+	FOR_EACH_TIER(tier)
+	{
+		for(int n = 0; n <= BOX_COUNT; n += (n < 40 ? 1 : 37))
+		{
+			uint32_t visible[(BOX_COUNT + 31) / 32];
+			memset(visible, 0xAB, sizeof(visible));
+
+			qm_frustum_cull_bbox3(frustum, boxes, n, visible);
+			for(int i = 0; i < n; i++)
+				CHECK(((visible[i / 32] >> (i % 32)) & 1) == (uint32_t)expected[i]);
+
+			//the unused bits of the last word are cleared
+			if(n % 32)
+				CHECK((visible[n / 32] >> (n % 32)) == 0);
+
+			uint32_t indices[BOX_COUNT];
+			size_t count = qm_frustum_cull_bbox3_indices(frustum, boxes, n, indices);
+
+			size_t k = 0;
+			for(int i = 0; i < n; i++)
+				if(expected[i])
+				{
+					CHECK(k < count && indices[k] == (uint32_t)i);
+					k++;
+				}
+
+			CHECK(k == count);
+		}
+	}
+}
+
+int main(void)
+{
+	QMmat4 proj = qm_mat4_perspective(70.0f, 1.5f, 0.1f, 100.0f);
+	QMmat4 view = qm_mat4_lookat((QMvec3){{ 1.0f, 2.0f, 3.0f }}, (QMvec3){{ 0.0f, 0.0f, -10.0f }}, (QMvec3){{ 0.0f, 1.0f, 0.0f }});
+	viewProj = qm_mat4_mult(proj, view);
+	frustum = qm_frustum_from_mat4(viewProj);
+
+	test_planes();
+	test_classify();
+	test_arrays();
+
+	return test_report("test_frustum");
+}
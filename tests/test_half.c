@@ -0,0 +1,225 @@
+#include "test.h"
+
+#define COUNT 200
+
+static uint32_t as_uint(float f)
+{
+	uint32_t u;
+	memcpy(&u, &f, sizeof(uint32_t));
+	return u;
+}
+
+static float as_float(uint32_t u)
+{
+	float f;
+	memcpy(&f, &u, sizeof(float));
+	return f;
+}
+
+//round to nearest even, overflowing to infinity, with NaNs quieted and keeping the top of their payload
+
+static QMhalf reference_float_to_half(float f)
+{
+	uint32_t x = as_uint(f);
+	uint32_t sign = (x >> 16) & 0x8000;
+	x &= 0x7FFFFFFF;
+
+	if(x >= 0x7F800000)
+		return (QMhalf)(sign | 0x7C00 | (x > 0x7F800000 ? 0x0200 | ((x >> 13) & 0x03FF) : 0));
+	if(x >= 0x477FF000)
+		return (QMhalf)(sign | 0x7C00);
+	if(x < 0x38800000)
+		return (QMhalf)(sign | (as_uint(as_float(x) + 0.5f) - 0x3F000000));
+
+	x += 0xC8000FFF + ((x >> 13) & 1);
+	return (QMhalf)(sign | (x >> 13));
+}
+
+//by value, every half is exactly representable as a float
+
+static float reference_half_to_float(QMhalf h)
+{
+	int exponent = (h >> 10) & 31;
+	int mantissa = h & 1023;
+	float sign = (h & 0x8000) ? -1.0f : 1.0f;
+
+	if(exponent == 31)
+	{
+		uint32_t u = ((uint32_t)(h & 0x8000) << 16) | 0x7F800000 | ((uint32_t)mantissa << 13);
+		return as_float(mantissa ? u | 0x00400000 : u);
+	}
+
+	if(exponent == 0)
+		return sign * ldexpf((float)mantissa, -24);
+
+	return sign * ldexpf((float)(mantissa | 1024), exponent - 25);
+}
+
+//a half survives the round trip through a float, except that signaling NaNs come back quieted
+
+static QMhalf round_trip(int h)
+{
+	return (QMhalf)(((h & 0x7C00) == 0x7C00 && (h & 0x03FF)) ? h | 0x0200 : h);
+}
+
+static void test_scalar(void)
+{
+	//every half
+	int failures = 0;
+	for(int i = 0; i < 65536 && failures < 8; i++)
+	{
+		float f = qm_half_to_float((QMhalf)i);
+		if(as_uint(f) != as_uint(reference_half_to_float((QMhalf)i)) || qm_float_to_half(f) != round_trip(i))
+		{
+			printf("half 0x%04x\n", i);
+			failures++;
+		}
+	}
+
+	//a sweep over every float exponent and a stride of mantissas
+	for(uint64_t u = 0; u < 0x100000000ull && failures < 8; u += 997)
+	{
+		float f = as_float((uint32_t)u);
+		if(qm_float_to_half(f) != reference_float_to_half(f))
+		{
+			printf("float 0x%08x\n", (unsigned)u);
+			failures++;
+		}
+	}
+
+	CHECK(failures == 0);
+
+	//every float around the overflow threshold and the smallest denormal's rounding point
+	for(uint32_t u = 0x477FE000; u < 0x47800100; u++)
+	{
+		CHECK(qm_float_to_half(as_float(u)) == reference_float_to_half(as_float(u)));
+		CHECK(qm_float_to_half(-as_float(u)) == reference_float_to_half(-as_float(u)));
+	}
+
+	for(uint32_t u = 0x33000000 - 64; u < 0x33000000 + 64; u++)
+		CHECK(qm_float_to_half(as_float(u)) == reference_float_to_half(as_float(u)));
+
+	CHECK(qm_float_to_half(1.0f) == 0x3C00 && qm_float_to_half(-0.0f) == 0x8000);
+	CHECK(qm_float_to_half(65504.0f) == 0x7BFF && qm_float_to_half(65520.0f) == 0x7C00);
+}
+
+//every array length up to COUNT against the reference on every tier, without writing past the end
+
+static void test_arrays(void)
+{
+	static float floats[COUNT + 1], unpacked[COUNT + 1];
+	static QMhalf halfs[COUNT + 1], randomHalfs[COUNT];
+	static QMhalf all[65536], back[65536];
+	static float allFloats[65536];
+
+	FOR_EACH_TIER(tier)
+	{
+		for(int n = 0; n <= COUNT; n += n < 40 ? 1 : 37)
+		{
+			//random bit patterns, including NaNs and infinities, and values around the half's range
+			for(int i = 0; i < n; i++)
+			{
+				uint32_t u = (uint32_t)rand() * 2654435761u ^ (uint32_t)rand();
+				float scale = i % 3 == 0 ? 70000.0f : i % 3 == 1 ? 1e-5f : 10.0f;
+				floats[i] = i % 5 == 0 ? as_float(u) : test_rand() * scale;
+				randomHalfs[i] = (QMhalf)(rand() ^ (rand() << 8));
+			}
+
+			memset(halfs, 0x5A, sizeof(halfs));
+			memset(unpacked, 0x5A, sizeof(unpacked));
+
+			qm_float_to_half_array(floats, halfs, n);
+			qm_half_to_float_array(randomHalfs, unpacked, n);
+			CHECK(halfs[n] == 0x5A5A && as_uint(unpacked[n]) == 0x5A5A5A5Au);
+
+			for(int i = 0; i < n; i++)
+			{
+				CHECK(halfs[i] == reference_float_to_half(floats[i]));
+				CHECK(as_uint(unpacked[i]) == as_uint(reference_half_to_float(randomHalfs[i])));
+			}
+		}
+
+		//every half through the array paths and back
+		for(int i = 0; i < 65536; i++)
+			all[i] = (QMhalf)i;
+
+		qm_half_to_float_array(all, allFloats, 65536);
+		qm_float_to_half_array(allFloats, back, 65536);
+
+		int failures = 0;
+		for(int i = 0; i < 65536; i++)
+			failures += as_uint(allFloats[i]) != as_uint(reference_half_to_float((QMhalf)i)) || back[i] != round_trip(i);
+
+		CHECK(failures == 0);
+	}
+}
+
+//the vector, quaternion and matrix loads and stores convert each component like the scalar functions
+
+static void test_types(void)
+{
+	QMhalf buffer[17];
+	float floats[16];
+	memset(buffer, 0x5A, sizeof(buffer));
+
+	QMvec2 v2 = {{ 1.5f, -2.25f }};
+	qm_vec2_store_half(v2, buffer);
+	QMvec2 r2 = qm_vec2_load_half(buffer);
+	CHECK(buffer[2] == 0x5A5A && r2.x == 1.5f && r2.y == -2.25f);
+
+	QMvec3 v3 = {{ 0.1f, 1000.0f, -7.0f }};
+	qm_vec3_store_half(v3, buffer);
+	QMvec3 r3 = qm_vec3_load_half(buffer);
+	CHECK(buffer[3] == 0x5A5A);
+	for(int k = 0; k < 3; k++)
+		CHECK(r3.v[k] == reference_half_to_float(reference_float_to_half(v3.v[k])));
+
+	QMvec4 v4 = {{ 0.1f, 1000.0f, -7.0f, 3e-6f }};
+	qm_vec4_store_half(v4, buffer);
+	QMvec4 r4 = qm_vec4_load_half(buffer);
+	CHECK(buffer[4] == 0x5A5A);
+	for(int k = 0; k < 4; k++)
+		CHECK(r4.v[k] == reference_half_to_float(reference_float_to_half(v4.v[k])));
+
+	QMquaternion q = test_rand_quaternion();
+	qm_quaternion_store_half(q, buffer);
+	QMquaternion rq = qm_quaternion_load_half(buffer);
+	CHECK(buffer[4] == 0x5A5A);
+	for(int k = 0; k < 4; k++)
+		CHECK(rq.q[k] == reference_half_to_float(reference_float_to_half(q.q[k])));
+
+	//matrices are stored column major like qm_mat_store
+	QMmat3 m3;
+	for(int k = 0; k < 9; k++)
+		m3.m[k / 3][k % 3] = test_rand() * 100.0f;
+
+	qm_mat3_store_half(m3, buffer);
+	qm_mat3_store(m3, floats);
+	CHECK(buffer[9] == 0x5A5A);
+	for(int k = 0; k < 9; k++)
+		CHECK(buffer[k] == reference_float_to_half(floats[k]));
+
+	QMmat3 rm3 = qm_mat3_load_half(buffer);
+	for(int k = 0; k < 9; k++)
+		CHECK(rm3.m[k / 3][k % 3] == reference_half_to_float(buffer[k]));
+
+	QMmat4 m4 = test_rand_trs(0);
+	qm_mat4_store_half(m4, buffer);
+	qm_mat4_store(m4, floats);
+	CHECK(buffer[16] == 0x5A5A);
+	for(int k = 0; k < 16; k++)
+		CHECK(buffer[k] == reference_float_to_half(floats[k]));
+
+	QMmat4 rm4 = qm_mat4_load_half(buffer);
+	for(int k = 0; k < 16; k++)
+		CHECK(rm4.m[k / 4][k % 4] == reference_half_to_float(buffer[k]));
+}
+
+int main(void)
+{
+	test_scalar();
+	test_arrays();
+	test_types();
+
+	return test_report("test_half");
+}
@@ -0,0 +1,104 @@
+#include "test.h"
+
+#define N 500
+
+static int parents[N], subtreeEnd[N], dirtyList[N];
+static QMbool dirty[N];
+static QMmat4 local[N], world[N];
+
+//world transforms recomputed from scratch, parents come first in depth-first order
+
+static void check_world(void)
+{
+	static QMmat4 expected[N];
+	for(int i = 0; i < N; i++)
+	{
+		expected[i] = parents[i] < 0 ? local[i] : qm_mat4_mult(expected[parents[i]], local[i]);
+		CHECK(test_mat4_near(world[i], expected[i], 1e-5f));
+	}
+}
+
+int main(void)
+{
+	//a random depth-first forest: each node's parent is the previous node or one of its ancestors
+	parents[0] = -1;
+	for(int i = 1; i < N; i++)
+	{
+		int parent = i - 1;
+		while(parent >= 0 && rand() % 3 == 0)
+			parent = parents[parent];
+
+		parents[i] = parent;
+	}
+
+	for(int i = 0; i < N; i++)
+		local[i] = test_rand_trs(0);
+
+	QMhierarchy h = { N, parents, local, world, subtreeEnd, dirty, dirtyList, 0 };
+	qm_hierarchy_init(&h);
+
+	//every subtree is the contiguous range of nodes descending from it
+	for(int i = 0; i < N; i++)
+	{
+		int end = i + 1;
+		while(end < N)
+		{
+			int ancestor = parents[end];
+			while(ancestor > i)
+				ancestor = parents[ancestor];
+
+			if(ancestor != i)
+				break;
+
+			end++;
+		}
+
+		CHECK(subtreeEnd[i] == end);
+	}
+
+	qm_hierarchy_update_all(&h);
+	check_world();
+
+	for(int iteration = 0; iteration < 50; iteration++)
+	{
+		//marking a node twice must only list it once
+		int changed = rand() % 20;
+		for(int j = 0; j < changed; j++)
+		{
+			int node = rand() % N;
+			local[node] = test_rand_trs(0);
+
+			qm_hierarchy_mark_dirty(&h, node);
+			if(rand() % 2)
+				qm_hierarchy_mark_dirty(&h, node);
+		}
+
+		CHECK(h.dirtyCount <= changed);
+
+		//nodes outside of every dirty subtree must not be written
+		QMmat4 untouched = world[0];
+		int clean = 1;
+		for(int j = 0; j < h.dirtyCount; j++)
+			if(dirtyList[j] == 0)
+				clean = 0;
+
+		if(clean)
+			world[0].m[0][0] = 12345.0f;
+
+		qm_hierarchy_update(&h);
+
+		if(clean)
+		{
+			CHECK(world[0].m[0][0] == 12345.0f);
+			world[0] = untouched;
+		}
+
+		CHECK(h.dirtyCount == 0);
+		for(int i = 0; i < N; i++)
+			CHECK(!dirty[i]);
+
+		check_world();
+	}
+
+	return test_report("test_hierarchy");
+}
@@ -0,0 +1,109 @@
+#include "test.h"
+
+#define MAX_PRIMS 100003
+
+static QMbbox3 prims[MAX_PRIMS];
+static QMbvhNode nodes[2 * MAX_PRIMS], sahNodes[2 * MAX_PRIMS];
+static uint32_t primIndices[MAX_PRIMS], sahIndices[MAX_PRIMS], scratch[3 * MAX_PRIMS];
+
+enum
+{
+	SCATTERED,
+	SAME_CENTROID,
+	FLAT
+};
+
+//interleaves the bits one at a time
+
+static uint32_t reference_morton(QMvec3 v)
+{
+	uint32_t q[3];
+	for(int a = 0; a < 3; a++)
+		q[a] = (uint32_t)(QM_MIN(QM_MAX(v.v[a], 0.0f), 1.0f) * 1023.0f);
+
+	uint32_t code = 0;
+	for(int bit = 0; bit < 10; bit++)
+		for(int a = 0; a < 3; a++)
+			code |= ((q[a] >> bit) & 1u) << (3 * bit + 2 - a);
+
+	return code;
+}
+
+static void test_build(int count, int layout)
+{
+	for(int i = 0; i < count; i++)
+	{
+		prims[i] = test_rand_bbox3(50.0f, 3.0f);
+
+		if(layout == SAME_CENTROID)
+		{
+			QMvec3 offset = qm_vec3_sub((QMvec3){{ 1.0f, 2.0f, 3.0f }}, qm_bbox3_centroid(prims[i]));
+			prims[i].min = qm_vec3_add(prims[i].min, offset);
+			prims[i].max = qm_vec3_add(prims[i].max, offset);
+		}
+		else if(layout == FLAT)
+			prims[i].min.y = prims[i].max.y = 0.0f;
+	}
+
+	uint32_t nodeCount = qm_bvh_build_lbvh(prims, count, nodes, primIndices, scratch);
+	CHECK(nodeCount == (uint32_t)(2 * count - 1));
+
+	//every leaf holds one primitive, and every node's bounds are exactly the union of what is below it
+	int depth;
+	CHECK(test_check_bvh(nodes, nodeCount, prims, primIndices, count, &depth) == 1);
+
+	for(uint32_t i = 0; i < nodeCount; i++)
+	{
+		QMbvhNode n = nodes[i];
+		QMbbox3 expected = n.count > 0 ? prims[primIndices[n.leftFirst]] : qm_bbox3_union(nodes[n.leftFirst].bounds, nodes[n.leftFirst + 1].bounds);
+		CHECK(test_bbox3_equal(n.bounds, expected));
+	}
+
+	//the primitives are sorted by the morton codes of their centroids within the centroids' bounds, ties in
+	//their original order
+	QMbbox3 centroids = qm_bbox3_initialized();
+	for(int i = 0; i < count; i++)
+		centroids = qm_bbox3_union_vec3(centroids, qm_bbox3_centroid(prims[i]));
+
+	for(int a = 0; a < 3; a++)
+		if(centroids.max.v[a] <= centroids.min.v[a])
+			centroids.max.v[a] = centroids.min.v[a] + 1.0f;
+
+	uint32_t previous = 0;
+	for(int i = 0; i < count; i++)
+	{
+		QMvec3 offset = qm_bbox3_offset(centroids, qm_bbox3_centroid(prims[primIndices[i]]));
+		uint32_t code = reference_morton(offset);
+		CHECK(qm_morton_code(offset) == code);
+
+		if(i > 0)
+		{
+			CHECK(code >= previous);
+			if(code == previous)
+				CHECK(primIndices[i] > primIndices[i - 1]);
+		}
+
+		previous = code;
+	}
+
+	//lower quality than the SAH builder, but not by much on evenly spread primitives
+	if(count == MAX_PRIMS)
+	{
+		qm_bvh_build(prims, count, sahNodes, sahIndices);
+		CHECK(qm_bvh_sah_cost(nodes) < qm_bvh_sah_cost(sahNodes) * 2.0f);
+	}
+}
+
+int main(void)
+{
+	int counts[] = { 1, 2, 3, 17, 1000, MAX_PRIMS };
+	for(int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+		test_build(counts[i], SCATTERED);
+
+	test_build(5000, SAME_CENTROID);
+	test_build(4000, FLAT);
+
+	CHECK(qm_bvh_build_lbvh(prims, 0, nodes, primIndices, scratch) == 0);
+
+	return test_report("test_lbvh");
+}
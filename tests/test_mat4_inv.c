@@ -0,0 +1,105 @@
+#include "test.h"
+
+//cofactor expansion in double precision
+
+static QMmat4 reference_inv(QMmat4 m)
+{
+	double a[16], inv[16];
+	for(int i = 0; i < 16; i++)
+		a[i] = m.m[i / 4][i % 4];
+
+	inv[0]  =  a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+	inv[4]  = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+	inv[8]  =  a[4] * a[9]  * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+	inv[12] = -a[4] * a[9]  * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+	inv[1]  = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+	inv[5]  =  a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+	inv[9]  = -a[0] * a[9]  * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+	inv[13] =  a[0] * a[9]  * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+	inv[2]  =  a[1] * a[6]  * a[15] - a[1] * a[7]  * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7]  - a[13] * a[3] * a[6];
+	inv[6]  = -a[0] * a[6]  * a[15] + a[0] * a[7]  * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7]  + a[12] * a[3] * a[6];
+	inv[10] =  a[0] * a[5]  * a[15] - a[0] * a[7]  * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7]  - a[12] * a[3] * a[5];
+	inv[14] = -a[0] * a[5]  * a[14] + a[0] * a[6]  * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6]  + a[12] * a[2] * a[5];
+	inv[3]  = -a[1] * a[6]  * a[11] + a[1] * a[7]  * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9]  * a[2] * a[7]  + a[9]  * a[3] * a[6];
+	inv[7]  =  a[0] * a[6]  * a[11] - a[0] * a[7]  * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8]  * a[2] * a[7]  - a[8]  * a[3] * a[6];
+	inv[11] = -a[0] * a[5]  * a[11] + a[0] * a[7]  * a[9]  + a[4] * a[1] * a[11] - a[4] * a[3] * a[9]  - a[8]  * a[1] * a[7]  + a[8]  * a[3] * a[5];
+	inv[15] =  a[0] * a[5]  * a[10] - a[0] * a[6]  * a[9]  - a[4] * a[1] * a[10] + a[4] * a[2] * a[9]  + a[8]  * a[1] * a[6]  - a[8]  * a[2] * a[5];
+
+	double det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+
+	QMmat4 result;
+	for(int i = 0; i < 16; i++)
+		result.m[i / 4][i % 4] = (float)(inv[i] / det);
+
+	return result;
+}
+
+static void test_general(void)
+{
+	for(int i = 0; i < 2000; i++)
+	{
+		QMmat4 m;
+		for(int j = 0; j < 16; j++)
+			m.m[j / 4][j % 4] = test_rand() * 4.0f;
+
+		//keep the matrices well conditioned by making them diagonally dominant
+		for(int j = 0; j < 4; j++)
+			m.m[j][j] += m.m[j][j] < 0.0f ? -10.0f : 10.0f;
+
+		QMmat4 inv = qm_mat4_inv(m);
+		CHECK(test_mat4_near(inv, reference_inv(m), 1e-5f));
+		CHECK(test_mat4_near(qm_mat4_mult(m, inv), qm_mat4_identity(), 1e-5f));
+	}
+}
+
+static void test_transforms(void)
+{
+	for(int i = 0; i < 1000; i++)
+	{
+		QMmat4 m = test_rand_trs(0);
+		CHECK(test_mat4_near(qm_mat4_inv(m), reference_inv(m), 1e-4f));
+		CHECK(test_mat4_near(qm_mat4_mult(m, qm_mat4_inv(m)), qm_mat4_identity(), 1e-4f));
+	}
+
+	//projection matrices are not affine, the bottom row is not (0, 0, 0, 1)
+	QMmat4 perspective = qm_mat4_perspective(70.0f, 1.5f, 0.1f, 100.0f);
+	CHECK(test_mat4_near(qm_mat4_inv(perspective), reference_inv(perspective), 1e-5f));
+
+	QMmat4 identity = qm_mat4_identity();
+	CHECK(test_mat4_near(qm_mat4_inv(identity), identity, 0.0f));
+}
+
+static void test_affine(void)
+{
+	for(int i = 0; i < 1000; i++)
+	{
+		QMmat4 trs = test_rand_trs(0);
+		QMmat4 rigid = test_rand_trs(1);
+
+		CHECK(test_mat4_near(qm_mat4_inv_affine(trs), reference_inv(trs), 1e-4f));
+		CHECK(test_mat4_near(qm_mat4_inv_affine(rigid), reference_inv(rigid), 1e-4f));
+		CHECK(test_mat4_near(qm_mat4_inv_rigid(rigid), reference_inv(rigid), 1e-4f));
+
+		//the results stay affine
+		QMmat4 inv = qm_mat4_inv_affine(trs);
+		CHECK(inv.m[0][3] == 0.0f && inv.m[1][3] == 0.0f && inv.m[2][3] == 0.0f && inv.m[3][3] == 1.0f);
+	}
+
+	//view matrices are rigid
+	QMvec3 pos = {{ 1.0f, 2.0f, 3.0f }};
+	QMvec3 dir = {{ 0.0f, 0.0f, -1.0f }};
+	QMvec3 up  = {{ 0.0f, 1.0f, 0.0f }};
+
+	QMmat4 view = qm_mat4_look(pos, dir, up);
+	CHECK(test_mat4_near(qm_mat4_inv_rigid(view), reference_inv(view), 1e-5f));
+	CHECK(test_mat4_near(qm_mat4_inv_affine(view), reference_inv(view), 1e-5f));
+}
+
+int main(void)
+{
+	test_general();
+	test_transforms();
+	test_affine();
+
+	return test_report("test_mat4_inv");
+}
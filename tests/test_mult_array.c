@@ -0,0 +1,80 @@
+#include "test.h"
+
+#define MAX_COUNT 21
+
+//the batched matrix products against qm_mat4_mult, at every length below and past QM_PREFETCH_DISTANCE
+
+static void test_lengths(void)
+{
+	QMmat4 shared = test_rand_trs(0);
+	shared.m[1][3] = 0.25f;
+
+	QMmat4 a[MAX_COUNT], b[MAX_COUNT];
+	for(int i = 0; i < MAX_COUNT; i++)
+	{
+		a[i] = test_rand_trs(0);
+		a[i].m[0][3] = test_rand();
+		b[i] = test_rand_trs(1);
+	}
+
+	for(int n = 0; n < MAX_COUNT; n++)
+	{
+		QMmat4 out[MAX_COUNT], pairwise[MAX_COUNT];
+		out[n].m[0][0] = pairwise[n].m[0][0] = 12345.0f;
+
+		qm_mat4_mult_array(shared, a, out, n);
+		qm_mat4_mult_array_pairwise(a, b, pairwise, n);
+
+		for(int i = 0; i < n; i++)
+		{
+			CHECK(test_mat4_near(out[i], qm_mat4_mult(shared, a[i]), 1e-5f));
+			CHECK(test_mat4_near(pairwise[i], qm_mat4_mult(a[i], b[i]), 1e-5f));
+		}
+
+		//nothing past the end is written
+		CHECK(out[n].m[0][0] == 12345.0f && pairwise[n].m[0][0] == 12345.0f);
+	}
+}
+
+static void test_in_place(void)
+{
+	QMmat4 shared = test_rand_trs(0);
+
+	QMmat4 a[MAX_COUNT], b[MAX_COUNT], expected[MAX_COUNT], out[MAX_COUNT];
+	for(int i = 0; i < MAX_COUNT; i++)
+	{
+		a[i] = test_rand_trs(0);
+		b[i] = test_rand_trs(1);
+		expected[i] = qm_mat4_mult(a[i], b[i]);
+	}
+
+	//out aliasing either input of the pairwise product
+	memcpy(out, a, sizeof(a));
+	qm_mat4_mult_array_pairwise(out, b, out, MAX_COUNT);
+	for(int i = 0; i < MAX_COUNT; i++)
+		CHECK(test_mat4_near(out[i], expected[i], 1e-5f));
+
+	memcpy(out, b, sizeof(b));
+	qm_mat4_mult_array_pairwise(a, out, out, MAX_COUNT);
+	for(int i = 0; i < MAX_COUNT; i++)
+		CHECK(test_mat4_near(out[i], expected[i], 1e-5f));
+
+	memcpy(out, a, sizeof(a));
+	qm_mat4_mult_array(shared, out, out, MAX_COUNT);
+	for(int i = 0; i < MAX_COUNT; i++)
+		CHECK(test_mat4_near(out[i], qm_mat4_mult(shared, a[i]), 1e-5f));
+}
+
+int main(void)
+{
+	FOR_EACH_TIER(tier)
+	{
+		for(int i = 0; i < 20; i++)
+		{
+			test_lengths();
+			test_in_place();
+		}
+	}
+
+	return test_report("test_mult_array");
+}
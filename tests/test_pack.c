@@ -0,0 +1,232 @@
+#include "test.h"
+
+#define COUNT 211
+#define ROUND_TRIPS 2000000
+
+//the array kernels match the scalar functions bit for bit, unless the compiler contracts the scalar ones into fused
+//multiply-adds
+
+#ifdef __FMA__
+	#define TEST_EXACT 0
+#else
+	#define TEST_EXACT 1
+#endif
+
+//the angle between two vectors in degrees, from atan2 of the cross and dot products in double. acosf of the dot
+//product cannot resolve angles below about 0.02 degrees, a float dot product 1 ulp below 1 already reads as that
+
+static double angle_degrees(QMvec3 a, QMvec3 b)
+{
+	double cx = (double)a.y * b.z - (double)a.z * b.y;
+	double cy = (double)a.z * b.x - (double)a.x * b.z;
+	double cz = (double)a.x * b.y - (double)a.y * b.x;
+	double dot = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+
+	return atan2(sqrt(cx * cx + cy * cy + cz * cz), dot) * 57.29577951308232;
+}
+
+//the largest error of the 3 kept components and of the dropped one, q and -q being the same rotation
+
+static void quaternion_error(QMquaternion q, QMquaternion unpacked, float* kept, float* dropped)
+{
+	float sign = qm_quaternion_dot(q, unpacked) < 0.0f ? -1.0f : 1.0f;
+
+	int largest = 0;
+	for(int i = 1; i < 4; i++)
+		if(fabsf(q.q[i]) > fabsf(q.q[largest]))
+			largest = i;
+
+	for(int i = 0; i < 4; i++)
+	{
+		float e = fabsf(q.q[i] * sign - unpacked.q[i]);
+		if(i == largest)
+			*dropped = QM_MAX(*dropped, e);
+		else
+			*kept = QM_MAX(*kept, e);
+	}
+}
+
+//the documented bounds, over many random values with some components near 0
+
+static void test_bounds(void)
+{
+	float kept32 = 0.0f, dropped32 = 0.0f, kept48 = 0.0f, dropped48 = 0.0f;
+	double octAngle = 0.0;
+
+	for(int i = 0; i < ROUND_TRIPS; i++)
+	{
+		QMquaternion q = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		if(i % 4 == 0)
+			q.q[i % 3] *= 1e-3f;
+		q = qm_quaternion_normalize(q);
+
+		quaternion_error(q, qm_quaternion_unpack32(qm_quaternion_pack32(q)), &kept32, &dropped32);
+		quaternion_error(q, qm_quaternion_unpack48(qm_quaternion_pack48(q)), &kept48, &dropped48);
+
+		QMvec3 v = test_rand_vec3(1.0f);
+		if(i % 5 == 0)
+			v.z *= 1e-4f;
+		v = qm_vec3_normalize(v);
+
+		octAngle = fmax(octAngle, angle_degrees(v, qm_vec3_unpack_oct(qm_vec3_pack_oct(v))));
+	}
+
+	CHECK(kept32 <= 0.0007f && dropped32 <= 0.0021f);
+	CHECK(kept48 <= 0.000022f && dropped48 <= 0.000065f);
+	//measured through angle_degrees, acosf would report 0.02 degrees or more for these
+	CHECK(octAngle <= 0.0038);
+
+	//close to the bounds, so they are not loose
+	CHECK(kept32 > 0.0006f && kept48 > 0.00002f && octAngle > 0.0035);
+
+	//positions are within half a step of the box's extent per axis, plus the rounding of the unpacked float
+	QMbbox3 b = {{{ -3.0f, 1.0f, -100.0f }}, {{ 5.0f, 9.0f, 250.0f }}};
+	for(int i = 0; i < ROUND_TRIPS / 10; i++)
+	{
+		QMvec3 p = qm_bbox3_centroid(b);
+		p = qm_vec3_add(p, qm_vec3_mult(qm_vec3_scale(qm_bbox3_extent(b), 0.5f), test_rand_vec3(1.0f)));
+
+		QMvec3 unpacked = qm_vec3_unpack16(b, qm_vec3_pack16(b, p));
+		for(int a = 0; a < 3; a++)
+			CHECK(fabsf(unpacked.v[a] - p.v[a]) / (b.max.v[a] - b.min.v[a]) <= 1.0f / 131070.0f + 1e-6f);
+	}
+}
+
+static void test_exact_values(void)
+{
+	//the identity and the axes survive exactly
+	QMquaternion identity = {{ 0.0f, 0.0f, 0.0f, 1.0f }};
+	QMquaternion unpacked32 = qm_quaternion_unpack32(qm_quaternion_pack32(identity));
+	QMquaternion unpacked48 = qm_quaternion_unpack48(qm_quaternion_pack48(identity));
+	CHECK(memcmp(&unpacked32, &identity, sizeof(QMquaternion)) == 0);
+	CHECK(memcmp(&unpacked48, &identity, sizeof(QMquaternion)) == 0);
+
+	//q and -q pack the same
+	QMquaternion q = test_rand_quaternion();
+	CHECK(qm_quaternion_pack32(q) == qm_quaternion_pack32(qm_quaternion_scale(q, -1.0f)));
+
+	QMvec3 axes[6] = {
+		{{ 1.0f, 0.0f, 0.0f }}, {{ -1.0f, 0.0f, 0.0f }},
+		{{ 0.0f, 1.0f, 0.0f }}, {{ 0.0f, -1.0f, 0.0f }},
+		{{ 0.0f, 0.0f, 1.0f }}, {{ 0.0f, 0.0f, -1.0f }}
+	};
+
+	for(int i = 0; i < 6; i++)
+	{
+		QMvec3 unpacked = qm_vec3_unpack_oct(qm_vec3_pack_oct(axes[i]));
+		CHECK(test_vec3_near(unpacked, axes[i], 0.0f));
+	}
+
+	//positions outside the box are clamped to it, and an empty axis gives its one value back
+	QMbbox3 b = {{{ -3.0f, 1.0f, -100.0f }}, {{ 5.0f, 1.0f, 250.0f }}};
+	QMvec3 outside = {{ 9.0f, 4.0f, -300.0f }};
+	QMvec3 clamped = qm_vec3_unpack16(b, qm_vec3_pack16(b, outside));
+	CHECK(clamped.x == 5.0f && clamped.y == 1.0f && clamped.z == -100.0f);
+}
+
+//every array length up to COUNT against the scalar functions on every tier, without writing past the end
+
+static void test_arrays(void)
+{
+	static QMquaternion quaternions[COUNT], unpackedQuaternions[COUNT + 1];
+	static QMvec3 positions[COUNT], directions[COUNT], unpackedVectors[COUNT + 1];
+	static uint32_t packed32[COUNT + 1], packedOct[COUNT + 1];
+	static QMquaternion48 packed48[COUNT + 1];
+	static QMvec3u16 packed16[COUNT + 1];
+
+	QMbbox3 b = {{{ -3.0f, 1.0f, -100.0f }}, {{ 5.0f, 1.0f, 250.0f }}};
+	for(int i = 0; i < COUNT; i++)
+	{
+		quaternions[i] = test_rand_quaternion();
+		directions[i] = qm_vec3_normalize(test_rand_vec3(1.0f));
+		positions[i] = (QMvec3){{ test_rand() * 4.0f + 1.0f, 1.0f, test_rand() * 175.0f + 75.0f }};
+
+		if(i % 17 == 0)
+			positions[i].x = 9.0f;
+		if(i % 19 == 0)
+			positions[i].z = -300.0f;
+	}
+
+	FOR_EACH_TIER(tier)
+	{
+		for(int n = 0; n <= COUNT; n += n < 12 ? 1 : 50)
+		{
+			memset(packed32, 0x5A, sizeof(packed32));
+			memset(packed48, 0x5A, sizeof(packed48));
+			memset(packed16, 0x5A, sizeof(packed16));
+			memset(packedOct, 0x5A, sizeof(packedOct));
+
+			qm_quaternion_pack32_array(quaternions, packed32, n);
+			qm_quaternion_pack48_array(quaternions, packed48, n);
+			qm_vec3_pack16_array(b, positions, packed16, n);
+			qm_vec3_pack_oct_array(directions, packedOct, n);
+
+			CHECK(packed32[n] == 0x5A5A5A5Au && packed48[n].v[0] == 0x5A5A && packed16[n].v[0] == 0x5A5A && packedOct[n] == 0x5A5A5A5Au);
+
+			for(int i = 0; i < n; i++)
+			{
+				QMquaternion48 single48 = qm_quaternion_pack48(quaternions[i]);
+				QMvec3u16 single16 = qm_vec3_pack16(b, positions[i]);
+
+				//the top bit of a packed 48-bit quaternion is unused
+				CHECK((packed48[i].v[2] >> 15) == 0);
+
+				if(TEST_EXACT)
+				{
+					CHECK(packed32[i] == qm_quaternion_pack32(quaternions[i]));
+					CHECK(memcmp(&packed48[i], &single48, sizeof(QMquaternion48)) == 0);
+					CHECK(memcmp(&packed16[i], &single16, sizeof(QMvec3u16)) == 0);
+					CHECK(packedOct[i] == qm_vec3_pack_oct(directions[i]));
+				}
+			}
+
+			memset(unpackedQuaternions, 0x5A, sizeof(unpackedQuaternions));
+			qm_quaternion_unpack32_array(packed32, unpackedQuaternions, n);
+			CHECK(memcmp(&unpackedQuaternions[n].x, "\x5A\x5A\x5A\x5A", 4) == 0);
+			for(int i = 0; i < n; i++)
+			{
+				QMquaternion single = qm_quaternion_unpack32(packed32[i]);
+				CHECK(TEST_EXACT ? memcmp(&unpackedQuaternions[i], &single, sizeof(QMquaternion)) == 0 :
+				                   test_near(unpackedQuaternions[i].x, single.x, 1e-5f));
+			}
+
+			qm_quaternion_unpack48_array(packed48, unpackedQuaternions, n);
+			for(int i = 0; i < n; i++)
+			{
+				QMquaternion single = qm_quaternion_unpack48(packed48[i]);
+				CHECK(TEST_EXACT ? memcmp(&unpackedQuaternions[i], &single, sizeof(QMquaternion)) == 0 :
+				                   test_near(unpackedQuaternions[i].x, single.x, 1e-5f));
+			}
+
+			memset(unpackedVectors, 0x5A, sizeof(unpackedVectors));
+			qm_vec3_unpack16_array(b, packed16, unpackedVectors, n);
+			CHECK(memcmp(&unpackedVectors[n].x, "\x5A\x5A\x5A\x5A", 4) == 0);
+			for(int i = 0; i < n; i++)
+			{
+				QMvec3 single = qm_vec3_unpack16(b, packed16[i]);
+				CHECK(TEST_EXACT ? memcmp(&unpackedVectors[i], &single, sizeof(QMvec3)) == 0 :
+				                   test_vec3_near(unpackedVectors[i], single, 1e-5f));
+			}
+
+			qm_vec3_unpack_oct_array(packedOct, unpackedVectors, n);
+			for(int i = 0; i < n; i++)
+			{
+				QMvec3 single = qm_vec3_unpack_oct(packedOct[i]);
+				CHECK(TEST_EXACT ? memcmp(&unpackedVectors[i], &single, sizeof(QMvec3)) == 0 :
+				                   test_vec3_near(unpackedVectors[i], single, 1e-5f));
+
+				CHECK(angle_degrees(unpackedVectors[i], directions[i]) <= 0.0038);
+				CHECK(test_near(qm_vec3_length(unpackedVectors[i]), 1.0f, 1e-6f));
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	test_bounds();
+	test_exact_values();
+	test_arrays();
+
+	return test_report("test_pack");
+}
@@ -0,0 +1,185 @@
+#include "test.h"
+
+//small integers and signed zeros, so rays often start on or run inside the planes of the boxes
+
+static float coarse(void)
+{
+	int k = rand() % 8;
+	return k == 0 ? 0.0f : k == 1 ? -0.0f : (float)(rand() % 9 - 4);
+}
+
+static QMvec3 coarse_vec3(void)
+{
+	QMvec3 result;
+	result.x = coarse();
+	result.y = coarse();
+	result.z = coarse();
+
+	return result;
+}
+
+//clips [0, tMax] in double precision. returns -1 when the answer depends on how a ray lying in a slab's plane is
+//treated, or when the hit is too close to grazing for float rounding to agree
+
+static int reference_hit(QMvec3 o, QMvec3 d, QMbbox3 b, float tMax)
+{
+	double tNear = 0.0, tFar = tMax;
+	for(int a = 0; a < 3; a++)
+	{
+		if(d.v[a] == 0.0f)
+		{
+			if(o.v[a] == b.min.v[a] || o.v[a] == b.max.v[a])
+				return -1;
+			if(o.v[a] < b.min.v[a] || o.v[a] > b.max.v[a])
+				return 0;
+
+			continue;
+		}
+
+		double t0 = ((double)b.min.v[a] - o.v[a]) / d.v[a];
+		double t1 = ((double)b.max.v[a] - o.v[a]) / d.v[a];
+		tNear = fmax(tNear, fmin(t0, t1));
+		tFar = fmin(tFar, fmax(t0, t1));
+	}
+
+	if(fabs(tFar - tNear) < 1e-4 * (1.0 + fabs(tNear)))
+		return -1;
+
+	return tNear <= tFar;
+}
+
+static int same_bits(float a, float b)
+{
+	return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void test_random(int coarseValues)
+{
+	QMbbox3 boxes[8];
+	QMvec3 origins[8], dirs[8];
+	for(int i = 0; i < 8; i++)
+	{
+		if(coarseValues)
+		{
+			QMvec3 a = coarse_vec3(), b = coarse_vec3();
+			boxes[i].min = qm_vec3_min(a, b);
+			boxes[i].max = qm_vec3_max(a, b);
+			origins[i] = coarse_vec3();
+			dirs[i] = coarse_vec3();
+		}
+		else
+		{
+			boxes[i] = test_rand_bbox3(4.0f, 2.0f);
+			origins[i] = test_rand_vec3(5.0f);
+			dirs[i] = test_rand_vec3(1.0f);
+		}
+	}
+
+	float tMax = rand() % 3 ? 1e30f : 3.0f;
+
+	//one ray against 4 and 8 boxes matches the single box test bit for bit
+	QMray r = qm_ray_create(origins[0], dirs[0]);
+
+	QMvec4 near4, far4;
+	QMvec8 near8, far8;
+	int mask4 = qm_ray_intersect_bbox3x4(r, qm_bbox3x4_load(boxes), tMax, &near4, &far4);
+	int mask8 = qm_ray_intersect_bbox3x8(r, qm_bbox3x8_load(boxes), tMax, &near8, &far8);
+
+	for(int i = 0; i < 8; i++)
+	{
+		float tNear, tFar;
+		QMbool hit = qm_ray_intersect_bbox3(r, boxes[i], tMax, &tNear, &tFar);
+
+		if(i < 4)
+		{
+			CHECK(((mask4 >> i) & 1) == hit);
+			CHECK(same_bits(tNear, near4.v[i]) && same_bits(tFar, far4.v[i]));
+		}
+
+		CHECK(((mask8 >> i) & 1) == hit);
+		CHECK(same_bits(tNear, near8.v[i]) && same_bits(tFar, far8.v[i]));
+
+		int expected = reference_hit(origins[0], dirs[0], boxes[i], tMax);
+		if(expected >= 0)
+			CHECK(hit == expected);
+
+		//the middle of a finite hit interval is inside the box
+		if(hit && tFar < 1e29f)
+		{
+			float t = (tNear + tFar) * 0.5f;
+			for(int a = 0; a < 3; a++)
+			{
+				float p = origins[0].v[a] + dirs[0].v[a] * t;
+				float eps = 1e-3f * (1.0f + fabsf(p));
+				CHECK(p >= boxes[i].min.v[a] - eps && p <= boxes[i].max.v[a] + eps);
+			}
+		}
+	}
+
+	//4 and 8 rays against one box, each with its own tMax
+	QMrayx4 r4 = qm_rayx4_create(qm_vec3x4_load(origins), qm_vec3x4_load(dirs));
+	QMrayx8 r8 = qm_rayx8_create(qm_vec3x8_load(origins), qm_vec3x8_load(dirs));
+
+	QMvec4 tMax4;
+	QMvec8 tMax8;
+	for(int i = 0; i < 8; i++)
+	{
+		tMax8.v[i] = (i & 1) ? 2.0f : 1e30f;
+		if(i < 4)
+			tMax4.v[i] = tMax8.v[i];
+	}
+
+	mask4 = qm_rayx4_intersect_bbox3(r4, boxes[1], tMax4, &near4, &far4);
+	mask8 = qm_rayx8_intersect_bbox3(r8, boxes[1], tMax8, &near8, &far8);
+
+	for(int i = 0; i < 8; i++)
+	{
+		float tNear, tFar;
+		QMbool hit = qm_ray_intersect_bbox3(qm_ray_create(origins[i], dirs[i]), boxes[1], tMax8.v[i], &tNear, &tFar);
+
+		if(i < 4)
+		{
+			CHECK(((mask4 >> i) & 1) == hit);
+			CHECK(same_bits(tNear, near4.v[i]) && same_bits(tFar, far4.v[i]));
+		}
+
+		CHECK(((mask8 >> i) & 1) == hit);
+		CHECK(same_bits(tNear, near8.v[i]) && same_bits(tFar, far8.v[i]));
+	}
+}
+
+static void test_edge_cases(void)
+{
+	QMbbox3 b = {{{ -1.0f, -1.0f, -1.0f }}, {{ 1.0f, 1.0f, 1.0f }}};
+	float tNear, tFar;
+
+	//straight through, pointing away, passing beside, and stopping short
+	CHECK(qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 0.0f, 0.0f }}, (QMvec3){{ 1.0f, 0.0f, 0.0f }}), b, 1e30f, &tNear, &tFar));
+	CHECK(tNear == 4.0f && tFar == 6.0f);
+	CHECK(!qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 0.0f, 0.0f }}, (QMvec3){{ -1.0f, 0.0f, 0.0f }}), b, 1e30f, &tNear, &tFar));
+	CHECK(!qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 2.0f, 0.0f }}, (QMvec3){{ 1.0f, 0.0f, 0.0f }}), b, 1e30f, &tNear, &tFar));
+	CHECK(!qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 0.0f, 0.0f }}, (QMvec3){{ 1.0f, 0.0f, 0.0f }}), b, 3.0f, &tNear, &tFar));
+
+	//starting inside clips the interval at 0
+	CHECK(qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ 0.0f, 0.0f, 0.0f }}, (QMvec3){{ 0.0f, 0.0f, 1.0f }}), b, 1e30f, &tNear, &tFar));
+	CHECK(tNear == 0.0f && tFar == 1.0f);
+
+	//axis aligned rays outside the box on a zero direction axis never hit, whatever the sign of the zero
+	CHECK(!qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 3.0f, 0.0f }}, (QMvec3){{ 1.0f, 0.0f, 0.0f }}), b, 1e30f, &tNear, &tFar));
+	CHECK(!qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ -5.0f, 3.0f, 0.0f }}, (QMvec3){{ 1.0f, -0.0f, 0.0f }}), b, 1e30f, &tNear, &tFar));
+
+	//a flat box is still hit head on
+	QMbbox3 flat = {{{ -1.0f, 0.0f, -1.0f }}, {{ 1.0f, 0.0f, 1.0f }}};
+	CHECK(qm_ray_intersect_bbox3(qm_ray_create((QMvec3){{ 0.5f, 4.0f, 0.5f }}, (QMvec3){{ 0.0f, -1.0f, 0.0f }}), flat, 1e30f, &tNear, &tFar));
+	CHECK(tNear == 4.0f && tFar == 4.0f);
+}
+
+int main(void)
+{
+	for(int i = 0; i < 20000; i++)
+		test_random(i & 1);
+
+	test_edge_cases();
+
+	return test_report("test_ray");
+}
@@ -0,0 +1,115 @@
+#include "test.h"
+
+#define MAX_PRIMS 50000
+
+static QMbbox3 prims[MAX_PRIMS];
+static QMvec3 velocities[MAX_PRIMS];
+static QMbvhNode nodes[2 * MAX_PRIMS];
+static uint32_t primIndices[MAX_PRIMS], parents[2 * MAX_PRIMS], primLeaves[MAX_PRIMS], dirtyList[2 * MAX_PRIMS];
+static uint8_t heights[2 * MAX_PRIMS];
+static QMbool dirty[2 * MAX_PRIMS];
+
+//every node's bounds are exactly the union below it and the bookkeeping matches the tree
+
+static void check_refit(const QMbvhRefit* r, int count)
+{
+	int depth;
+	test_check_bvh(r->nodes, r->nodeCount, r->prims, r->primIndices, count, &depth);
+
+	CHECK(r->dirtyCount == 0);
+	for(uint32_t i = 0; i < r->nodeCount; i++)
+	{
+		QMbvhNode n = r->nodes[i];
+		CHECK(!r->dirty[i]);
+
+		if(n.count > 0)
+		{
+			QMbbox3 bounds = qm_bbox3_initialized();
+			for(uint32_t j = n.leftFirst; j < n.leftFirst + n.count; j++)
+			{
+				bounds = qm_bbox3_union(bounds, r->prims[r->primIndices[j]]);
+				CHECK(r->primLeaves[r->primIndices[j]] == i);
+			}
+
+			CHECK(test_bbox3_equal(n.bounds, bounds));
+			CHECK(r->heights[i] == 0);
+		}
+		else
+		{
+			CHECK(test_bbox3_equal(n.bounds, qm_bbox3_union(r->nodes[n.leftFirst].bounds, r->nodes[n.leftFirst + 1].bounds)));
+			CHECK(r->heights[i] == 1 + QM_MAX(r->heights[n.leftFirst], r->heights[n.leftFirst + 1]));
+			CHECK(r->parents[n.leftFirst] == i && r->parents[n.leftFirst + 1] == i);
+		}
+	}
+
+	//the running cost matches one summed from scratch
+	float cost = qm_bvh_sah_cost(r->nodes);
+	CHECK(test_near(r->areaSum / qm_bbox3_surface_area(r->nodes[0].bounds), cost, 1e-3f));
+}
+
+//returns the sah cost drift after the primitives have moved
+
+static float test_refit(int count, QMbool rotate)
+{
+	for(int i = 0; i < count; i++)
+	{
+		prims[i] = test_rand_bbox3(50.0f, 1.0f);
+		velocities[i] = test_rand_vec3(1.0f);
+	}
+
+	QMbvhRefit r;
+	r.nodes = nodes;
+	r.nodeCount = qm_bvh_build(prims, count, nodes, primIndices);
+	r.prims = prims;
+	r.primIndices = primIndices;
+	r.parents = parents;
+	r.heights = heights;
+	r.primLeaves = primLeaves;
+	r.dirty = dirty;
+	r.dirtyList = dirtyList;
+
+	qm_bvh_refit_init(&r);
+	check_refit(&r, count);
+	CHECK(test_near(qm_bvh_refit_cost_drift(&r), 1.0f, 1e-5f));
+
+	//a quarter of the primitives move each frame, and all of them every 20 frames
+	for(int frame = 0; frame < 60; frame++)
+	{
+		for(int i = 0; i < count; i++)
+		{
+			if(rand() % 4 != 0 && frame % 20 != 0)
+				continue;
+
+			prims[i].min = qm_vec3_add(prims[i].min, velocities[i]);
+			prims[i].max = qm_vec3_add(prims[i].max, velocities[i]);
+			qm_bvh_refit_mark_dirty(&r, i);
+		}
+
+		qm_bvh_refit(&r, rotate);
+		if(frame % 10 == 9)
+			check_refit(&r, count);
+	}
+
+	float drift = qm_bvh_refit_cost_drift(&r);
+	CHECK(drift > 0.0f && drift < 1e6f);
+
+	return drift;
+}
+
+int main(void)
+{
+	int counts[] = { 1, 2, 9, 1000, MAX_PRIMS };
+	for(int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+	{
+		//the same motion with and without rotations, which must not leave a worse tree
+		srand(42 + i);
+		float drift = test_refit(counts[i], 0);
+		srand(42 + i);
+		float rotatedDrift = test_refit(counts[i], 1);
+
+		if(counts[i] >= 1000)
+			CHECK(rotatedDrift <= drift);
+	}
+
+	return test_report("test_refit");
+}
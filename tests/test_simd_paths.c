@@ -0,0 +1,83 @@
+#include "test.h"
+
+//the SIMD paths (SSE3, AVX2/FMA, AVX-512) of the core operations against plain scalar formulas. built in every
+//configuration by run_tests.sh, so each path is compared against the same expectations
+
+static void test_mat4(void)
+{
+	QMmat4 a, b;
+	for(int i = 0; i < 16; i++)
+	{
+		a.m[i / 4][i % 4] = test_rand();
+		b.m[i / 4][i % 4] = test_rand();
+	}
+
+	QMmat4 product = qm_mat4_mult(a, b);
+	for(int col = 0; col < 4; col++)
+		for(int row = 0; row < 4; row++)
+		{
+			float expected = 0.0f;
+			for(int k = 0; k < 4; k++)
+				expected += a.m[k][row] * b.m[col][k];
+
+			CHECK(test_near(product.m[col][row], expected, 1e-6f));
+		}
+
+	QMvec4 v = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	QMvec4 transformed = qm_mat4_mult_vec4(a, v);
+	for(int row = 0; row < 4; row++)
+	{
+		float expected = 0.0f;
+		for(int k = 0; k < 4; k++)
+			expected += a.m[k][row] * v.v[k];
+
+		CHECK(test_near(transformed.v[row], expected, 1e-6f));
+	}
+}
+
+static void test_dot(void)
+{
+	QMvec4 v = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	QMvec4 w = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	CHECK(test_near(qm_vec4_dot(v, w), v.x * w.x + v.y * w.y + v.z * w.z + v.w * w.w, 1e-6f));
+
+	QMquaternion q1 = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	QMquaternion q2 = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	CHECK(test_near(qm_quaternion_dot(q1, q2), q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w, 1e-6f));
+}
+
+static void test_quaternion(void)
+{
+	QMquaternion q1 = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	QMquaternion q2 = {{ test_rand(), test_rand(), test_rand(), test_rand() }};
+
+	QMquaternion product = qm_quaternion_mult(q1, q2);
+	CHECK(test_near(product.x, q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y, 1e-6f));
+	CHECK(test_near(product.y, q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x, 1e-6f));
+	CHECK(test_near(product.z, q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w, 1e-6f));
+	CHECK(test_near(product.w, q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z, 1e-6f));
+
+	//angles are in degrees, the quaternion uses the half angles
+	QMvec3 angles = test_rand_vec3(180.0f);
+	float sx = sinf(qm_deg_to_rad(angles.x * 0.5f)), cx = cosf(qm_deg_to_rad(angles.x * 0.5f));
+	float sy = sinf(qm_deg_to_rad(angles.y * 0.5f)), cy = cosf(qm_deg_to_rad(angles.y * 0.5f));
+	float sz = sinf(qm_deg_to_rad(angles.z * 0.5f)), cz = cosf(qm_deg_to_rad(angles.z * 0.5f));
+
+	QMquaternion euler = qm_quaternion_from_euler(angles);
+	CHECK(test_near(euler.x, sx * cy * cz - cx * sy * sz, 1e-5f));
+	CHECK(test_near(euler.y, cx * sy * cz + sx * cy * sz, 1e-5f));
+	CHECK(test_near(euler.z, cx * cy * sz - sx * sy * cz, 1e-5f));
+	CHECK(test_near(euler.w, cx * cy * cz + sx * sy * sz, 1e-5f));
+}
+
+int main(void)
+{
+	for(int i = 0; i < 1000; i++)
+	{
+		test_mat4();
+		test_dot();
+		test_quaternion();
+	}
+
+	return test_report("test_simd_paths");
+}
@@ -0,0 +1,95 @@
+#include "test.h"
+
+#define MAX_COUNT 48
+#define SENTINEL 12345.0f
+
+static QMmat4 rand_matrix(void)
+{
+	//a non-affine bottom row so the w terms are exercised
+	QMmat4 result = test_rand_trs(0);
+	result.m[0][3] = 0.3f;
+	result.m[3][3] = 1.2f;
+
+	return result;
+}
+
+static void test_lengths(void)
+{
+	QMmat4 m = rand_matrix();
+
+	QMvec3 in3[MAX_COUNT];
+	QMvec4 in4[MAX_COUNT];
+	for(int i = 0; i < MAX_COUNT; i++)
+	{
+		in3[i] = test_rand_vec3(4.0f);
+		in4[i] = (QMvec4){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+	}
+
+	//every length up to several times the widest kernel, so each tail size is hit
+	for(int n = 0; n <= MAX_COUNT - 1; n++)
+	{
+		QMvec3 out3[MAX_COUNT], outDir[MAX_COUNT];
+		QMvec4 out4[MAX_COUNT];
+		out3[n].x = outDir[n].x = out4[n].x = SENTINEL;
+
+		qm_mat4_transform_vec3_array(m, in3, out3, n);
+		qm_mat4_transform_vec3_dir_array(m, in3, outDir, n);
+		qm_mat4_mult_vec4_array(m, in4, out4, n);
+
+		for(int i = 0; i < n; i++)
+		{
+			QMvec3 expected = qm_mat4_transform_vec3(m, in3[i]);
+			CHECK(test_vec3_near(out3[i], expected, 1e-5f));
+
+			QMvec4 dir = qm_mat4_mult_vec4(m, (QMvec4){{ in3[i].x, in3[i].y, in3[i].z, 0.0f }});
+			CHECK(test_near(outDir[i].x, dir.x, 1e-5f) && test_near(outDir[i].y, dir.y, 1e-5f) && test_near(outDir[i].z, dir.z, 1e-5f));
+
+			QMvec4 expected4 = qm_mat4_mult_vec4(m, in4[i]);
+			for(int j = 0; j < 4; j++)
+				CHECK(test_near(out4[i].v[j], expected4.v[j], 1e-5f));
+		}
+
+		//nothing past the end is written
+		CHECK(out3[n].x == SENTINEL && outDir[n].x == SENTINEL && out4[n].x == SENTINEL);
+	}
+}
+
+static void test_in_place(void)
+{
+	enum { N = 37 };
+	QMmat4 m = rand_matrix();
+
+	QMvec3 v[N], expected[N];
+	for(int i = 0; i < N; i++)
+	{
+		v[i] = test_rand_vec3(10.0f);
+		expected[i] = qm_mat4_transform_vec3(m, v[i]);
+	}
+
+	qm_mat4_transform_vec3_array(m, v, v, N);
+	for(int i = 0; i < N; i++)
+		CHECK(test_vec3_near(v[i], expected[i], 1e-5f));
+
+	QMvec4 v4[N], expected4[N];
+	for(int i = 0; i < N; i++)
+	{
+		v4[i] = (QMvec4){{ test_rand(), test_rand(), test_rand(), test_rand() }};
+		expected4[i] = qm_mat4_mult_vec4(m, v4[i]);
+	}
+
+	qm_mat4_mult_vec4_array(m, v4, v4, N);
+	for(int i = 0; i < N; i++)
+		for(int j = 0; j < 4; j++)
+			CHECK(test_near(v4[i].v[j], expected4[i].v[j], 1e-5f));
+}
+
+int main(void)
+{
+	FOR_EACH_TIER(tier)
+	{
+		test_lengths();
+		test_in_place();
+	}
+
+	return test_report("test_transform_array");
+}
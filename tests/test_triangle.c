@@ -0,0 +1,178 @@
+#include "test.h"
+
+//Moller-Trumbore in double precision. returns t, or -1 on a miss, with the barycentrics in u and v. margin gets
+//how close the hit is to an edge, to the origin, or to tMax, where float rounding may decide it either way
+
+static double reference_hit(QMvec3 o, QMvec3 d, QMvec3 v0, QMvec3 v1, QMvec3 v2, double tMax, double* u, double* v,
+                            double* margin)
+{
+	double e1[3], e2[3], s[3], p[3], q[3];
+	for(int a = 0; a < 3; a++)
+	{
+		e1[a] = (double)v1.v[a] - v0.v[a];
+		e2[a] = (double)v2.v[a] - v0.v[a];
+		s[a] = (double)o.v[a] - v0.v[a];
+	}
+
+	p[0] = d.y * e2[2] - d.z * e2[1];
+	p[1] = d.z * e2[0] - d.x * e2[2];
+	p[2] = d.x * e2[1] - d.y * e2[0];
+	q[0] = s[1] * e1[2] - s[2] * e1[1];
+	q[1] = s[2] * e1[0] - s[0] * e1[2];
+	q[2] = s[0] * e1[1] - s[1] * e1[0];
+
+	double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	if(det == 0.0)
+	{
+		*margin = 1.0;
+		return -1.0;
+	}
+
+	*u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+	*v = (d.x * q[0] + d.y * q[1] + d.z * q[2]) / det;
+	double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+
+	*margin = fmin(fmin(fabs(*u), fabs(*v)), fmin(fabs(1.0 - *u - *v), fmin(fabs(t), fabs(t - tMax))));
+	return (*u >= 0.0 && *v >= 0.0 && *u + *v <= 1.0 && t >= 0.0 && t < tMax) ? t : -1.0;
+}
+
+//returns the nearest of the first count triangles, or -1, through the same reference
+
+static int reference_nearest(const double* ts, int count)
+{
+	int best = -1;
+	for(int i = 0; i < count; i++)
+		if(ts[i] >= 0.0 && (best < 0 || ts[i] < ts[best]))
+			best = i;
+
+	return best;
+}
+
+static int test_random(int iteration)
+{
+	QMvec3 v0[8], v1[8], v2[8];
+	for(int i = 0; i < 8; i++)
+	{
+		QMvec3 center = test_rand_vec3(3.0f);
+		v0[i] = qm_vec3_add(center, test_rand_vec3(2.0f));
+		v1[i] = qm_vec3_add(center, test_rand_vec3(2.0f));
+		v2[i] = qm_vec3_add(center, test_rand_vec3(2.0f));
+	}
+
+	//unused lanes filled with degenerate triangles
+	int used = iteration % 5 == 0 ? 5 : 8;
+	for(int i = used; i < 8; i++)
+		v0[i] = v1[i] = v2[i] = (QMvec3){{ 0.0f, 0.0f, 0.0f }};
+
+	QMvec3 o = iteration % 7 == 0 ? (QMvec3){{ 0.0f, 0.0f, 0.0f }} : test_rand_vec3(8.0f);
+	QMvec3 d = qm_vec3_sub(test_rand_vec3(2.0f), o);
+	float tMax = iteration % 3 == 0 ? 0.8f : 1e30f;
+
+	double ts[8], us[8], vs[8], minMargin = 1e30;
+	for(int i = 0; i < 8; i++)
+	{
+		double margin;
+		ts[i] = reference_hit(o, d, v0[i], v1[i], v2[i], tMax, &us[i], &vs[i], &margin);
+		minMargin = fmin(minMargin, margin);
+	}
+
+	//too close to call in float, or two hits too close to order
+	if(minMargin < 1e-3)
+		return 0;
+
+	for(int i = 0; i < 8; i++)
+		for(int j = 0; j < i; j++)
+			if(ts[i] >= 0.0 && ts[j] >= 0.0 && fabs(ts[i] - ts[j]) < 1e-3)
+				return 0;
+
+	QMray r = qm_ray_create(o, d);
+	int best8 = reference_nearest(ts, 8), best4 = reference_nearest(ts, 4);
+
+	QMrayHit hit8, hit4;
+	QMbool hit = qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), tMax, &hit8);
+	CHECK(hit == (best8 >= 0));
+	if(hit && best8 >= 0)
+	{
+		CHECK(hit8.index == best8);
+		CHECK(test_near(hit8.t, (float)ts[best8], 1e-4f));
+		CHECK(fabs(hit8.u - us[best8]) < 1e-3 && fabs(hit8.v - vs[best8]) < 1e-3);
+	}
+
+	hit = qm_ray_intersect_trianglex4(r, qm_trianglex4_load(v0, v1, v2), tMax, &hit4);
+	CHECK(hit == (best4 >= 0));
+	if(hit && best4 >= 0)
+	{
+		CHECK(hit4.index == best4);
+		CHECK(test_near(hit4.t, (float)ts[best4], 1e-4f));
+		CHECK(fabs(hit4.u - us[best4]) < 1e-3 && fabs(hit4.v - vs[best4]) < 1e-3);
+
+		//chaining the upper 4 through hit.t only replaces the hit when one of them is nearer
+		QMrayHit chained = hit4;
+		hit = qm_ray_intersect_trianglex4(r, qm_trianglex4_load(v0 + 4, v1 + 4, v2 + 4), chained.t, &chained);
+		CHECK(hit == (best8 >= 4));
+		if(hit)
+			CHECK(chained.index == best8 - 4);
+		else
+			CHECK(memcmp(&chained, &hit4, sizeof(QMrayHit)) == 0);
+	}
+
+	return best8 >= 0;
+}
+
+static void test_edge_cases(void)
+{
+	QMvec3 v0[8], v1[8], v2[8];
+	for(int i = 0; i < 8; i++)
+	{
+		v0[i] = (QMvec3){{ 0.0f, 0.0f, (float)i }};
+		v1[i] = (QMvec3){{ 1.0f, 0.0f, (float)i }};
+		v2[i] = (QMvec3){{ 0.0f, 1.0f, (float)i }};
+	}
+
+	QMrayHit hit;
+
+	//straight down the stack hits the nearest, from either side
+	QMray r = qm_ray_create((QMvec3){{ 0.25f, 0.25f, -2.0f }}, (QMvec3){{ 0.0f, 0.0f, 1.0f }});
+	CHECK(qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+	CHECK(hit.index == 0 && hit.t == 2.0f && hit.u == 0.25f && hit.v == 0.25f);
+
+	r = qm_ray_create((QMvec3){{ 0.25f, 0.25f, 10.0f }}, (QMvec3){{ 0.0f, 0.0f, -1.0f }});
+	CHECK(qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+	CHECK(hit.index == 7 && hit.t == 3.0f);
+
+	//tMax is exclusive
+	CHECK(!qm_ray_intersect_trianglex4(r, qm_trianglex4_load(v0, v1, v2), 7.0f, &hit));
+	CHECK(qm_ray_intersect_trianglex4(r, qm_trianglex4_load(v0, v1, v2), 7.5f, &hit) && hit.index == 3);
+
+	//outside the edges, behind the origin, and parallel to the plane
+	r = qm_ray_create((QMvec3){{ 0.75f, 0.75f, -2.0f }}, (QMvec3){{ 0.0f, 0.0f, 1.0f }});
+	CHECK(!qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+
+	r = qm_ray_create((QMvec3){{ 0.25f, 0.25f, -2.0f }}, (QMvec3){{ 0.0f, 0.0f, -1.0f }});
+	CHECK(!qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+
+	r = qm_ray_create((QMvec3){{ -1.0f, 0.25f, 0.0f }}, (QMvec3){{ 1.0f, 0.0f, 0.0f }});
+	CHECK(!qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+
+	//degenerate triangles never hit, even when the ray passes through them
+	for(int i = 0; i < 8; i++)
+		v0[i] = v1[i] = v2[i] = (QMvec3){{ 0.25f, 0.25f, 0.0f }};
+
+	r = qm_ray_create((QMvec3){{ 0.25f, 0.25f, -2.0f }}, (QMvec3){{ 0.0f, 0.0f, 1.0f }});
+	CHECK(!qm_ray_intersect_trianglex8(r, qm_trianglex8_load(v0, v1, v2), 1e30f, &hit));
+	CHECK(!qm_ray_intersect_trianglex4(r, qm_trianglex4_load(v0, v1, v2), 1e30f, &hit));
+}
+
+int main(void)
+{
+	int hits = 0;
+	for(int i = 0; i < 20000; i++)
+		hits += test_random(i);
+
+	//enough of the rays hit for the comparison to mean something
+	CHECK(hits > 1000);
+
+	test_edge_cases();
+
+	return test_report("test_triangle");
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+
+#include <float.h>
+
+//the polynomial sin and cos against double precision inside the reduction range, and against the C runtime outside
+//of it. vec4 runs the SSE path (or the scalar polynomial without SSE), vec8 the AVX path
+
+static void sincos8(const float* x, float* s, float* c)
+{
+	QMvec4 s4, c4;
+	QMvec8 v8, s8, c8;
+	for(int i = 0; i < 8; i++)
+		v8.v[i] = x[i];
+
+	qm_vec8_sincos(v8, &s8, &c8);
+	for(int i = 0; i < 8; i++)
+	{
+		s[i] = s8.v[i];
+		c[i] = c8.v[i];
+	}
+
+	//the vec4 results must agree with the vec8 ones lane for lane
+	for(int half = 0; half < 2; half++)
+	{
+		qm_vec4_sincos(qm_vec4_set(x[half * 4 + 0], x[half * 4 + 1], x[half * 4 + 2], x[half * 4 + 3]), &s4, &c4);
+		for(int i = 0; i < 4; i++)
+		{
+			CHECK(test_near(s4.v[i], s[half * 4 + i], 1e-7f) || (isnan(s4.v[i]) && isnan(s[half * 4 + i])));
+			CHECK(test_near(c4.v[i], c[half * 4 + i], 1e-7f) || (isnan(c4.v[i]) && isnan(c[half * 4 + i])));
+		}
+	}
+}
+
+static void test_range(void)
+{
+	double maxError = 0.0;
+	float x[8], s[8], c[8];
+
+	//dense near zero, then spread out to the limit
+	for(int i = 0; i < 200000; i++)
+	{
+		for(int j = 0; j < 8; j++)
+		{
+			float scale = (i % 3 == 0) ? 10.0f : ((i % 3 == 1) ? 500.0f : QM_TRIG_REDUCTION_LIMIT);
+			x[j] = test_rand() * scale;
+		}
+
+		sincos8(x, s, c);
+		for(int j = 0; j < 8; j++)
+		{
+			maxError = QM_MAX(maxError, fabs(s[j] - sin((double)x[j])));
+			maxError = QM_MAX(maxError, fabs(c[j] - cos((double)x[j])));
+
+			CHECK(s[j] >= -1.0f && s[j] <= 1.0f && c[j] >= -1.0f && c[j] <= 1.0f);
+		}
+	}
+
+	//the documented bound, plus the rounding of the float result
+	CHECK(maxError <= 1.5e-7);
+}
+
+static void test_outside(void)
+{
+	float big[8] = { QM_TRIG_REDUCTION_LIMIT * 1.001f, -20000.0f, 1e5f, -3.7e6f, 1e20f, -1e30f, FLT_MAX, -FLT_MAX };
+	float s[8], c[8];
+
+	//outside the range each lane is exactly the C runtime's result
+	sincos8(big, s, c);
+	for(int i = 0; i < 8; i++)
+	{
+		CHECK(s[i] == sinf(big[i]));
+		CHECK(c[i] == cosf(big[i]));
+	}
+
+	//lanes inside and outside of the range mixed in one vector
+	float mixed[8] = { 0.5f, 1e9f, -2.0f, -1e9f, QM_TRIG_REDUCTION_LIMIT, 3.0f, -QM_TRIG_REDUCTION_LIMIT * 4.0f, 100.0f };
+	sincos8(mixed, s, c);
+	for(int i = 0; i < 8; i++)
+	{
+		CHECK(test_near(s[i], (float)sin((double)mixed[i]), 1.5e-7f));
+		CHECK(test_near(c[i], (float)cos((double)mixed[i]), 1.5e-7f));
+	}
+
+	//non-finite input gives NaN in that lane only
+	float special[8] = { INFINITY, -INFINITY, NAN, -NAN, 1.0f, INFINITY, 0.0f, NAN };
+	sincos8(special, s, c);
+	for(int i = 0; i < 8; i++)
+	{
+		if(isfinite(special[i]))
+		{
+			CHECK(test_near(s[i], sinf(special[i]), 1e-7f));
+			CHECK(test_near(c[i], cosf(special[i]), 1e-7f));
+		}
+		else
+		{
+			CHECK(isnan(s[i]));
+			CHECK(isnan(c[i]));
+		}
+	}
+}
+
+int main(void)
+{
+	test_range();
+	test_outside();
+
+	return test_report("test_trig");
+}
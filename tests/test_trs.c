@@ -0,0 +1,59 @@
+#include "test.h"
+
+#define MAX_COUNT 27
+
+static QMvec3 t[MAX_COUNT], s[MAX_COUNT];
+static QMquaternion r[MAX_COUNT];
+
+//the direct composition against the product of the separate matrices
+
+static void test_single(void)
+{
+	for(int i = 0; i < MAX_COUNT; i++)
+	{
+		QMmat4 expected = qm_mat4_mult(qm_mat4_translate(t[i]), qm_mat4_mult(qm_quaternion_to_mat4(r[i]), qm_mat4_scale(s[i])));
+		CHECK(test_mat4_near(qm_mat4_from_trs(t[i], r[i], s[i]), expected, 1e-5f));
+	}
+
+	//identity parts give the identity
+	QMmat4 identity = qm_mat4_from_trs((QMvec3){{ 0.0f, 0.0f, 0.0f }}, qm_quaternion_identity(), (QMvec3){{ 1.0f, 1.0f, 1.0f }});
+	CHECK(test_mat4_near(identity, qm_mat4_identity(), 0.0f));
+}
+
+//the batch form at every length up to several times the 4-wide kernel
+
+static void test_array(void)
+{
+	for(int n = 0; n <= MAX_COUNT - 1; n++)
+	{
+		QMmat4 out[MAX_COUNT];
+		out[n].m[0][0] = 12345.0f;
+
+		qm_mat4_from_trs_array(t, r, s, out, n);
+		for(int i = 0; i < n; i++)
+			CHECK(test_mat4_near(out[i], qm_mat4_from_trs(t[i], r[i], s[i]), 1e-6f));
+
+		//nothing past the end is written
+		CHECK(out[n].m[0][0] == 12345.0f);
+	}
+}
+
+int main(void)
+{
+	for(int iteration = 0; iteration < 50; iteration++)
+	{
+		for(int i = 0; i < MAX_COUNT; i++)
+		{
+			t[i] = test_rand_vec3(10.0f);
+			s[i] = test_rand_vec3(2.0f);
+			r[i] = test_rand_quaternion();
+		}
+
+		test_single();
+
+		FOR_EACH_TIER(tier)
+			test_array();
+	}
+
+	return test_report("test_trs");
+}
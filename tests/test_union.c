@@ -0,0 +1,112 @@
+#include "test.h"
+
+#define COUNT 300
+#define PARALLEL_COUNT 4500007
+
+static QMvec3 points[COUNT];
+static QMbbox3 boxes[COUNT];
+
+//min and max are exact, so every union must match folding the single element functions bit for bit. each length
+//and start offset is tried so every tail size and alignment is hit
+
+static void test_serial(void)
+{
+	QMbbox3 seeds[2] = { qm_bbox3_initialized(), {{{ -1.0f, -2.0f, -3.0f }}, {{ 1.0f, 2.0f, 3.0f }}} };
+
+	for(int s = 0; s < 2; s++)
+		for(int offset = 0; offset < 5; offset++)
+			for(int n = 0; n + offset <= COUNT; n += n < 70 ? 1 : 23)
+			{
+				QMbbox3 expectedPoints = seeds[s], expectedBoxes = seeds[s];
+				for(int i = 0; i < n; i++)
+				{
+					expectedPoints = qm_bbox3_union_vec3(expectedPoints, points[offset + i]);
+					expectedBoxes = qm_bbox3_union(expectedBoxes, boxes[offset + i]);
+				}
+
+				CHECK(test_bbox3_equal(qm_bbox3_union_vec3_array(seeds[s], points + offset, n), expectedPoints));
+				CHECK(test_bbox3_equal(qm_bbox3_union_array(seeds[s], boxes + offset, n), expectedBoxes));
+
+				//the packed boxes, alternating between the returning and in place functions
+				QMbbox3p packedPoints = qm_bbox3p_from_bbox3(seeds[s]), packedBoxes = qm_bbox3p_from_bbox3(seeds[s]);
+				for(int i = 0; i < n; i++)
+				{
+					QMbbox3p box = qm_bbox3p_from_bbox3(boxes[offset + i]);
+					if(i & 1)
+					{
+						packedPoints = qm_bbox3p_union_vec3(packedPoints, points[offset + i]);
+						packedBoxes = qm_bbox3p_union(packedBoxes, box);
+					}
+					else
+					{
+						qm_bbox3p_union_vec3_inplace(&packedPoints, points[offset + i]);
+						qm_bbox3p_union_inplace(&packedBoxes, box);
+					}
+				}
+
+				CHECK(test_bbox3_equal(qm_bbox3p_to_bbox3(packedPoints), expectedPoints));
+				CHECK(test_bbox3_equal(qm_bbox3p_to_bbox3(packedBoxes), expectedBoxes));
+				CHECK(packedPoints.min.w == 0.0f && packedPoints.max.w == 0.0f);
+				CHECK(packedBoxes.min.w == 0.0f && packedBoxes.max.w == 0.0f);
+			}
+
+	CHECK(test_bbox3_equal(qm_bbox3p_to_bbox3(qm_bbox3p_initialized()), qm_bbox3_initialized()));
+}
+
+//the parallel unions against the scalar ones, below, at and above the chunk sizes, for any thread count and task
+//order, with the extremes placed in the first and last chunks
+
+static void test_parallel(void)
+{
+	QMvec3* manyPoints = (QMvec3*)malloc(PARALLEL_COUNT * sizeof(QMvec3));
+	QMbbox3* manyBoxes = (QMbbox3*)malloc(PARALLEL_COUNT * sizeof(QMbbox3));
+	for(size_t i = 0; i < PARALLEL_COUNT; i++)
+	{
+		manyPoints[i] = test_rand_vec3(1000.0f);
+		manyBoxes[i].min = manyPoints[i];
+		manyBoxes[i].max = qm_vec3_add(manyPoints[i], (QMvec3){{ 1.0f, 1.0f, 1.0f }});
+	}
+
+	manyPoints[PARALLEL_COUNT - 18].x = 5000.0f;
+	manyBoxes[123].min.z = -9000.0f;
+
+	size_t sizes[] = { 0, 1, 1000, QM_UNION_PARALLEL_MIN_CHUNK, QM_UNION_PARALLEL_MIN_CHUNK + 1, 200001, PARALLEL_COUNT };
+	int threadCounts[] = { 1, 4 };
+	for(int k = 0; k < (int)(sizeof(sizes) / sizeof(sizes[0])); k++)
+	{
+		size_t n = sizes[k];
+		QMbbox3 expectedPoints = qm_bbox3_union_vec3_array_scalar(qm_bbox3_initialized(), manyPoints, n);
+		QMbbox3 expectedBoxes = qm_bbox3_union_array_scalar(qm_bbox3_initialized(), manyBoxes, n);
+
+		for(int t = 0; t < 2; t++)
+		{
+			CHECK(test_bbox3_equal(qm_bbox3_union_vec3_array_parallel(qm_bbox3_initialized(), manyPoints, n, test_parallel_for, &threadCounts[t]), expectedPoints));
+			CHECK(test_bbox3_equal(qm_bbox3_union_array_parallel(qm_bbox3_initialized(), manyBoxes, n, test_parallel_for, &threadCounts[t]), expectedBoxes));
+		}
+
+		CHECK(test_bbox3_equal(qm_bbox3_union_vec3_array_parallel(qm_bbox3_initialized(), manyPoints, n, test_reverse_for, NULL), expectedPoints));
+		CHECK(test_bbox3_equal(qm_bbox3_union_array_parallel(qm_bbox3_initialized(), manyBoxes, n, test_reverse_for, NULL), expectedBoxes));
+	}
+
+	CHECK(qm_bbox3_union_vec3_array_parallel(qm_bbox3_initialized(), manyPoints, PARALLEL_COUNT, test_reverse_for, NULL).max.x == 5000.0f);
+	CHECK(qm_bbox3_union_array_parallel(qm_bbox3_initialized(), manyBoxes, PARALLEL_COUNT, test_reverse_for, NULL).min.z == -9000.0f);
+
+	free(manyPoints);
+	free(manyBoxes);
+}
+
+int main(void)
+{
+	for(int i = 0; i < COUNT; i++)
+	{
+		points[i] = test_rand_vec3(100.0f);
+		boxes[i] = test_rand_bbox3(100.0f, 50.0f);
+	}
+
+	FOR_EACH_TIER(tier)
+		test_serial();
+
+	test_parallel();
+
+	return test_report("test_union");
+}
@@ -0,0 +1,100 @@
+#include "test.h"
+
+static QMvec3 a[8], b[8];
+
+//compares each lane of a wide binary operation against the QMvec3 version
+
+#define CHECK_BINARY(op)                                                          \
+	do                                                                            \
+	{                                                                             \
+		QMvec3 out[8];                                                            \
+		qm_vec3x4_store(qm_vec3x4_##op(qm_vec3x4_load(a), qm_vec3x4_load(b)), out); \
+		for(int i = 0; i < 4; i++)                                                \
+			CHECK(test_vec3_near(out[i], qm_vec3_##op(a[i], b[i]), 1e-6f));      \
+		qm_vec3x8_store(qm_vec3x8_##op(qm_vec3x8_load(a), qm_vec3x8_load(b)), out); \
+		for(int i = 0; i < 8; i++)                                                \
+			CHECK(test_vec3_near(out[i], qm_vec3_##op(a[i], b[i]), 1e-6f));      \
+	} while(0)
+
+static void test_arithmetic(void)
+{
+	CHECK_BINARY(add);
+	CHECK_BINARY(sub);
+	CHECK_BINARY(mult);
+	CHECK_BINARY(div);
+	CHECK_BINARY(cross);
+	CHECK_BINARY(min);
+	CHECK_BINARY(max);
+
+	QMvec3 out[8];
+
+	qm_vec3x4_store(qm_vec3x4_scale(qm_vec3x4_load(a), 2.5f), out);
+	for(int i = 0; i < 4; i++)
+		CHECK(test_vec3_near(out[i], qm_vec3_scale(a[i], 2.5f), 1e-6f));
+
+	qm_vec3x8_store(qm_vec3x8_scale(qm_vec3x8_load(a), 2.5f), out);
+	for(int i = 0; i < 8; i++)
+		CHECK(test_vec3_near(out[i], qm_vec3_scale(a[i], 2.5f), 1e-6f));
+
+	qm_vec3x4_store(qm_vec3x4_full(a[1]), out);
+	for(int i = 0; i < 4; i++)
+		CHECK(memcmp(&out[i], &a[1], sizeof(QMvec3)) == 0);
+
+	qm_vec3x8_store(qm_vec3x8_full(a[1]), out);
+	for(int i = 0; i < 8; i++)
+		CHECK(memcmp(&out[i], &a[1], sizeof(QMvec3)) == 0);
+
+	//load and store round trip exactly
+	qm_vec3x8_store(qm_vec3x8_load(a), out);
+	CHECK(memcmp(out, a, sizeof(a)) == 0);
+}
+
+static void test_lanes(void)
+{
+	QMvec3x4 a4 = qm_vec3x4_load(a), b4 = qm_vec3x4_load(b);
+	QMvec3x8 a8 = qm_vec3x8_load(a), b8 = qm_vec3x8_load(b);
+
+	QMvec4 dot4 = qm_vec3x4_dot(a4, b4), length4 = qm_vec3x4_length(a4), distance4 = qm_vec3x4_distance(a4, b4);
+	QMvec8 dot8 = qm_vec3x8_dot(a8, b8), length8 = qm_vec3x8_length(a8), distance8 = qm_vec3x8_distance(a8, b8);
+
+	for(int i = 0; i < 8; i++)
+	{
+		if(i < 4)
+		{
+			CHECK(test_near(dot4.v[i], qm_vec3_dot(a[i], b[i]), 1e-6f));
+			CHECK(test_near(length4.v[i], qm_vec3_length(a[i]), 1e-6f));
+			CHECK(test_near(distance4.v[i], qm_vec3_distance(a[i], b[i]), 1e-6f));
+		}
+
+		CHECK(test_near(dot8.v[i], qm_vec3_dot(a[i], b[i]), 1e-6f));
+		CHECK(test_near(length8.v[i], qm_vec3_length(a[i]), 1e-6f));
+		CHECK(test_near(distance8.v[i], qm_vec3_distance(a[i], b[i]), 1e-6f));
+	}
+
+	QMvec3 out[8];
+
+	qm_vec3x4_store(qm_vec3x4_normalize(a4), out);
+	for(int i = 0; i < 4; i++)
+		CHECK(test_vec3_near(out[i], qm_vec3_normalize(a[i]), 1e-6f));
+
+	qm_vec3x8_store(qm_vec3x8_normalize(a8), out);
+	for(int i = 0; i < 8; i++)
+		CHECK(test_vec3_near(out[i], qm_vec3_normalize(a[i]), 1e-6f));
+}
+
+int main(void)
+{
+	for(int iteration = 0; iteration < 1000; iteration++)
+	{
+		for(int i = 0; i < 8; i++)
+		{
+			a[i] = test_rand_vec3(5.0f);
+			b[i] = test_rand_vec3(5.0f);
+		}
+
+		test_arithmetic();
+		test_lanes();
+	}
+
+	return test_report("test_wide");
+}